@@ -0,0 +1,212 @@
+/*
+ * Copyright 2012 Achille Roussel.
+ *
+ * This file is part of Libjson++.
+ *
+ * Libjson++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Libjson++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+#include <json/key_table.h>
+#include <json/object.h>
+#include <json/parser.h>
+#include <json/parsing.h>
+#include <json/path_filter.h>
+#include <json/string_pool.h>
+
+// Times the readers on generated documents, each case reports the fastest of
+// five runs. Built with: cmake -DCOMPILE_BENCHMARKS=1 . && make bin/benchmark
+
+static volatile std::size_t sink = 0;
+
+template < typename Function >
+static double measure(const unsigned n, Function f)
+{
+  double best = 0.0;
+
+  for (int run = 0; run != 5; ++run)
+    {
+      const auto start = std::chrono::steady_clock::now();
+      for (unsigned i = 0; i != n; ++i)
+	{
+	  f();
+	}
+      const auto stop = std::chrono::steady_clock::now();
+      const double t = std::chrono::duration<double>(stop - start).count() / n;
+      if ((run == 0) || (t < best))
+	{
+	  best = t;
+	}
+    }
+  return best;
+}
+
+static void report(const char *name, const double seconds)
+{
+  if (seconds >= 1e-3)
+    {
+      std::printf("  %-40s %10.1f ms\n", name, seconds * 1e3);
+    }
+  else if (seconds >= 1e-6)
+    {
+      std::printf("  %-40s %10.2f us\n", name, seconds * 1e6);
+    }
+  else
+    {
+      std::printf("  %-40s %10.1f ns\n", name, seconds * 1e9);
+    }
+}
+
+static std::string hosts(const int n, const int distinct)
+{
+  std::string str ("[");
+
+  for (int i = 0; i != n; ++i)
+    {
+      str += (i == 0) ? "\"" : ", \"";
+      str += "host-" + std::to_string(i % distinct) + ".example.com\"";
+    }
+  return str + "]";
+}
+
+static std::string records(const int n)
+{
+  std::string str ("[");
+
+  for (int i = 0; i != n; ++i)
+    {
+      const std::string k (std::to_string(i));
+      str += (i == 0) ? "{" : ", {";
+      for (int f = 0; f != 20; ++f)
+	{
+	  str += (f == 0) ? "" : ", ";
+	  str += "\"field_" + std::to_string(f) + "\": " + k;
+	}
+      str += "}";
+    }
+  return str + "]";
+}
+
+static std::string event()
+{
+  std::string str ("{\"id\": 42, \"type\": \"click\", \"user\": {\"id\": 7, \"name\": \"someone\"}, \"items\": [");
+
+  for (int i = 0; str.size() < 50000; ++i)
+    {
+      const std::string k (std::to_string(i));
+      str += (i == 0) ? "{" : ", {";
+      str += "\"sku\": \"item-" + k + "\", \"price\": " + k + ".5, \"tags\": [\"a\", \"b\\n\", " + k + "], ";
+      str += "\"meta\": {\"seen\": true, \"note\": null}}";
+    }
+  return str + "], \"ts\": 1500000000000}";
+}
+
+static std::string message()
+{
+  return "{\"id\": 12, \"name\": \"user 12\", \"tags\": [\"a\", \"b\", 12], "
+    "\"geo\": {\"lat\": 1.5, \"lng\": -12}, \"ok\": true}";
+}
+
+static void benchmark_string_pool()
+{
+  const std::string str (hosts(1000000, 50));
+
+  std::printf("1M host names, 50 distinct values:\n");
+  report("json::read", measure(1, [&]() { sink += json::read(str).size(); }));
+  report("json::read with a string_pool", measure(1, [&]() {
+	json::string_pool pool;
+	json::string_pool::scope use (pool);
+	sink += json::read(str).size();
+      }));
+}
+
+static void benchmark_key_table()
+{
+  const std::string str (records(100000));
+
+  std::printf("100k records of 20 fields:\n");
+  report("json::read", measure(1, [&]() { sink += json::read(str).size(); }));
+  report("json::read with a key_table", measure(1, [&]() {
+	json::key_table keys;
+	sink += json::read(str, keys).size();
+      }));
+}
+
+static void benchmark_path_filter()
+{
+  const std::string str (event());
+  const json::path_filter filter { "/id", "/type", "/user/name", "/ts" };
+
+  std::printf("%u KB event, four selected fields:\n", unsigned(str.size() / 1000));
+  report("json::read", measure(100, [&]() { sink += json::read(str).size(); }));
+  report("json::read with a path_filter", measure(100, [&]() { sink += json::read(str, filter).size(); }));
+}
+
+static void benchmark_stod()
+{
+  std::mt19937 random (42);
+  std::uniform_real_distribution<double> degrees (-180.0, 180.0);
+  std::vector<json::object> coordinates;
+  char buffer[32];
+
+  for (int i = 0; i != 100000; ++i)
+    {
+      std::snprintf(buffer, sizeof(buffer), "%.7f", degrees(random));
+      coordinates.push_back(json::object(std::string(buffer)));
+    }
+
+  const unsigned n = coordinates.size();
+  std::printf("Coordinate held by a string object:\n");
+  report("json::stod", measure(1, [&]() {
+	for (const auto &c : coordinates)
+	  {
+	    sink += json::stod(c) > 0.0;
+	  }
+      }) / n);
+  report("std::strtod on get_string", measure(1, [&]() {
+	for (const auto &c : coordinates)
+	  {
+	    sink += std::strtod(c.get_string().c_str(), nullptr) > 0.0;
+	  }
+      }) / n);
+}
+
+static void benchmark_parser()
+{
+  const std::string str (message());
+  json::parser parser;
+  json::object obj;
+
+  std::printf("%u-byte message:\n", unsigned(str.size()));
+  report("json::read", measure(100000, [&]() { sink += json::read(str).size(); }));
+  report("json::parser reused", measure(100000, [&]() {
+	parser.parse(str, obj);
+	sink += obj.size();
+      }));
+}
+
+int main()
+{
+  benchmark_string_pool();
+  benchmark_key_table();
+  benchmark_path_filter();
+  benchmark_stod();
+  benchmark_parser();
+  return 0;
+}
@@ -0,0 +1,200 @@
+/*
+ * Copyright 2012 Achille Roussel.
+ *
+ * This file is part of Libjson++.
+ *
+ * Libjson++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Libjson++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdlib>
+#include "json/arena.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#  define JSON_HAS_MMAP 1
+#  include <sys/mman.h>
+#else
+#  define JSON_HAS_MMAP 0
+#endif
+
+namespace json
+{
+
+  namespace
+  {
+
+    enum
+      {
+	huge_page_size = 2 * 1024 * 1024,
+	max_chunk_size = 64 * 1024 * 1024
+      };
+
+    // Chunks of at least a huge page are mapped directly so that they can be
+    // backed by huge pages, explicitly reserved ones first and transparent
+    // huge pages otherwise, smaller chunks come from the heap.
+    void *map_chunk(const std::size_t size, bool &mapped)
+    {
+      mapped = false;
+#if JSON_HAS_MMAP
+      if ((size % huge_page_size) == 0)
+	{
+	  void *p = MAP_FAILED;
+#  ifdef MAP_HUGETLB
+	  p = ::mmap(0, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#  endif
+	  if (p == MAP_FAILED)
+	    {
+	      p = ::mmap(0, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+#  ifdef MADV_HUGEPAGE
+	      if (p != MAP_FAILED)
+		{
+		  ::madvise(p, size, MADV_HUGEPAGE);
+		}
+#  endif
+	    }
+	  if (p == MAP_FAILED)
+	    {
+	      throw std::bad_alloc();
+	    }
+	  mapped = true;
+	  return p;
+	}
+#endif
+      void *p = std::malloc(size);
+      if (p == nullptr)
+	{
+	  throw std::bad_alloc();
+	}
+      return p;
+    }
+
+    void unmap_chunk(void *p, const std::size_t size, const bool mapped)
+    {
+#if JSON_HAS_MMAP
+      if (mapped)
+	{
+	  ::munmap(p, size);
+	  return;
+	}
+#else
+      (void) size;
+      (void) mapped;
+#endif
+      std::free(p);
+    }
+
+    std::uintptr_t round_up(const std::uintptr_t size, const std::uintptr_t alignment)
+    {
+      return (size + alignment - 1) & ~(alignment - 1);
+    }
+
+  }
+
+  struct arena::chunk
+  {
+    chunk *	next;
+    size_type	size;
+    bool	mapped;
+  };
+
+  arena::arena(const size_type chunk_size):
+    _chunks(nullptr),
+    _cursor(nullptr),
+    _end(nullptr),
+    _chunk_size(chunk_size),
+    _next_size(chunk_size),
+    _capacity(0)
+  {
+  }
+
+  arena::~arena()
+  {
+    release();
+  }
+
+  void arena::release()
+  {
+    while (_chunks != nullptr)
+      {
+	chunk *c = _chunks;
+	_chunks = c->next;
+	unmap_chunk(c, c->size, c->mapped);
+      }
+    _cursor = nullptr;
+    _end = nullptr;
+    _next_size = _chunk_size;
+    _capacity = 0;
+  }
+
+  void arena::reset()
+  {
+    if (_chunks == nullptr)
+      {
+	return;
+      }
+    if (_chunks->next == nullptr)
+      {
+	_cursor = reinterpret_cast<char *>(_chunks + 1);
+	return;
+      }
+    const size_type capacity = _capacity;
+    release();
+    _next_size = capacity;
+    allocate_chunk(0, 1);
+  }
+
+  arena::size_type arena::capacity() const
+  {
+    return _capacity;
+  }
+
+  // Requests which don't fit in the next chunk get a chunk of their own, the
+  // current chunk is kept so its free space isn't lost.
+  void *arena::allocate_chunk(const size_type size, const size_type alignment)
+  {
+    const size_type needed = sizeof(chunk) + (alignment - 1) + size;
+    const bool dedicated = needed > _next_size;
+
+    size_type n = dedicated ? needed : _next_size;
+    if (n >= huge_page_size)
+      {
+	n = round_up(n, huge_page_size);
+      }
+
+    bool mapped = false;
+    chunk *c = static_cast<chunk *>(map_chunk(n, mapped));
+    c->size = n;
+    c->mapped = mapped;
+    _capacity += n;
+
+    const std::uintptr_t first = reinterpret_cast<std::uintptr_t>(c + 1);
+    char *data = reinterpret_cast<char *>(round_up(first, alignment));
+    if (dedicated && (_chunks != nullptr))
+      {
+	c->next = _chunks->next;
+	_chunks->next = c;
+	return data;
+      }
+
+    c->next = _chunks;
+    _chunks = c;
+    _cursor = data + size;
+    _end = reinterpret_cast<char *>(c) + n;
+    if (_next_size < max_chunk_size)
+      {
+	_next_size *= 2;
+      }
+    return data;
+  }
+
+}
@@ -0,0 +1,243 @@
+/*
+ * Copyright 2012 Achille Roussel.
+ *
+ * This file is part of Libjson++.
+ *
+ * Libjson++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Libjson++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JSON_ARENA_H
+#define JSON_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+#include "json/def.h"
+
+namespace json
+{
+
+  /**
+   * @brief A monotonic memory arena.
+   *
+   * Memory is carved out of large chunks by bumping a pointer, nothing is
+   * released until <em>release</em> is called or the arena is destroyed,
+   * which frees all the chunks at once. Chunks grow geometrically from the
+   * size given to the constructor, the ones larger than a huge page are
+   * mapped with huge pages when the system provides them.
+   * <br/>
+   * An arena is not thread-safe, see <em>json::arena_allocator</em> to use
+   * it as the allocator of containers and <em>json::monotonic_document</em>
+   * for documents allocated in an arena.
+   */
+  class arena
+  {
+
+  public:
+
+    typedef std::size_t	size_type;
+
+    enum
+      {
+	default_chunk_size = 64 * 1024
+      };
+
+    explicit arena(size_type chunk_size = default_chunk_size);
+
+    ~arena();
+
+    /**
+     * @brief Returns 'size' bytes aligned on 'alignment', which must be a
+     * power of two.
+     */
+    void *allocate(size_type size, size_type alignment)
+    {
+      const std::uintptr_t cursor = reinterpret_cast<std::uintptr_t>(_cursor);
+      const std::uintptr_t end = reinterpret_cast<std::uintptr_t>(_end);
+      const std::uintptr_t p = (cursor + alignment - 1) & ~std::uintptr_t(alignment - 1);
+      if ((_cursor != nullptr) && (p <= end) && (size <= (end - p)))
+	{
+	  _cursor = reinterpret_cast<char *>(p + size);
+	  return reinterpret_cast<void *>(p);
+	}
+      return allocate_chunk(size, alignment);
+    }
+
+    /**
+     * @brief Releases all the memory allocated by the arena.
+     */
+    void release();
+
+    /**
+     * @brief Makes all the memory of the arena available again without
+     * returning it to the system, the chunks are merged into one so that
+     * filling the arena again with as much data needs no new chunk.
+     */
+    void reset();
+
+    /**
+     * @brief Returns the number of bytes currently reserved by the arena.
+     */
+    size_type capacity() const;
+
+  private:
+    struct chunk;
+
+    arena(const arena &) = delete;
+
+    arena &operator=(const arena &) = delete;
+
+    void *allocate_chunk(size_type size, size_type alignment);
+
+    chunk *	_chunks;
+    char *	_cursor;
+    char *	_end;
+    size_type	_chunk_size;
+    size_type	_next_size;
+    size_type	_capacity;
+
+  };
+
+  /**
+   * @brief An allocator drawing memory from a <em>json::arena</em>.
+   *
+   * Deallocating is a no-op, the memory is reclaimed when the arena is
+   * released. A default-constructed allocator isn't bound to any arena and
+   * falls back to the global heap, like <em>std::allocator</em>.
+   * <br/>
+   * Two allocators compare equal if they use the same arena, which makes
+   * <em>json::basic_object</em> copy the values assigned to it from another
+   * arena instead of stealing their memory.
+   */
+  template < typename T >
+  class arena_allocator
+  {
+
+  public:
+
+    typedef T			value_type;
+    typedef T *			pointer;
+    typedef const T *		const_pointer;
+    typedef T &			reference;
+    typedef const T &		const_reference;
+    typedef std::size_t		size_type;
+    typedef std::ptrdiff_t	difference_type;
+
+    template < typename U >
+    struct rebind
+    {
+      typedef arena_allocator<U> other;
+    };
+
+    arena_allocator():
+      _arena(nullptr)
+    {
+    }
+
+    arena_allocator(arena &a):
+      _arena(&a)
+    {
+    }
+
+    template < typename U >
+    arena_allocator(const arena_allocator<U> &a):
+      _arena(a.get_arena())
+    {
+    }
+
+    pointer allocate(size_type n, const void * = nullptr)
+    {
+      if (_arena == nullptr)
+	{
+	  return static_cast<pointer>(::operator new(n * sizeof(T)));
+	}
+      return static_cast<pointer>(_arena->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(pointer p, size_type)
+    {
+      if (_arena == nullptr)
+	{
+	  ::operator delete(p);
+	}
+    }
+
+    size_type max_size() const
+    {
+      return size_type(-1) / sizeof(T);
+    }
+
+    template < typename U, typename... Args >
+    void construct(U *p, Args&&... args)
+    {
+      new (static_cast<void *>(p)) U ( std::forward<Args>(args)... );
+    }
+
+    template < typename U >
+    void destroy(U *p)
+    {
+      p->~U();
+    }
+
+    pointer address(reference x) const
+    {
+      return &x;
+    }
+
+    const_pointer address(const_reference x) const
+    {
+      return &x;
+    }
+
+    arena *get_arena() const
+    {
+      return _arena;
+    }
+
+  private:
+    arena *	_arena;
+
+  };
+
+  template < typename T, typename U >
+  inline bool operator==(const arena_allocator<T> &a1, const arena_allocator<U> &a2)
+  {
+    return a1.get_arena() == a2.get_arena();
+  }
+
+  template < typename T, typename U >
+  inline bool operator!=(const arena_allocator<T> &a1, const arena_allocator<U> &a2)
+  {
+    return a1.get_arena() != a2.get_arena();
+  }
+
+  // Objects allocated in an arena are released with it instead of being
+  // destroyed (see json::monotonic_document), they would never drop their
+  // references on pooled strings or shared lists and maps.
+  template < typename Allocator >
+  inline bool destroys_objects(const Allocator &)
+  {
+    return true;
+  }
+
+  template < typename T >
+  inline bool destroys_objects(const arena_allocator<T> &)
+  {
+    return false;
+  }
+
+}
+
+#endif // JSON_ARENA_H
@@ -0,0 +1,62 @@
+/*
+ * Copyright 2012 Achille Roussel.
+ *
+ * This file is part of Libjson++.
+ *
+ * Libjson++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Libjson++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "json/buffer_reader.hpp"
+#include "json/object.hpp"
+
+namespace json
+{
+
+  namespace
+  {
+
+    enum
+      {
+	_ = 0,
+	S = char_class_space,
+	D = char_class_digit
+      };
+
+  }
+
+  const unsigned char char_class_table[256] =
+    {
+      _, _, _, _, _, _, _, _, _, S, S, _, _, S, _, _,  // 0x00
+      _, _, _, _, _, _, _, _, _, _, _, _, _, _, _, _,  // 0x10
+      S, _, _, _, _, _, _, _, _, _, _, _, _, _, _, _,  // 0x20
+      D, D, D, D, D, D, D, D, D, D, _, _, _, _, _, _,  // 0x30
+      _, _, _, _, _, _, _, _, _, _, _, _, _, _, _, _,  // 0x40
+      _, _, _, _, _, _, _, _, _, _, _, _, _, _, _, _,  // 0x50
+      _, _, _, _, _, _, _, _, _, _, _, _, _, _, _, _,  // 0x60
+      _, _, _, _, _, _, _, _, _, _, _, _, _, _, _, _,  // 0x70
+      _, _, _, _, _, _, _, _, _, _, _, _, _, _, _, _,  // 0x80
+      _, _, _, _, _, _, _, _, _, _, _, _, _, _, _, _,  // 0x90
+      _, _, _, _, _, _, _, _, _, _, _, _, _, _, _, _,  // 0xa0
+      _, _, _, _, _, _, _, _, _, _, _, _, _, _, _, _,  // 0xb0
+      _, _, _, _, _, _, _, _, _, _, _, _, _, _, _, _,  // 0xc0
+      _, _, _, _, _, _, _, _, _, _, _, _, _, _, _, _,  // 0xd0
+      _, _, _, _, _, _, _, _, _, _, _, _, _, _, _, _,  // 0xe0
+      _, _, _, _, _, _, _, _, _, _, _, _, _, _, _, _,  // 0xf0
+    };
+
+  template const char *read_buffer(const char *, const char *, object &);
+  template const char *read_buffer(const char *, const char *, object &, key_table &);
+  template const char *read_buffer(const char *, const char *, object &, deduplicator &);
+
+}
@@ -0,0 +1,83 @@
+/*
+ * Copyright 2012 Achille Roussel.
+ *
+ * This file is part of Libjson++.
+ *
+ * Libjson++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Libjson++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JSON_BUFFER_READER_H
+#define JSON_BUFFER_READER_H
+
+#include "json/def.h"
+
+namespace json
+{
+
+  /**
+   * @brief Reads JSON from a contiguous buffer of characters.
+   *
+   * This is the fast path used by <em>json::read</em> when the whole input is
+   * held in memory. Instead of going through the generic iterator-based
+   * reader it works on raw pointers, classifies characters with a lookup
+   * table and relies on a '\\0' sentinel at the end of the buffer so its inner
+   * loops never have to check for bounds.
+   *
+   * @param first A pointer to the first character of the buffer.
+   * @param last A pointer to the end of the buffer, <em>*last</em> must be
+   * readable and equal to '\\0' (which is the case for c-strings and for the
+   * <em>c_str()</em> of STL strings).
+   * @param obj The destination object to build from the parsed data.
+   *
+   * @return The function returns a pointer to the first character following
+   * the parsed JSON object.
+   *
+   * @note Like <em>json::read_object</em>, the function stops reading once it
+   * has loaded a valid JSON object, which may be before reaching 'last'.
+   */
+  template < typename Traits, typename Allocator >
+  const char *read_buffer(const char *first,
+			  const char *last,
+			  basic_object<char, Traits, Allocator> &obj);
+
+  /**
+   * @brief Reads JSON from a contiguous buffer of characters, the keys of the
+   * maps are interned in 'keys' (see <em>json::basic_key_table</em>).
+   */
+  template < typename Traits, typename Allocator >
+  const char *read_buffer(const char *first,
+			  const char *last,
+			  basic_object<char, Traits, Allocator> &obj,
+			  basic_key_table<char, Traits> &keys);
+
+  /**
+   * @brief Reads JSON from a contiguous buffer of characters, identical lists
+   * and maps are shared through 'trees' as they are read (see
+   * <em>json::basic_deduplicator</em>).
+   */
+  template < typename Traits, typename Allocator >
+  const char *read_buffer(const char *first,
+			  const char *last,
+			  basic_object<char, Traits, Allocator> &obj,
+			  basic_deduplicator<char, Traits, Allocator> &trees);
+
+  extern template const char *read_buffer(const char *, const char *, object &);
+
+  extern template const char *read_buffer(const char *, const char *, object &, key_table &);
+
+  extern template const char *read_buffer(const char *, const char *, object &, deduplicator &);
+
+}
+
+#endif // JSON_BUFFER_READER_H
@@ -0,0 +1,592 @@
+/*
+ * Copyright 2012 Achille Roussel.
+ *
+ * This file is part of Libjson++.
+ *
+ * Libjson++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Libjson++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JSON_BUFFER_READER_HPP
+#define JSON_BUFFER_READER_HPP
+
+#include <vector>
+#include "json/types.h"
+#include "json/buffer_reader.h"
+#include "json/deduplicator.hpp"
+#include "json/char_sequence.hpp"
+#include "json/key_table.hpp"
+#include "json/string_pool.hpp"
+#include "json/reader.hpp"
+
+namespace json
+{
+
+  enum
+    {
+      char_class_space  = 1,
+      char_class_digit  = 2
+    };
+
+  extern const unsigned char char_class_table[256];
+
+  inline unsigned char char_class(const char c)
+  {
+    return char_class_table[static_cast<unsigned char>(c)];
+  }
+
+  inline bool is_buffer_space(const char c)
+  {
+    return char_class(c) & char_class_space;
+  }
+
+  inline bool is_buffer_digit(const char c)
+  {
+    return char_class(c) & char_class_digit;
+  }
+
+  inline bool is_buffer_number(const char c)
+  {
+    return is_buffer_digit(c) || one_of(c, '-', '+');
+  }
+
+  inline const char *buffer_skip_spaces(const char *first)
+  {
+    while (is_buffer_space(*first))
+      {
+	++first;
+      }
+    return first;
+  }
+
+  inline const char *buffer_skip_digits(const char *first)
+  {
+    while (is_buffer_digit(*first))
+      {
+	++first;
+      }
+    return first;
+  }
+
+  inline const char *buffer_next_char(const char *first, const char *last)
+  {
+    first = buffer_skip_spaces(first);
+    if (first == last)
+      {
+	error_invalid_input_eof();
+      }
+    return first;
+  }
+
+  template < int N >
+  void buffer_read_equals(const char *&first, const char *last, const char (&str)[N])
+  {
+    for (int i = 0; i != (N - 1); ++i, ++first)
+      {
+	if ((*first) != str[i])
+	  {
+	    if (first == last)
+	      {
+		error_invalid_input_eof();
+	      }
+	    error_invalid_input_non_json();
+	  }
+      }
+  }
+
+  template < typename Traits, typename Allocator >
+  void buffer_read_escape(const char *&first,
+			  const char *last,
+			  std::basic_string<char, Traits, Allocator> &str)
+  {
+    ++first; // consumes '\\'
+    switch (const char c = escape_char(*first))
+      {
+      case 'u': read_unicode_helper<const char *, char, Traits, Allocator>::read_unicode(first, last, str); break;
+      case 0:
+	if (first == last)
+	  {
+	    error_invalid_input_eof();
+	  }
+	error_invalid_input_non_json();
+      default:  str.push_back(c);
+      }
+    ++first;
+  }
+
+  // Reads the rest of a string whose opening quote has already been consumed,
+  // plain runs of characters are appended in bulk.
+  template < typename Traits, typename Allocator >
+  void buffer_read_string(const char *&first,
+			  const char *last,
+			  std::basic_string<char, Traits, Allocator> &str)
+  {
+    for (;;)
+      {
+	const char *run = first;
+	first = scan_string(first, last);
+	str.append(run, first - run);
+	switch (*first)
+	  {
+	  case '"':
+	    ++first;
+	    return;
+	  case '\\':
+	    buffer_read_escape(first, last, str);
+	    break;
+	  default:
+	    error_invalid_input_eof();
+	  }
+      }
+  }
+
+  // Keys without escape sequences are returned as a view on the input buffer,
+  // the 'buffer' string is only used to unescape the others.
+  template < typename Traits, typename Allocator >
+  basic_char_sequence<char, Traits>
+  buffer_read_key(const char *&first,
+		  const char *last,
+		  std::basic_string<char, Traits, Allocator> &buffer)
+  {
+    typedef basic_char_sequence<char, Traits> char_sequence;
+
+    const char *key = ++first; // consumes '"'
+    first = scan_string(first, last);
+    if ((*first) == '"')
+      {
+	return char_sequence(key, (first++) - key);
+      }
+    buffer.assign(key, first - key);
+    buffer_read_string(first, last, buffer);
+    return char_sequence(buffer);
+  }
+
+  // Strings are read in place in the object, unless a string pool is in use:
+  // they are then looked up in the pool from a view on the input, the buffer
+  // is only used to unescape them.
+  template < typename Traits, typename Allocator >
+  void buffer_read_string_value(const char *&first,
+				const char *last,
+				basic_object<char, Traits, Allocator> &obj)
+  {
+    if (basic_string_pool<char, Traits>::current() == nullptr)
+      {
+	obj.make_string();
+	obj.get_string().clear();
+	buffer_read_string(++first, last, obj.get_string());
+      }
+    else
+      {
+	std::basic_string<char, Traits, Allocator> buffer (obj.get_allocator());
+	obj = buffer_read_key(first, last, buffer);
+      }
+  }
+
+  inline const char *buffer_read_number(const char *first)
+  {
+    if (one_of(*first, '-', '+'))
+      {
+	++first;
+      }
+    if (!is_buffer_digit(*first))
+      {
+	error_invalid_input_non_json();
+      }
+    first = buffer_skip_digits(first);
+
+    if ((*first) == '.')
+      {
+	if (!is_buffer_digit(*(++first)))
+	  {
+	    error_invalid_input_non_json();
+	  }
+	first = buffer_skip_digits(first);
+      }
+
+    if (one_of(*first, 'e', 'E'))
+      {
+	if (one_of(*(++first), '-', '+'))
+	  {
+	    ++first;
+	  }
+	if (!is_buffer_digit(*first))
+	  {
+	    error_invalid_input_non_json();
+	  }
+	first = buffer_skip_digits(first);
+      }
+
+    return first;
+  }
+
+  // Moves past a string whose opening quote 'first' points to, escape
+  // sequences are stepped over without being decoded.
+  inline const char *buffer_skip_string(const char *first, const char *last)
+  {
+    ++first; // consumes '"'
+    for (;;)
+      {
+	first = scan_string(first, last);
+	switch (*first)
+	  {
+	  case '"':
+	    return first + 1;
+	  case '\\':
+	    if ((++first) == last)
+	      {
+		error_invalid_input_eof();
+	      }
+	    ++first;
+	    break;
+	  default:
+	    error_invalid_input_eof();
+	  }
+      }
+  }
+
+  // Moves past the value starting at 'first' without building anything: the
+  // brackets of lists and maps are matched and strings are skipped, but the
+  // content of a container is not otherwise checked.
+  inline const char *buffer_skip_value(const char *first, const char *last)
+  {
+    first = buffer_next_char(first, last);
+    switch (*first)
+      {
+      case '"':
+	return buffer_skip_string(first, last);
+
+      case 't':
+	buffer_read_equals(first, last, "true");
+	return first;
+
+      case 'f':
+	buffer_read_equals(first, last, "false");
+	return first;
+
+      case 'n':
+	buffer_read_equals(first, last, "null");
+	return first;
+
+      case '[':
+      case '{':
+	break;
+
+      default:
+	return buffer_read_number(first);
+      }
+
+    std::size_t depth = 0;
+    for (;;)
+      {
+	switch (*first)
+	  {
+	  case '"':
+	    first = buffer_skip_string(first, last);
+	    continue;
+	  case '[':
+	  case '{':
+	    ++depth;
+	    break;
+	  case ']':
+	  case '}':
+	    if ((--depth) == 0)
+	      {
+		return first + 1;
+	      }
+	    break;
+	  case '\0':
+	    if (first == last)
+	      {
+		error_invalid_input_eof();
+	      }
+	  }
+	++first;
+      }
+  }
+
+  template < typename Traits, typename Allocator >
+  void buffer_read_object(const char *&first,
+			  const char *last,
+			  basic_object<char, Traits, Allocator> &obj,
+			  basic_key_table<char, Traits> *keys = nullptr,
+			  basic_deduplicator<char, Traits, Allocator> *trees = nullptr);
+
+  // Reads the members of a list to one buffer of values as long as they are
+  // numbers, which are converted in a single pass over the input. Returns
+  // false when a member isn't a number or when the numbers have no common
+  // type, the list then has to be read again as objects.
+  template < typename Allocator >
+  bool buffer_read_packed(const char *&first,
+			  const char *last,
+			  std::vector<native_value, Allocator> &values,
+			  object_type &type)
+  {
+    type = type_integer;
+    for (;;)
+      {
+	if (!is_buffer_number(*first))
+	  {
+	    return false;
+	  }
+
+	const char *number = first;
+	native_value x;
+	first = buffer_read_number(first);
+	switch (decimal_to_native(number, first, x, "json::read_buffer"))
+	  {
+	  case type_integer:
+	    if (type == type_double)
+	      {
+		if (!is_exact_double(x.integer))
+		  {
+		    return false;
+		  }
+		x.real = static_cast<double>(x.integer);
+	      }
+	    break;
+
+	  case type_double:
+	    if (type == type_integer)
+	      {
+		for (auto &v : values)
+		  {
+		    if (!is_exact_double(v.integer))
+		      {
+			return false;
+		      }
+		    v.real = static_cast<double>(v.integer);
+		  }
+		type = type_double;
+	      }
+	    break;
+
+	  default:
+	    return false;
+	  }
+	values.push_back(x);
+
+	first = buffer_next_char(first, last);
+	switch (*first)
+	  {
+	  case ',': first = buffer_next_char(first + 1, last); break;
+	  case ']': ++first; return true;
+	  default:  error_invalid_input_non_json();
+	  }
+      }
+  }
+
+  template < typename Traits, typename Allocator >
+  void buffer_read_list(const char *&first,
+			const char *last,
+			basic_object<char, Traits, Allocator> &obj,
+			basic_key_table<char, Traits> *keys,
+			basic_deduplicator<char, Traits, Allocator> *trees)
+  {
+    typedef basic_object<char, Traits, Allocator> object;
+
+    first = buffer_next_char(first + 1, last); // consumes '['
+    if (is_buffer_number(*first) && packing_scope::enabled())
+      {
+	const char *members = first;
+	typename object::native_list values (obj.get_allocator());
+	object_type type;
+	if (buffer_read_packed(first, last, values, type))
+	  {
+	    obj.make_packed(type, std::move(values));
+	    return;
+	  }
+	first = members;
+      }
+
+    obj.make_list();
+    auto &list = obj.get_list();
+    list.clear();
+
+    if ((*first) == ']')
+      {
+	++first;
+	return;
+      }
+
+    for (;;)
+      {
+	list.emplace_back(obj.get_allocator());
+	buffer_read_object(first, last, list.back(), keys, trees);
+	first = buffer_next_char(first, last);
+	switch (*first)
+	  {
+	  case ',': ++first; break;
+	  case ']': ++first; return;
+	  default:  error_invalid_input_non_json();
+	  }
+      }
+  }
+
+  // Returns the member of the map 'obj' for the key 'k', when reading with a
+  // key table the characters of the key are shared with the table.
+  template < typename Traits, typename Allocator >
+  basic_object<char, Traits, Allocator> &
+  buffer_map_member(basic_object<char, Traits, Allocator> &obj,
+		    const basic_char_sequence<char, Traits> &k,
+		    basic_key_table<char, Traits> *keys)
+  {
+    if (keys == nullptr)
+      {
+	return obj[k];
+      }
+
+    auto &map = obj.get_map();
+    const auto key = keys->intern(k);
+    auto it = map.find(key);
+    if (it == map.end())
+      {
+	it = map.emplace_interned(key, basic_object<char, Traits, Allocator>(obj.get_allocator()));
+      }
+    return it->second;
+  }
+
+  template < typename Traits, typename Allocator >
+  void buffer_read_map(const char *&first,
+		       const char *last,
+		       basic_object<char, Traits, Allocator> &obj,
+		       basic_key_table<char, Traits> *keys,
+		       basic_deduplicator<char, Traits, Allocator> *trees)
+  {
+    typedef basic_object<char, Traits, Allocator> object;
+    typedef typename object::object_string        string;
+
+    obj.make_map();
+    obj.get_map().clear();
+
+    first = buffer_next_char(first + 1, last); // consumes '{'
+    if ((*first) == '}')
+      {
+	++first;
+	return;
+      }
+
+    string key (obj.get_allocator());
+    for (;;)
+      {
+	if ((*first) != '"')
+	  {
+	    error_invalid_input_non_json();
+	  }
+	const auto k = buffer_read_key(first, last, key);
+	first = buffer_next_char(first, last);
+	if ((*first) != ':')
+	  {
+	    error_invalid_input_non_json();
+	  }
+	++first;
+	buffer_read_object(first, last, buffer_map_member(obj, k, keys), keys, trees);
+	first = buffer_next_char(first, last);
+	switch (*first)
+	  {
+	  case ',': first = buffer_next_char(first + 1, last); break;
+	  case '}': ++first; return;
+	  default:  error_invalid_input_non_json();
+	  }
+      }
+  }
+
+  // Lists and maps are shared with identical ones once all their members
+  // have been read, when reading through a deduplicator.
+  template < typename Traits, typename Allocator >
+  void buffer_add_tree(basic_object<char, Traits, Allocator> &obj,
+		       basic_deduplicator<char, Traits, Allocator> *trees)
+  {
+    if (trees != nullptr)
+      {
+	trees->add(obj);
+      }
+  }
+
+  template < typename Traits, typename Allocator >
+  void buffer_read_object(const char *&first,
+			  const char *last,
+			  basic_object<char, Traits, Allocator> &obj,
+			  basic_key_table<char, Traits> *keys,
+			  basic_deduplicator<char, Traits, Allocator> *trees)
+  {
+    first = buffer_next_char(first, last);
+    switch (*first)
+      {
+      case '[':
+	buffer_read_list(first, last, obj, keys, trees);
+	buffer_add_tree(obj, trees);
+	break;
+
+      case '{':
+	buffer_read_map(first, last, obj, keys, trees);
+	buffer_add_tree(obj, trees);
+	break;
+
+      case 't':
+	buffer_read_equals(first, last, "true");
+	obj = true;
+	break;
+
+      case 'f':
+	buffer_read_equals(first, last, "false");
+	obj = false;
+	break;
+
+      case 'n':
+	buffer_read_equals(first, last, "null");
+	obj.make_null();
+	break;
+
+      case '"':
+	buffer_read_string_value(first, last, obj);
+	break;
+
+      default:
+	const char *number = first;
+	first = buffer_read_number(first);
+	obj.make_number(basic_char_sequence<char, Traits>(number, first - number));
+      }
+  }
+
+  template < typename Traits, typename Allocator >
+  const char *read_buffer(const char *first,
+			  const char *last,
+			  basic_object<char, Traits, Allocator> &obj)
+  {
+    buffer_read_object(first, last, obj);
+    return first;
+  }
+
+  template < typename Traits, typename Allocator >
+  const char *read_buffer(const char *first,
+			  const char *last,
+			  basic_object<char, Traits, Allocator> &obj,
+			  basic_key_table<char, Traits> &keys)
+  {
+    buffer_read_object(first, last, obj, &keys);
+    return first;
+  }
+
+  template < typename Traits, typename Allocator >
+  const char *read_buffer(const char *first,
+			  const char *last,
+			  basic_object<char, Traits, Allocator> &obj,
+			  basic_deduplicator<char, Traits, Allocator> &trees)
+  {
+    buffer_read_object(first, last, obj, static_cast<basic_key_table<char, Traits> *>(nullptr), &trees);
+    return first;
+  }
+
+}
+
+#endif // JSON_BUFFER_READER_HPP
@@ -77,6 +77,17 @@ namespace json
 	  }
       }
 
+    // The sequences don't have to be null-terminated, the characters past
+    // their end must not be read.
+    if (it1 == jt1)
+      {
+	return (it2 == jt2) ? 0 : -1;
+      }
+    if (it2 == jt2)
+      {
+	return 1;
+      }
+
   end:
     return (*it1) - (*it2);
   }
@@ -0,0 +1,65 @@
+/*
+ * Copyright 2012 Achille Roussel.
+ *
+ * This file is part of Libjson++.
+ *
+ * Libjson++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Libjson++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstring>
+#include "json/error.h"
+#include "json/cursor.hpp"
+
+namespace json
+{
+
+  void error_cursor_type_mismatch()
+  {
+    throw error("json::cursor: the current value doesn't have the requested type");
+  }
+
+  void error_cursor_not_in_container()
+  {
+    throw error("json::cursor: leaving a container that wasn't entered");
+  }
+
+  template class basic_cursor<const char *>;
+  template class basic_cursor< std::istreambuf_iterator<char> >;
+
+  cursor::cursor(const char *first, const char *last):
+    basic_cursor(first, last)
+  {
+  }
+
+  cursor::cursor(const char *str):
+    basic_cursor(str, str + std::strlen(str))
+  {
+  }
+
+  cursor::cursor(const std::string &str):
+    basic_cursor(str.data(), str.data() + str.size())
+  {
+  }
+
+  cursor::cursor(const char_sequence &str):
+    basic_cursor(str.data(), str.data() + str.size())
+  {
+  }
+
+  stream_cursor::stream_cursor(std::istream &is):
+    basic_cursor(std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>())
+  {
+  }
+
+}
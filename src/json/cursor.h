@@ -0,0 +1,227 @@
+/*
+ * Copyright 2012 Achille Roussel.
+ *
+ * This file is part of Libjson++.
+ *
+ * Libjson++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Libjson++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JSON_CURSOR_H
+#define JSON_CURSOR_H
+
+#include <iosfwd>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "json/def.h"
+#include "json/char_sequence.h"
+
+namespace json
+{
+
+  /**
+   * @brief The type of the value a <em>json::basic_cursor</em> is positioned
+   * on.
+   */
+  enum token_type
+    {
+      token_end,     // no more value in the current container or input
+      token_null,
+      token_boolean,
+      token_number,
+      token_string,
+      token_list,
+      token_map
+    };
+
+  /**
+   * @brief A cursor giving pull access to JSON data, one value at a time.
+   *
+   * The cursor never builds <em>json::object</em> instances, the program
+   * moves from value to value with <em>next</em>, reads the scalars it is
+   * interested in and steps into the lists and maps with <em>enter</em> and
+   * <em>leave</em>. Values that are not read are skipped (and validated) when
+   * the cursor moves to the next one, so arbitrarily large documents can be
+   * traversed in constant memory:
+   * @code
+   * json::stream_cursor c (std::cin);
+   * c.next();   // positions the cursor on the top level list
+   * c.enter();
+   * while (c.next())
+   *   {
+   *     if (c.type() == json::token_map)
+   *       {
+   *         c.enter();
+   *         while (c.next())
+   *           {
+   *             if (c.key() == "id")
+   *               {
+   *                 std::cout << c.get_number() << std::endl;
+   *               }
+   *           }
+   *         c.leave();
+   *       }
+   *   }
+   * c.leave();
+   * @endcode
+   *
+   * The character sequences returned by the cursor are only valid until the
+   * cursor moves, they may point to the input or to an internal buffer.
+   * <br/>
+   * The functions throw a <em>json::error</em> when the input is not valid
+   * JSON or if they are called on a value of the wrong type.
+   */
+  template < typename InputIterator >
+  class basic_cursor
+  {
+
+  public:
+
+    typedef InputIterator				iterator;
+    typedef typename std::size_t			size_type;
+
+    /**
+     * @brief Creates a cursor reading the characters in [first, last).
+     */
+    basic_cursor(iterator first, iterator last);
+
+    /**
+     * @brief Moves the cursor to the next value.
+     *
+     * Inside of a list or a map the cursor moves to the next element, the
+     * current value is skipped if it wasn't read. At the top level the cursor
+     * moves to the next JSON object of the input, which allows reading a
+     * sequence of documents.
+     *
+     * @return The function returns false if there is no more value in the
+     * current container or in the input, <em>type</em> then returns
+     * <em>json::token_end</em>.
+     */
+    bool next();
+
+    /**
+     * @brief Returns the type of the value the cursor is positioned on.
+     */
+    token_type type() const;
+
+    /**
+     * @brief Returns the key of the current value when iterating over a map.
+     */
+    const char_sequence &key() const;
+
+    /**
+     * @brief Returns the number of containers the cursor has entered.
+     */
+    size_type depth() const;
+
+    /**
+     * @brief Reads the current value, which must be a string.
+     */
+    char_sequence get_string();
+
+    /**
+     * @brief Reads the current value, which must be a number, and returns its
+     * textual representation.
+     */
+    char_sequence get_number_string();
+
+    /**
+     * @brief Reads the current value, which must be a number.
+     */
+    double get_number();
+
+    /**
+     * @brief Reads the current value, which must be a boolean.
+     */
+    bool get_bool();
+
+    /**
+     * @brief Skips the current value without building it.
+     */
+    void skip_value();
+
+    /**
+     * @brief Steps into the current value, which must be a list or a map, the
+     * next call to <em>next</em> moves the cursor to its first element.
+     */
+    void enter();
+
+    /**
+     * @brief Skips the remaining elements of the current container and moves
+     * the cursor out of it.
+     */
+    void leave();
+
+  private:
+    bool start_value();
+    void assert_current(token_type type) const;
+
+    iterator		_first;
+    iterator		_last;
+    std::vector<char>	_containers;
+    std::string		_buffer;
+    std::string		_key_buffer;
+    char_sequence	_key;
+    token_type		_type;
+    bool		_pending;
+    bool		_first_element;
+
+  };
+
+  extern template class basic_cursor<const char *>;
+  extern template class basic_cursor< std::istreambuf_iterator<char> >;
+
+  /**
+   * @brief A cursor over JSON data stored in memory.
+   */
+  class cursor : public basic_cursor<const char *>
+  {
+
+  public:
+
+    cursor(const char *first, const char *last);
+
+    /**
+     * @brief Creates a cursor reading a null-terminated string.
+     */
+    explicit cursor(const char *str);
+
+    /**
+     * @brief Creates a cursor reading a string, which must outlive the cursor.
+     */
+    explicit cursor(const std::string &str);
+
+    explicit cursor(const char_sequence &str);
+
+  };
+
+  /**
+   * @brief A cursor over JSON data read from a stream.
+   *
+   * The characters are read directly from the stream buffer, no flag has to
+   * be set on the stream. Only the characters of the values the cursor moved
+   * over are extracted.
+   */
+  class stream_cursor : public basic_cursor< std::istreambuf_iterator<char> >
+  {
+
+  public:
+
+    explicit stream_cursor(std::istream &is);
+
+  };
+
+}
+
+#endif // JSON_CURSOR_H
@@ -0,0 +1,232 @@
+/*
+ * Copyright 2012 Achille Roussel.
+ *
+ * This file is part of Libjson++.
+ *
+ * Libjson++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Libjson++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JSON_CURSOR_HPP
+#define JSON_CURSOR_HPP
+
+#include <istream>
+#include "json/cursor.h"
+#include "json/events.hpp"
+#include "json/parsing.hpp"
+
+namespace json
+{
+
+  [[noreturn]]
+  void error_cursor_type_mismatch();
+
+  [[noreturn]]
+  void error_cursor_not_in_container();
+
+  template < typename InputIterator >
+  basic_cursor<InputIterator>::basic_cursor(iterator first, iterator last):
+    _first(first),
+    _last(last),
+    _containers(),
+    _buffer(),
+    _key_buffer(),
+    _key(),
+    _type(token_end),
+    _pending(false),
+    _first_element(false)
+  {
+  }
+
+  template < typename InputIterator >
+  bool basic_cursor<InputIterator>::next()
+  {
+    skip_value();
+
+    if (_containers.empty())
+      {
+	skip_spaces(_first, _last);
+	if (_first == _last)
+	  {
+	    _type = token_end;
+	    return false;
+	  }
+	return start_value();
+      }
+
+    next_char(_first, _last);
+    if ((*_first) == _containers.back())
+      {
+	_type = token_end;
+	return false;
+      }
+
+    if (!_first_element)
+      {
+	if ((*_first) != ',')
+	  {
+	    error_invalid_input_non_json();
+	  }
+	++_first;
+	next_char(_first, _last);
+      }
+    _first_element = false;
+
+    if (_containers.back() == '}')
+      {
+	if ((*_first) != '"')
+	  {
+	    error_invalid_input_non_json();
+	  }
+	_key = event_read_string(_first, _last, _key_buffer);
+	next_char(_first, _last);
+	if ((*_first) != ':')
+	  {
+	    error_invalid_input_non_json();
+	  }
+	++_first;
+	next_char(_first, _last);
+      }
+    return start_value();
+  }
+
+  template < typename InputIterator >
+  bool basic_cursor<InputIterator>::start_value()
+  {
+    switch (*_first)
+      {
+      case 'n': _type = token_null;    break;
+      case 't':
+      case 'f': _type = token_boolean; break;
+      case '"': _type = token_string;  break;
+      case '[': _type = token_list;    break;
+      case '{': _type = token_map;     break;
+      default:
+	if (!one_of(*_first, '-', '+', '0', '1', '2', '3', '4', '5', '6', '7', '8', '9'))
+	  {
+	    error_invalid_input_non_json();
+	  }
+	_type = token_number;
+      }
+    _pending = true;
+    return true;
+  }
+
+  template < typename InputIterator >
+  void basic_cursor<InputIterator>::assert_current(const token_type type) const
+  {
+    if (!_pending || (_type != type))
+      {
+	error_cursor_type_mismatch();
+      }
+  }
+
+  template < typename InputIterator >
+  token_type basic_cursor<InputIterator>::type() const
+  {
+    return _type;
+  }
+
+  template < typename InputIterator >
+  const char_sequence &basic_cursor<InputIterator>::key() const
+  {
+    return _key;
+  }
+
+  template < typename InputIterator >
+  typename basic_cursor<InputIterator>::size_type
+  basic_cursor<InputIterator>::depth() const
+  {
+    return _containers.size();
+  }
+
+  template < typename InputIterator >
+  char_sequence basic_cursor<InputIterator>::get_string()
+  {
+    assert_current(token_string);
+    _pending = false;
+    return event_read_string(_first, _last, _buffer);
+  }
+
+  template < typename InputIterator >
+  char_sequence basic_cursor<InputIterator>::get_number_string()
+  {
+    assert_current(token_number);
+    _pending = false;
+    return event_read_number(_first, _last, _buffer);
+  }
+
+  template < typename InputIterator >
+  double basic_cursor<InputIterator>::get_number()
+  {
+    const char_sequence number = get_number_string();
+    return json::stod(number.begin(), number.end());
+  }
+
+  template < typename InputIterator >
+  bool basic_cursor<InputIterator>::get_bool()
+  {
+    assert_current(token_boolean);
+    _pending = false;
+    if ((*_first) == 't')
+      {
+	read_equals(_first, _last, "true");
+	return true;
+      }
+    read_equals(_first, _last, "false");
+    return false;
+  }
+
+  template < typename InputIterator >
+  void basic_cursor<InputIterator>::skip_value()
+  {
+    if (_pending)
+      {
+	_pending = false;
+	event_handler handler;
+	event_read_value(_first, _last, handler, _buffer);
+      }
+  }
+
+  template < typename InputIterator >
+  void basic_cursor<InputIterator>::enter()
+  {
+    if (!_pending || ((_type != token_list) && (_type != token_map)))
+      {
+	error_cursor_type_mismatch();
+      }
+    _containers.push_back((_type == token_list) ? ']' : '}');
+    _pending = false;
+    _first_element = true;
+    ++_first;
+  }
+
+  template < typename InputIterator >
+  void basic_cursor<InputIterator>::leave()
+  {
+    if (_containers.empty())
+      {
+	error_cursor_not_in_container();
+      }
+    while (next())
+      {
+      }
+    _type = (_containers.back() == ']') ? token_list : token_map;
+    _containers.pop_back();
+    _first_element = false;
+    ++_first;
+  }
+
+}
+
+#endif // JSON_CURSOR_HPP
@@ -0,0 +1,134 @@
+/*
+ * Copyright 2012 Achille Roussel.
+ *
+ * This file is part of Libjson++.
+ *
+ * Libjson++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Libjson++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JSON_DEDUPLICATOR_H
+#define JSON_DEDUPLICATOR_H
+
+#include <unordered_map>
+#include "json/def.h"
+#include "json/object.h"
+
+namespace json
+{
+
+  /**
+   * @brief A table of the lists and maps shared by the documents it
+   * deduplicated.
+   *
+   * Documents often repeat whole subtrees: default settings, the same small
+   * records referenced from many places... Each copy is built separately
+   * when reading them. A deduplicator hashes the lists and maps bottom-up and
+   * makes the objects holding identical ones share a single reference
+   * counted body instead (see <em>basic_object::share</em>), which is copied
+   * the first time one of them is modified.
+   * <br/>
+   * Lists and maps are identical when their members have the same types and
+   * texts, keys of maps compared regardless of their order: 1 and 1.0 are
+   * not identical even though they compare equal. Empty lists and maps, and
+   * objects allocated in an arena which would not reclaim the memory of the
+   * duplicates, are left unchanged.
+   * <br/>
+   * The table keeps a reference on every list and map it holds, which it
+   * shares with the documents deduplicated next. Once the table is cleared
+   * or destroyed, modifying a list or map which no other object shares
+   * doesn't copy it anymore:
+   * <pre>
+   * json::deduplicator trees;
+   * std::vector<json::object> documents;
+   * for (auto &record : records)
+   *   {
+   *     documents.push_back(json::read(record, trees));
+   *   }
+   * trees.clear();
+   * </pre>
+   * A deduplicator must not be used by several threads at once, the
+   * documents it built can.
+   */
+  template < typename Char, typename Traits, typename Allocator >
+  class basic_deduplicator
+  {
+
+  public:
+
+    typedef basic_object<Char, Traits, Allocator>	value_type;
+    typedef std::size_t					size_type;
+
+    basic_deduplicator();
+
+    /**
+     * @brief Shares the list or map 'obj' with an identical one of the table,
+     * or adds it to the table. Its members must have been added first, which
+     * <em>json::read</em> does when reading through the table.
+     */
+    void add(value_type &obj);
+
+    /**
+     * @brief Adds all the lists and maps of 'obj', members first.
+     */
+    void deduplicate(value_type &obj);
+
+    /**
+     * @brief Removes the lists and maps which only the table refers to
+     * anymore, the documents they belonged to were destroyed or modified.
+     */
+    void purge();
+
+    void clear();
+
+    size_type size() const;
+
+    bool empty() const;
+
+  private:
+    basic_deduplicator(const basic_deduplicator &) = delete;
+
+    basic_deduplicator &operator=(const basic_deduplicator &) = delete;
+
+    static std::size_t hash(const value_type &obj);
+
+    static std::size_t hash_members(const value_type &obj);
+
+    static bool same(const value_type &obj1, const value_type &obj2);
+
+    static bool same_members(const value_type &obj1, const value_type &obj2);
+
+    static void unshare_unique(value_type &obj);
+
+    template < typename C, typename T, typename A >
+    friend void deduplicate(basic_object<C, T, A> &obj);
+
+    std::unordered_multimap<std::size_t, value_type>	_trees;
+
+  };
+
+  /**
+   * @brief Makes identical lists and maps of 'obj' share their body (see
+   * <em>json::basic_deduplicator</em>), unlike the table the function doesn't
+   * keep lists and maps which appear only once shared.
+   */
+  template < typename Char, typename Traits, typename Allocator >
+  void deduplicate(basic_object<Char, Traits, Allocator> &obj);
+
+  extern template class basic_deduplicator<char, char_traits, char_allocator>;
+
+  extern template void deduplicate(object &);
+
+}
+
+#endif // JSON_DEDUPLICATOR_H
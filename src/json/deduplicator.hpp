@@ -0,0 +1,376 @@
+/*
+ * Copyright 2012 Achille Roussel.
+ *
+ * This file is part of Libjson++.
+ *
+ * Libjson++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Libjson++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JSON_DEDUPLICATOR_HPP
+#define JSON_DEDUPLICATOR_HPP
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include "json/hash_key.hpp"
+#include "json/hash_map.hpp"
+#include "json/arena.h"
+#include "json/deduplicator.h"
+
+namespace json
+{
+
+  template < typename Char, typename Traits, typename Allocator >
+  basic_deduplicator<Char, Traits, Allocator>::
+  basic_deduplicator():
+    _trees()
+  {
+  }
+
+  template < typename Char, typename Traits, typename Allocator >
+  void
+  basic_deduplicator<Char, Traits, Allocator>::
+  add(value_type &obj)
+  {
+    if (((obj.type() != type_list) && (obj.type() != type_map))
+	|| (obj.size() == 0)
+	|| !destroys_objects(obj.get_allocator()))
+      {
+	return;
+      }
+
+    const std::size_t h = hash_members(obj);
+    const auto range = _trees.equal_range(h);
+    for (auto it = range.first; it != range.second; ++it)
+      {
+	if ((it->second.get_allocator() == obj.get_allocator()) && same(it->second, obj))
+	  {
+	    obj.share(it->second);
+	    return;
+	  }
+      }
+    _trees.emplace(h, value_type(obj.get_allocator()))->second.share(obj);
+  }
+
+  template < typename Char, typename Traits, typename Allocator >
+  void
+  basic_deduplicator<Char, Traits, Allocator>::
+  deduplicate(value_type &obj)
+  {
+    // The members of a shared list or map can't be modified anymore.
+    if (obj.is_shared())
+      {
+	add(obj);
+	return;
+      }
+
+    switch (obj.type())
+      {
+      case type_list:
+	if (!obj.is_packed())
+	  {
+	    for (auto &x : obj.get_list())
+	      {
+		deduplicate(x);
+	      }
+	  }
+	break;
+
+      case type_map:
+	for (auto &x : obj.get_map())
+	  {
+	    deduplicate(x.second);
+	  }
+	break;
+
+      default:
+	return;
+      }
+    add(obj);
+  }
+
+  template < typename Char, typename Traits, typename Allocator >
+  void
+  basic_deduplicator<Char, Traits, Allocator>::
+  purge()
+  {
+    // Removing a list or map may leave its members referenced only by the
+    // table, until no more is removed.
+    bool removed = true;
+    while (removed)
+      {
+	removed = false;
+	auto it = _trees.begin();
+	while (it != _trees.end())
+	  {
+	    if (it->second._body.node->references.load(std::memory_order_acquire) == 1)
+	      {
+		it = _trees.erase(it);
+		removed = true;
+	      }
+	    else
+	      {
+		++it;
+	      }
+	  }
+      }
+  }
+
+  template < typename Char, typename Traits, typename Allocator >
+  void
+  basic_deduplicator<Char, Traits, Allocator>::
+  clear()
+  {
+    _trees.clear();
+  }
+
+  template < typename Char, typename Traits, typename Allocator >
+  typename basic_deduplicator<Char, Traits, Allocator>::size_type
+  basic_deduplicator<Char, Traits, Allocator>::
+  size() const
+  {
+    return _trees.size();
+  }
+
+  template < typename Char, typename Traits, typename Allocator >
+  bool
+  basic_deduplicator<Char, Traits, Allocator>::
+  empty() const
+  {
+    return _trees.empty();
+  }
+
+  // Shared members were added to the table before the list or map holding
+  // them, identical ones share the same body and are hashed by address.
+  template < typename Char, typename Traits, typename Allocator >
+  std::size_t
+  basic_deduplicator<Char, Traits, Allocator>::
+  hash(const value_type &obj)
+  {
+    const std::size_t type = obj.type();
+
+    switch (obj.type())
+      {
+      case type_list:
+      case type_map:
+	if (obj.is_shared())
+	  {
+	    return std::hash<const void *>()(obj._body.node);
+	  }
+	return hash_members(obj);
+
+      case type_string:
+      case type_boolean:
+      case type_integer:
+      case type_unsigned:
+      case type_double:
+	return hash_one(type, json::hash(obj.get_char_sequence()));
+
+      case type_null:
+	break;
+      }
+    return hash_one(type, static_cast<std::size_t>(hash_init));
+  }
+
+  // Maps are hashed regardless of the order of their members.
+  template < typename Char, typename Traits, typename Allocator >
+  std::size_t
+  basic_deduplicator<Char, Traits, Allocator>::
+  hash_members(const value_type &obj)
+  {
+    std::size_t h = hash_one(static_cast<std::size_t>(obj.type()), static_cast<std::size_t>(hash_init));
+
+    if (obj.type() == type_map)
+      {
+	std::size_t members = 0;
+	for (const auto &x : obj.get_map())
+	  {
+	    members += hash_one(hash(x.second), x.first.hash());
+	  }
+	return hash_one(members, h);
+      }
+
+    switch (obj.packed_type())
+      {
+      case type_integer:
+	for (const long long x : obj.get_integers())
+	  {
+	    h = hash_one(std::hash<long long>()(x), h);
+	  }
+	break;
+
+      case type_double:
+	for (const double x : obj.get_doubles())
+	  {
+	    h = hash_one(std::hash<double>()(x), h);
+	  }
+	break;
+
+      default:
+	for (const auto &x : obj.get_list())
+	  {
+	    h = hash_one(hash(x), h);
+	  }
+	break;
+      }
+    return h;
+  }
+
+  // Numbers are identical when they have the same type, value and text,
+  // doubles are compared bitwise (0.0 and -0.0 differ).
+  template < typename Char, typename Traits, typename Allocator >
+  bool
+  basic_deduplicator<Char, Traits, Allocator>::
+  same(const value_type &obj1, const value_type &obj2)
+  {
+    double x1;
+    double x2;
+
+    if (obj1.type() != obj2.type())
+      {
+	return false;
+      }
+
+    switch (obj1.type())
+      {
+      case type_null:
+	return true;
+
+      case type_string:
+	return obj1.get_char_sequence() == obj2.get_char_sequence();
+
+      case type_boolean:
+	return obj1.get_boolean() == obj2.get_boolean();
+
+      case type_integer:
+	return (obj1.get_integer() == obj2.get_integer())
+	  && (obj1.get_char_sequence() == obj2.get_char_sequence());
+
+      case type_unsigned:
+	return (obj1.get_unsigned() == obj2.get_unsigned())
+	  && (obj1.get_char_sequence() == obj2.get_char_sequence());
+
+      case type_double:
+	x1 = obj1.get_double();
+	x2 = obj2.get_double();
+	return (std::memcmp(&x1, &x2, sizeof(double)) == 0)
+	  && (obj1.get_char_sequence() == obj2.get_char_sequence());
+
+      case type_list:
+      case type_map:
+	if (obj1.is_shared() && obj2.is_shared() && (obj1._body.node == obj2._body.node))
+	  {
+	    return true;
+	  }
+	return same_members(obj1, obj2);
+      }
+    return false;
+  }
+
+  template < typename Char, typename Traits, typename Allocator >
+  bool
+  basic_deduplicator<Char, Traits, Allocator>::
+  same_members(const value_type &obj1, const value_type &obj2)
+  {
+    if ((obj1.size() != obj2.size()) || (obj1.packed_type() != obj2.packed_type()))
+      {
+	return false;
+      }
+
+    if (obj1.type() == type_map)
+      {
+	const auto &map2 = obj2.get_map();
+	for (const auto &x : obj1.get_map())
+	  {
+	    const auto it = map2.find(x.first);
+	    if ((it == map2.end()) || !same(x.second, it->second))
+	      {
+		return false;
+	      }
+	  }
+	return true;
+      }
+
+    switch (obj1.packed_type())
+      {
+      case type_integer:
+	return std::equal(obj1.get_integers().begin(), obj1.get_integers().end(),
+			  obj2.get_integers().begin());
+
+      case type_double:
+	return std::memcmp(obj1.get_doubles().data(), obj2.get_doubles().data(),
+			   obj1.size() * sizeof(double)) == 0;
+
+      default:
+	return std::equal(obj1.get_list().begin(), obj1.get_list().end(),
+			  obj2.get_list().begin(), same);
+      }
+  }
+
+  // Gives back their body to the objects which are the only ones sharing it,
+  // the members of bodies still shared are left as they are since other
+  // threads may be reading them.
+  template < typename Char, typename Traits, typename Allocator >
+  void
+  basic_deduplicator<Char, Traits, Allocator>::
+  unshare_unique(value_type &obj)
+  {
+    if (obj.is_shared())
+      {
+	if (obj._body.node->references.load(std::memory_order_acquire) != 1)
+	  {
+	    return;
+	  }
+	obj.unshare();
+      }
+
+    switch (obj.type())
+      {
+      case type_list:
+	if (!obj.is_packed())
+	  {
+	    for (auto &x : obj.get_list())
+	      {
+		unshare_unique(x);
+	      }
+	  }
+	break;
+
+      case type_map:
+	for (auto &x : obj.get_map())
+	  {
+	    unshare_unique(x.second);
+	  }
+	break;
+
+      default:
+	break;
+      }
+  }
+
+  template < typename Char, typename Traits, typename Allocator >
+  void deduplicate(basic_object<Char, Traits, Allocator> &obj)
+  {
+    typedef basic_deduplicator<Char, Traits, Allocator> deduplicator_type;
+
+    {
+      deduplicator_type trees;
+      trees.deduplicate(obj);
+    }
+    deduplicator_type::unshare_unique(obj);
+  }
+
+}
+
+#endif // JSON_DEDUPLICATOR_HPP
@@ -0,0 +1,719 @@
+/*
+ * Copyright 2012 Achille Roussel.
+ *
+ * This file is part of Libjson++.
+ *
+ * Libjson++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Libjson++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include "json/buffer_reader.hpp"
+#include "json/document.h"
+#include "json/error.h"
+#include "json/object.hpp"
+#include "json/parsing.hpp"
+
+namespace json
+{
+
+  [[noreturn]]
+  void error_document_invalid_type(const object_type expected,
+				   const object_type type,
+				   const char *function)
+  {
+    std::ostringstream s;
+    s << function << ": expected " << expected << " but the value is a " << type;
+    throw error(s.str());
+  }
+
+  [[noreturn]]
+  void error_document_no_such_key(const char_sequence &key)
+  {
+    std::ostringstream s;
+    s << "json::document_value::operator[key]: no such key '";
+    s.write(key.data(), key.size());
+    s << '\'';
+    throw error(s.str());
+  }
+
+  [[noreturn]]
+  void error_document_too_large()
+  {
+    throw error("json::document: the document has too many values to fit in a tape");
+  }
+
+  namespace
+  {
+
+    // Every word of the tape starts with a tag, the other 56 bits depend on
+    // the tag:
+    // - lists and maps store their number of members on 24 bits (saturated,
+    //   larger containers are counted by walking them) and the position of
+    //   their end word on 32 bits,
+    // - the end words of lists and maps store the position of their start,
+    // - strings and numbers store the offset of their characters in the
+    //   arena, the following word holds their length,
+    // - the other values only have a tag.
+    enum tape_tag
+      {
+	tape_null	= 'n',
+	tape_true	= 't',
+	tape_false	= 'f',
+	tape_string	= '"',
+	tape_number	= 'd',
+	tape_list	= '[',
+	tape_list_end	= ']',
+	tape_map	= '{',
+	tape_map_end	= '}'
+      };
+
+    const unsigned      tape_tag_shift    = 56;
+    const std::uint64_t tape_payload_mask = (std::uint64_t(1) << tape_tag_shift) - 1;
+    const std::uint64_t tape_position_max = 0xFFFFFFFF;
+    const std::uint64_t tape_count_max    = 0xFFFFFF;
+
+    inline std::uint64_t tape_word(const tape_tag tag, const std::uint64_t payload)
+    {
+      return (std::uint64_t(tag) << tape_tag_shift) | payload;
+    }
+
+    inline char tape_tag_of(const std::uint64_t word)
+    {
+      return static_cast<char>(word >> tape_tag_shift);
+    }
+
+    inline std::size_t tape_payload(const std::uint64_t word)
+    {
+      return static_cast<std::size_t>(word & tape_payload_mask);
+    }
+
+    inline std::size_t tape_end(const std::uint64_t word)
+    {
+      return static_cast<std::size_t>(word & tape_position_max);
+    }
+
+    inline std::size_t tape_count(const std::uint64_t word)
+    {
+      return static_cast<std::size_t>((word >> 32) & tape_count_max);
+    }
+
+    // Returns the position of the word following the value at 'index'.
+    inline std::size_t tape_skip(const std::uint64_t *tape, const std::size_t index)
+    {
+      switch (tape_tag_of(tape[index]))
+	{
+	case tape_list:
+	case tape_map:    return tape_end(tape[index]) + 1;
+	case tape_string:
+	case tape_number: return index + 2;
+	default:          return index + 1;
+	}
+    }
+
+    inline char_sequence tape_text(const std::uint64_t *tape,
+				   const char *strings,
+				   const std::size_t index)
+    {
+      return char_sequence(strings + tape_payload(tape[index]),
+			   static_cast<std::size_t>(tape[index + 1]));
+    }
+
+    class tape_builder
+    {
+
+    public:
+
+      tape_builder(std::vector<std::uint64_t> &tape, std::vector<char> &strings):
+	_tape(tape),
+	_strings(strings),
+	_escape()
+      {
+      }
+
+      void read_value(const char *&first, const char *last)
+      {
+	first = buffer_next_char(first, last);
+	switch (*first)
+	  {
+	  case '[': read_list(first, last); break;
+	  case '{': read_map(first, last);  break;
+	  case '"': read_string(first, last); break;
+
+	  case 't':
+	    buffer_read_equals(first, last, "true");
+	    _tape.push_back(tape_word(tape_true, 0));
+	    break;
+
+	  case 'f':
+	    buffer_read_equals(first, last, "false");
+	    _tape.push_back(tape_word(tape_false, 0));
+	    break;
+
+	  case 'n':
+	    buffer_read_equals(first, last, "null");
+	    _tape.push_back(tape_word(tape_null, 0));
+	    break;
+
+	  default:
+	    const char *number = first;
+	    first = buffer_read_number(first);
+	    push_text(tape_number, _strings.size(), number, first);
+	  }
+      }
+
+    private:
+
+      void push_text(const tape_tag tag,
+		     const std::size_t offset,
+		     const char *first,
+		     const char *last)
+      {
+	_strings.insert(_strings.end(), first, last);
+	_tape.push_back(tape_word(tag, offset));
+	_tape.push_back(_strings.size() - offset);
+      }
+
+      // Plain runs of characters are copied to the arena in bulk, escape
+      // sequences are decoded one at a time.
+      void read_string(const char *&first, const char *last)
+      {
+	const std::size_t offset = _strings.size();
+	++first; // consumes '"'
+	for (;;)
+	  {
+	    const char *run = first;
+	    first = scan_string(first, last);
+	    _strings.insert(_strings.end(), run, first);
+	    switch (*first)
+	      {
+	      case '"':
+		++first;
+		push_text(tape_string, offset, first, first);
+		return;
+	      case '\\':
+		_escape.clear();
+		buffer_read_escape(first, last, _escape);
+		_strings.insert(_strings.end(), _escape.begin(), _escape.end());
+		break;
+	      default:
+		error_invalid_input_eof();
+	      }
+	  }
+      }
+
+      std::size_t open(const tape_tag tag)
+      {
+	_tape.push_back(tape_word(tag, 0));
+	return _tape.size() - 1;
+      }
+
+      void close(const tape_tag tag,
+		 const tape_tag end_tag,
+		 const std::size_t start,
+		 const std::size_t count)
+      {
+	const std::size_t end = _tape.size();
+	if (end > tape_position_max)
+	  {
+	    error_document_too_large();
+	  }
+	_tape.push_back(tape_word(end_tag, start));
+	const std::uint64_t n = (count < tape_count_max) ? count : tape_count_max;
+	_tape[start] = tape_word(tag, (n << 32) | end);
+      }
+
+      void read_list(const char *&first, const char *last)
+      {
+	const std::size_t start = open(tape_list);
+	std::size_t count = 0;
+
+	first = buffer_next_char(first + 1, last); // consumes '['
+	if ((*first) == ']')
+	  {
+	    ++first;
+	    close(tape_list, tape_list_end, start, count);
+	    return;
+	  }
+
+	for (;;)
+	  {
+	    read_value(first, last);
+	    ++count;
+	    first = buffer_next_char(first, last);
+	    switch (*first)
+	      {
+	      case ',': ++first; break;
+	      case ']': ++first; close(tape_list, tape_list_end, start, count); return;
+	      default:  error_invalid_input_non_json();
+	      }
+	  }
+      }
+
+      void read_map(const char *&first, const char *last)
+      {
+	const std::size_t start = open(tape_map);
+	std::size_t count = 0;
+
+	first = buffer_next_char(first + 1, last); // consumes '{'
+	if ((*first) == '}')
+	  {
+	    ++first;
+	    close(tape_map, tape_map_end, start, count);
+	    return;
+	  }
+
+	for (;;)
+	  {
+	    if ((*first) != '"')
+	      {
+		error_invalid_input_non_json();
+	      }
+	    read_string(first, last);
+	    first = buffer_next_char(first, last);
+	    if ((*first) != ':')
+	      {
+		error_invalid_input_non_json();
+	      }
+	    read_value(++first, last);
+	    ++count;
+	    first = buffer_next_char(first, last);
+	    switch (*first)
+	      {
+	      case ',': first = buffer_next_char(first + 1, last); break;
+	      case '}': ++first; close(tape_map, tape_map_end, start, count); return;
+	      default:  error_invalid_input_non_json();
+	      }
+	  }
+      }
+
+      std::vector<std::uint64_t> &	_tape;
+      std::vector<char> &		_strings;
+      std::string			_escape;
+
+    };
+
+    void copy_value(const document_value &value, object &obj)
+    {
+      switch (value.type())
+	{
+	case type_list:
+	  obj.make_list();
+	  for (const auto &member : value)
+	    {
+	      obj.get_list().emplace_back();
+	      copy_value(member, obj.get_list().back());
+	    }
+	  break;
+
+	case type_map:
+	  obj.make_map();
+	  for (const auto &member : value)
+	    {
+	      copy_value(member, obj[member.key()]);
+	    }
+	  break;
+
+	case type_null:
+	  obj.make_null();
+	  break;
+
+	case type_boolean:
+	  obj = is_true(value);
+	  break;
+
+	case type_integer:
+	case type_unsigned:
+	case type_double:
+	  obj.make_number(value.get_char_sequence());
+	  break;
+
+	case type_string:
+	  {
+	    const char_sequence str = value.get_char_sequence();
+	    obj.make_string();
+	    obj.get_string().assign(str.data(), str.size());
+	  }
+	  break;
+	}
+    }
+
+  }
+
+  document_value::document_value(const std::uint64_t *tape,
+				 const char *strings,
+				 const size_type index,
+				 const size_type key):
+    _tape(tape),
+    _strings(strings),
+    _index(index),
+    _key(key)
+  {
+  }
+
+  object_type document_value::type() const
+  {
+    switch (tape_tag_of(_tape[_index]))
+      {
+      case tape_list:   return type_list;
+      case tape_map:    return type_map;
+      case tape_null:   return type_null;
+      case tape_true:
+      case tape_false:  return type_boolean;
+      case tape_string: return type_string;
+      default:          break;
+      }
+
+    // Numbers are classified like json::read does, from their text.
+    native_value x;
+    const char_sequence str = tape_text(_tape, _strings, _index);
+    return decimal_to_native(str.data(), str.data() + str.size(), x, "json::document_value::type");
+  }
+
+  document_value::size_type document_value::size() const
+  {
+    switch (tape_tag_of(_tape[_index]))
+      {
+      case tape_list:
+      case tape_map:
+	break;
+      default:
+	return 0;
+      }
+
+    const size_type count = tape_count(_tape[_index]);
+    if (count != tape_count_max)
+      {
+	return count;
+      }
+    return std::distance(begin(), end());
+  }
+
+  bool document_value::empty() const
+  {
+    return size() == 0;
+  }
+
+  char_sequence document_value::key() const
+  {
+    if (_key == 0)
+      {
+	return char_sequence();
+      }
+    return tape_text(_tape, _strings, _key);
+  }
+
+  document_value document_value::operator[](size_type index) const
+  {
+    if (type() != type_list)
+      {
+	error_document_invalid_type(type_list, type(), "json::document_value::operator[index]");
+      }
+    for (auto it = begin(), jt = end(); it != jt; ++it, --index)
+      {
+	if (index == 0)
+	  {
+	    return *it;
+	  }
+      }
+    throw std::out_of_range("json::document_value::operator[index]");
+  }
+
+  document_value document_value::operator[](const char_sequence &key) const
+  {
+    const const_iterator it = find(key);
+    if (it == end())
+      {
+	error_document_no_such_key(key);
+      }
+    return *it;
+  }
+
+  document_value::const_iterator document_value::find(const char_sequence &key) const
+  {
+    if (type() != type_map)
+      {
+	error_document_invalid_type(type_map, type(), "json::document_value::operator[key]");
+      }
+    const_iterator found = end();
+    for (auto it = begin(), jt = end(); it != jt; ++it)
+      {
+	if (it->key() == key)
+	  {
+	    found = it;
+	  }
+      }
+    return found;
+  }
+
+  document_value::const_iterator document_value::begin() const
+  {
+    switch (tape_tag_of(_tape[_index]))
+      {
+      case tape_list:
+      case tape_map:
+	return const_iterator(*this, _index + 1);
+      default:
+	return const_iterator(*this, _index);
+      }
+  }
+
+  document_value::const_iterator document_value::end() const
+  {
+    switch (tape_tag_of(_tape[_index]))
+      {
+      case tape_list:
+      case tape_map:
+	return const_iterator(*this, tape_end(_tape[_index]));
+      default:
+	return const_iterator(*this, _index);
+      }
+  }
+
+  char_sequence document_value::get_char_sequence() const
+  {
+    switch (tape_tag_of(_tape[_index]))
+      {
+      case tape_string:
+      case tape_number: return tape_text(_tape, _strings, _index);
+      case tape_true:   return char_sequence("true");
+      case tape_false:  return char_sequence("false");
+      default:
+	error_document_invalid_type(type_string, type(), "json::document_value::get_char_sequence");
+      }
+  }
+
+  std::string document_value::get_string() const
+  {
+    const char_sequence str = get_char_sequence();
+    return std::string(str.data(), str.size());
+  }
+
+  object document_value::get() const
+  {
+    object obj;
+    copy_value(*this, obj);
+    return obj;
+  }
+
+  document_value::const_iterator::const_iterator(const document_value &container,
+						 const size_type position):
+    _value(container),
+    _position(position),
+    _map(tape_tag_of(container._tape[container._index]) == tape_map)
+  {
+    load();
+  }
+
+  document_value::const_iterator &document_value::const_iterator::operator++()
+  {
+    _position = tape_skip(_value._tape, _value._index);
+    load();
+    return *this;
+  }
+
+  document_value::const_iterator document_value::const_iterator::operator++(int)
+  {
+    const_iterator it (*this);
+    ++(*this);
+    return it;
+  }
+
+  // The value of a member of a map follows its key, which takes two words.
+  // Past the last member the value points to the end word of the container
+  // and is never dereferenced.
+  void document_value::const_iterator::load()
+  {
+    if (_map && (tape_tag_of(_value._tape[_position]) != tape_map_end))
+      {
+	_value._index = _position + 2;
+	_value._key = _position;
+      }
+    else
+      {
+	_value._index = _position;
+	_value._key = 0;
+      }
+  }
+
+  document::document():
+    _tape(1, tape_word(tape_null, 0)),
+    _strings()
+  {
+  }
+
+  document::document(const char *str):
+    _tape(),
+    _strings()
+  {
+    load(str, str + std::strlen(str));
+  }
+
+  document::document(const char_sequence &str):
+    _tape(),
+    _strings()
+  {
+    // The buffer reader needs a '\0' after the input.
+    const std::string copy (str.data(), str.size());
+    load(copy.c_str(), copy.c_str() + copy.size());
+  }
+
+  document::document(const std::string &str):
+    _tape(),
+    _strings()
+  {
+    load(str.c_str(), str.c_str() + str.size());
+  }
+
+  document::document(document &&doc):
+    _tape(std::move(doc._tape)),
+    _strings(std::move(doc._strings))
+  {
+  }
+
+  document &document::operator=(document &&doc)
+  {
+    _tape = std::move(doc._tape);
+    _strings = std::move(doc._strings);
+    return *this;
+  }
+
+  // The unescaped strings and numbers are never longer than the input so the
+  // arena is allocated once. The tape is sized for a word every three
+  // characters, which covers maps of short keys and values, and only grows
+  // for denser inputs such as lists of small numbers.
+  void document::load(const char *first, const char *last)
+  {
+    _strings.reserve(last - first);
+    _tape.reserve((last - first) / 3 + 2);
+
+    tape_builder builder (_tape, _strings);
+    builder.read_value(first, last);
+  }
+
+  document_value document::root() const
+  {
+    return document_value(_tape.data(), _strings.data(), 0, 0);
+  }
+
+  object_type document::type() const
+  {
+    return root().type();
+  }
+
+  document::size_type document::size() const
+  {
+    return root().size();
+  }
+
+  bool document::empty() const
+  {
+    return root().empty();
+  }
+
+  document_value document::operator[](const size_type index) const
+  {
+    return root()[index];
+  }
+
+  document_value document::operator[](const char_sequence &key) const
+  {
+    return root()[key];
+  }
+
+  document::const_iterator document::find(const char_sequence &key) const
+  {
+    return root().find(key);
+  }
+
+  document::const_iterator document::begin() const
+  {
+    return root().begin();
+  }
+
+  document::const_iterator document::end() const
+  {
+    return root().end();
+  }
+
+  object document::get() const
+  {
+    return root().get();
+  }
+
+  bool is_true(const document_value &value)
+  {
+    return tape_tag_of(value._tape[value._index]) == tape_true;
+  }
+
+  bool is_false(const document_value &value)
+  {
+    return tape_tag_of(value._tape[value._index]) == tape_false;
+  }
+
+  bool is_number(const document_value &value)
+  {
+    return tape_tag_of(value._tape[value._index]) == tape_number;
+  }
+
+  int stoi(const document_value &value)
+  {
+    const auto str = value.get_char_sequence();
+    return stoi(str);
+  }
+
+  long stol(const document_value &value)
+  {
+    const auto str = value.get_char_sequence();
+    return stol(str);
+  }
+
+  long long stoll(const document_value &value)
+  {
+    const auto str = value.get_char_sequence();
+    return stoll(str);
+  }
+
+  unsigned long stoul(const document_value &value)
+  {
+    const auto str = value.get_char_sequence();
+    return stoul(str);
+  }
+
+  unsigned long long stoull(const document_value &value)
+  {
+    const auto str = value.get_char_sequence();
+    return stoull(str);
+  }
+
+  float stof(const document_value &value)
+  {
+    const auto str = value.get_char_sequence();
+    return stof(str);
+  }
+
+  double stod(const document_value &value)
+  {
+    const auto str = value.get_char_sequence();
+    return stod(str);
+  }
+
+  long double stold(const document_value &value)
+  {
+    const auto str = value.get_char_sequence();
+    return stold(str);
+  }
+
+}
@@ -0,0 +1,304 @@
+/*
+ * Copyright 2012 Achille Roussel.
+ *
+ * This file is part of Libjson++.
+ *
+ * Libjson++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Libjson++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JSON_DOCUMENT_H
+#define JSON_DOCUMENT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "json/def.h"
+#include "json/object.h"
+
+namespace json
+{
+
+  /**
+   * @brief A value of a <em>json::document</em>.
+   *
+   * A document value is a small handle on a position of the tape of its
+   * document, it is cheap to copy and remains valid as long as the document
+   * exists (moving the document doesn't invalidate it). The members of lists
+   * and maps are found by walking the tape, nested containers are skipped in
+   * constant time.
+   */
+  class document_value
+  {
+
+  public:
+
+    typedef std::size_t	size_type;
+
+    class const_iterator;
+
+    object_type type() const;
+
+    /**
+     * @brief Returns the number of members of a list or a map, zero for the
+     * other types.
+     */
+    size_type size() const;
+
+    bool empty() const;
+
+    /**
+     * @brief Returns the key of a member of a map, an empty sequence for the
+     * other values.
+     */
+    char_sequence key() const;
+
+    /**
+     * @brief Returns a member of a list, the tape is walked up to the member
+     * so accessing members by index is linear, prefer iterating over a list.
+     */
+    document_value operator[](size_type index) const;
+
+    /**
+     * @brief Returns the value of a member of a map, if the key appears more
+     * than once the last value is returned (like with <em>json::read</em>).
+     *
+     * @note The function throws a <em>json::error</em> if the key doesn't
+     * exist, see <em>find</em> to test for optional members.
+     */
+    document_value operator[](const char_sequence &key) const;
+
+    /**
+     * @brief Returns an iterator to the member of a map with the given key,
+     * or <em>end()</em> if the key doesn't exist.
+     */
+    const_iterator find(const char_sequence &key) const;
+
+    /**
+     * @brief Iterates over the members of a list or a map, the keys of the
+     * members of a map are available through their <em>key</em> function.
+     */
+    const_iterator begin() const;
+
+    const_iterator end() const;
+
+    /**
+     * @brief Returns the characters of a string, a number or a boolean, they
+     * are stored in the string arena of the document.
+     */
+    char_sequence get_char_sequence() const;
+
+    std::string get_string() const;
+
+    /**
+     * @brief Returns a copy of the value as a <em>json::object</em>.
+     */
+    object get() const;
+
+  private:
+    friend class document;
+    friend bool is_true(const document_value &value);
+    friend bool is_false(const document_value &value);
+    friend bool is_number(const document_value &value);
+
+    document_value(const std::uint64_t *tape,
+		   const char *strings,
+		   size_type index,
+		   size_type key);
+
+    const std::uint64_t *	_tape;
+    const char *		_strings;
+    size_type			_index;
+    size_type			_key;
+
+  };
+
+  class document_value::const_iterator
+  {
+
+  public:
+
+    typedef std::forward_iterator_tag	iterator_category;
+    typedef document_value		value_type;
+    typedef std::ptrdiff_t		difference_type;
+    typedef const document_value *	pointer;
+    typedef const document_value &	reference;
+
+    reference operator*() const
+    {
+      return _value;
+    }
+
+    pointer operator->() const
+    {
+      return &_value;
+    }
+
+    const_iterator &operator++();
+
+    const_iterator operator++(int);
+
+    bool operator==(const const_iterator &it) const
+    {
+      return _position == it._position;
+    }
+
+    bool operator!=(const const_iterator &it) const
+    {
+      return _position != it._position;
+    }
+
+  private:
+    friend class document_value;
+
+    const_iterator(const document_value &container, size_type position);
+
+    void load();
+
+    document_value	_value;
+    size_type		_position;
+    bool		_map;
+
+  };
+
+  /**
+   * @brief An immutable JSON document stored as a flat tape.
+   *
+   * The input is parsed once into two contiguous buffers: a tape of 64 bits
+   * words describing the values in document order, and an arena holding the
+   * unescaped characters of the strings and numbers. A list or a map takes a
+   * word which records its number of members and the position of its end on
+   * the tape, strings and numbers take two words with the offset and the
+   * length of their characters in the arena.
+   * <br/>
+   * Compared to a tree of <em>json::object</em>, loading a document makes
+   * one or two allocations instead of one per node and reading it walks
+   * memory sequentially, which suits documents that are read but never
+   * modified. The document mirrors the interface of <em>json::object</em>
+   * for reading:
+   * <pre>
+   * json::document doc (payload);
+   * double price = json::stod(doc["items"][0]["price"]);
+   * </pre>
+   *
+   * @note The constructors throw a <em>json::error</em> if the input is not
+   * valid JSON. Like <em>json::read</em>, parsing stops at the end of the
+   * first value of the input.
+   */
+  class document
+  {
+
+  public:
+
+    typedef document_value::size_type		size_type;
+    typedef document_value::const_iterator	const_iterator;
+
+    document();
+
+    explicit document(const char *str);
+
+    explicit document(const char_sequence &str);
+
+    explicit document(const std::string &str);
+
+    document(document &&doc);
+
+    document &operator=(document &&doc);
+
+    /**
+     * @brief Returns the top-level value of the document.
+     */
+    document_value root() const;
+
+    object_type type() const;
+
+    size_type size() const;
+
+    bool empty() const;
+
+    document_value operator[](size_type index) const;
+
+    document_value operator[](const char_sequence &key) const;
+
+    const_iterator find(const char_sequence &key) const;
+
+    const_iterator begin() const;
+
+    const_iterator end() const;
+
+    object get() const;
+
+  private:
+    document(const document &) = delete;
+
+    document &operator=(const document &) = delete;
+
+    void load(const char *first, const char *last);
+
+    std::vector<std::uint64_t>	_tape;
+    std::vector<char>		_strings;
+
+  };
+
+  inline bool is_string(const document_value &value)
+  {
+    return value.type() == type_string;
+  }
+
+  inline bool is_list(const document_value &value)
+  {
+    return value.type() == type_list;
+  }
+
+  inline bool is_map(const document_value &value)
+  {
+    return value.type() == type_map;
+  }
+
+  inline bool is_null(const document_value &value)
+  {
+    return value.type() == type_null;
+  }
+
+  bool is_true(const document_value &value);
+
+  bool is_false(const document_value &value);
+
+  /**
+   * @brief Returns true if the value is a number, its <em>type</em> is then
+   * one of the number types and its text is read with
+   * <em>get_char_sequence</em>.
+   */
+  bool is_number(const document_value &value);
+
+  int stoi(const document_value &value);
+
+  long stol(const document_value &value);
+
+  long long stoll(const document_value &value);
+
+  unsigned long stoul(const document_value &value);
+
+  unsigned long long stoull(const document_value &value);
+
+  float stof(const document_value &value);
+
+  double stod(const document_value &value);
+
+  long double stold(const document_value &value);
+
+}
+
+#endif // JSON_DOCUMENT_H
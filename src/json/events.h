@@ -0,0 +1,104 @@
+/*
+ * Copyright 2012 Achille Roussel.
+ *
+ * This file is part of Libjson++.
+ *
+ * Libjson++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Libjson++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JSON_EVENTS_H
+#define JSON_EVENTS_H
+
+#include <iosfwd>
+#include <string>
+#include "json/def.h"
+
+namespace json
+{
+
+  /**
+   * @brief Base class for the handlers of <em>json::parse_events</em>.
+   *
+   * The handler passed to <em>json::parse_events</em> can be of any type
+   * providing the member functions below, they are resolved at compile time
+   * and are not virtual. Inheriting from this class provides default
+   * implementations that ignore the events, a handler then only has to define
+   * the functions it is interested in.
+   * <br/>
+   * Every function returns a boolean, returning false stops the parsing.
+   * <br/>
+   * The character sequences passed to the handler are only valid for the
+   * duration of the call, they may point to the parsed input or to a buffer
+   * that is reused for the next string.
+   */
+  struct event_handler
+  {
+    bool on_null()                            { return true; }
+    bool on_bool(bool)                        { return true; }
+    bool on_number(const char_sequence &)     { return true; }
+    bool on_string(const char_sequence &)     { return true; }
+    bool on_key(const char_sequence &)        { return true; }
+    bool on_start_map()                       { return true; }
+    bool on_end_map()                         { return true; }
+    bool on_start_list()                      { return true; }
+    bool on_end_list()                        { return true; }
+  };
+
+  /**
+   * @brief Parses JSON and reports its content to a handler.
+   *
+   * No <em>json::object</em> is built, the values are passed to the handler
+   * as they are read (see <em>json::event_handler</em>).
+   *
+   * @param first An iterator pointing to the begining of the data to be parsed.
+   * @param last An iterator pointing to the end of the data to be parsed.
+   * @param handler The handler receiving the parsing events.
+   *
+   * @return The function returns true if a complete JSON object was parsed,
+   * false if the handler stopped the parsing.
+   *
+   * @note The function throws a <em>json::error</em> if the input is not
+   * valid JSON. Like <em>json::read_object</em> it stops reading once it has
+   * parsed a JSON object, 'first' is left pointing after it.
+   */
+  template < typename InputIterator, typename Handler >
+  bool parse_events(InputIterator &first, InputIterator &last, Handler &&handler);
+
+  /**
+   * @brief Parses a JSON string and reports its content to a handler.
+   *
+   * Strings and numbers that don't contain escape sequences are passed to
+   * the handler as views on 'str', without being copied.
+   */
+  template < typename Handler >
+  bool parse_events(const char *str, Handler &&handler);
+
+  template < typename Handler >
+  bool parse_events(const char_sequence &str, Handler &&handler);
+
+  template < typename Handler >
+  bool parse_events(const std::string &str, Handler &&handler);
+
+  /**
+   * @brief Parses JSON from a stream and reports its content to a handler.
+   *
+   * The characters are read directly from the stream buffer, no flag has to
+   * be set on the stream.
+   */
+  template < typename Handler >
+  bool parse_events(std::istream &is, Handler &&handler);
+
+}
+
+#endif // JSON_EVENTS_H
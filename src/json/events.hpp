@@ -0,0 +1,255 @@
+/*
+ * Copyright 2012 Achille Roussel.
+ *
+ * This file is part of Libjson++.
+ *
+ * Libjson++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Libjson++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JSON_EVENTS_HPP
+#define JSON_EVENTS_HPP
+
+#include <cstring>
+#include <istream>
+#include <iterator>
+#include <string>
+#include "json/events.h"
+#include "json/char_sequence.hpp"
+#include "json/reader.hpp"
+
+namespace json
+{
+
+  template < typename InputIterator >
+  char_sequence event_read_string(InputIterator &first,
+				  InputIterator &last,
+				  std::string &buffer)
+  {
+    buffer.clear();
+    read_key(first, last, buffer);
+    return char_sequence(buffer);
+  }
+
+  // Strings without escape sequences are returned as a view on the input.
+  inline char_sequence event_read_string(const char *&first,
+					 const char *&last,
+					 std::string &buffer)
+  {
+    const char *str = first + 1;
+    const char *end = scan_string(str, last);
+    if ((end != last) && ((*end) == '"'))
+      {
+	first = end + 1;
+	return char_sequence(str, end - str);
+      }
+    buffer.clear();
+    read_key(first, last, buffer);
+    return char_sequence(buffer);
+  }
+
+  template < typename InputIterator >
+  char_sequence event_read_number(InputIterator &first,
+				  InputIterator &last,
+				  std::string &buffer)
+  {
+    buffer.clear();
+    if (!read_number(first, last, [&](const char &c) { buffer.push_back(c); }))
+      {
+	error_invalid_input_non_json();
+      }
+    return char_sequence(buffer);
+  }
+
+  inline char_sequence event_read_number(const char *&first,
+					 const char *&last,
+					 std::string &)
+  {
+    const char *number = first;
+    if (!read_number(first, last, [](const char &) { }))
+      {
+	error_invalid_input_non_json();
+      }
+    return char_sequence(number, first - number);
+  }
+
+  template < typename InputIterator, typename Handler >
+  bool event_read_value(InputIterator &first,
+			InputIterator &last,
+			Handler &handler,
+			std::string &buffer);
+
+  template < typename InputIterator, typename Handler >
+  bool event_read_list(InputIterator &first,
+		       InputIterator &last,
+		       Handler &handler,
+		       std::string &buffer)
+  {
+    ++first; // consumes '['
+    if (!handler.on_start_list())
+      {
+	return false;
+      }
+    next_char(first, last);
+    if ((*first) != ']')
+      {
+	for (;;)
+	  {
+	    if (!event_read_value(first, last, handler, buffer))
+	      {
+		return false;
+	      }
+	    next_char(first, last);
+	    if ((*first) == ']')
+	      {
+		break;
+	      }
+	    if ((*first) != ',')
+	      {
+		error_invalid_input_non_json();
+	      }
+	    ++first;
+	  }
+      }
+    ++first; // consumes ']'
+    return handler.on_end_list();
+  }
+
+  template < typename InputIterator, typename Handler >
+  bool event_read_map(InputIterator &first,
+		      InputIterator &last,
+		      Handler &handler,
+		      std::string &buffer)
+  {
+    ++first; // consumes '{'
+    if (!handler.on_start_map())
+      {
+	return false;
+      }
+    next_char(first, last);
+    if ((*first) != '}')
+      {
+	for (;;)
+	  {
+	    if ((*first) != '"')
+	      {
+		error_invalid_input_non_json();
+	      }
+	    if (!handler.on_key(event_read_string(first, last, buffer)))
+	      {
+		return false;
+	      }
+	    next_char(first, last);
+	    if ((*first) != ':')
+	      {
+		error_invalid_input_non_json();
+	      }
+	    ++first;
+	    if (!event_read_value(first, last, handler, buffer))
+	      {
+		return false;
+	      }
+	    next_char(first, last);
+	    if ((*first) == '}')
+	      {
+		break;
+	      }
+	    if ((*first) != ',')
+	      {
+		error_invalid_input_non_json();
+	      }
+	    ++first;
+	    next_char(first, last);
+	  }
+      }
+    ++first; // consumes '}'
+    return handler.on_end_map();
+  }
+
+  template < typename InputIterator, typename Handler >
+  bool event_read_value(InputIterator &first,
+			InputIterator &last,
+			Handler &handler,
+			std::string &buffer)
+  {
+    next_char(first, last);
+    switch (*first)
+      {
+      case '[':
+	return event_read_list(first, last, handler, buffer);
+
+      case '{':
+	return event_read_map(first, last, handler, buffer);
+
+      case 't':
+	read_equals(first, last, "true");
+	return handler.on_bool(true);
+
+      case 'f':
+	read_equals(first, last, "false");
+	return handler.on_bool(false);
+
+      case 'n':
+	read_equals(first, last, "null");
+	return handler.on_null();
+
+      case '"':
+	return handler.on_string(event_read_string(first, last, buffer));
+
+      default:
+	return handler.on_number(event_read_number(first, last, buffer));
+      }
+  }
+
+  template < typename InputIterator, typename Handler >
+  bool parse_events(InputIterator &first, InputIterator &last, Handler &&handler)
+  {
+    std::string buffer;
+    return event_read_value(first, last, handler, buffer);
+  }
+
+  template < typename Handler >
+  bool parse_events(const char *str, Handler &&handler)
+  {
+    const char *first = str;
+    const char *last  = str + std::strlen(str);
+    return parse_events(first, last, handler);
+  }
+
+  template < typename Handler >
+  bool parse_events(const char_sequence &str, Handler &&handler)
+  {
+    const char *first = str.data();
+    const char *last  = str.data() + str.size();
+    return parse_events(first, last, handler);
+  }
+
+  template < typename Handler >
+  bool parse_events(const std::string &str, Handler &&handler)
+  {
+    const char *first = str.data();
+    const char *last  = str.data() + str.size();
+    return parse_events(first, last, handler);
+  }
+
+  template < typename Handler >
+  bool parse_events(std::istream &is, Handler &&handler)
+  {
+    std::istreambuf_iterator<char> first (is);
+    std::istreambuf_iterator<char> last;
+    return parse_events(first, last, handler);
+  }
+
+}
+
+#endif // JSON_EVENTS_HPP
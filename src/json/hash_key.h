@@ -57,6 +57,19 @@ namespace json
 
     hash_key(const char_sequence_type &s);
 
+    /**
+     * @brief Creates a key, 'borrowed' tells the hash map storing the key
+     * that it doesn't own the characters and must not release them.
+     */
+    hash_key(const char_sequence_type &s, bool borrowed);
+
+    /**
+     * @brief Creates a key whose hash was already computed, 'interned' tells
+     * that the characters come from a <em>json::basic_key_table</em> and are
+     * reference counted.
+     */
+    hash_key(const char_sequence_type &s, size_type h, bool borrowed, bool interned);
+
     hash_key &operator=(const char_sequence_type &s);
 
     size_type hash() const;
@@ -65,8 +78,14 @@ namespace json
 
     bool equals(const hash_key &k) const;
 
+    bool borrowed() const;
+
+    bool interned() const;
+
   protected:
     size_type _hash;
+    bool      _borrowed;
+    bool      _interned;
 
   };
 
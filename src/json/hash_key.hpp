@@ -55,7 +55,9 @@ namespace json
   hash_key<Char, Traits>::
   hash_key():
     char_sequence_type(),
-    _hash(hash_init)
+    _hash(hash_init),
+    _borrowed(false),
+    _interned(false)
   {
   }
 
@@ -63,7 +65,29 @@ namespace json
   hash_key<Char, Traits>::
   hash_key(const char_sequence_type &s):
     char_sequence_type(s),
-    _hash(json::hash(s))
+    _hash(json::hash(s)),
+    _borrowed(false),
+    _interned(false)
+  {
+  }
+
+  template < typename Char, typename Traits >
+  hash_key<Char, Traits>::
+  hash_key(const char_sequence_type &s, const bool borrowed):
+    char_sequence_type(s),
+    _hash(json::hash(s)),
+    _borrowed(borrowed),
+    _interned(false)
+  {
+  }
+
+  template < typename Char, typename Traits >
+  hash_key<Char, Traits>::
+  hash_key(const char_sequence_type &s, const size_type h, const bool borrowed, const bool interned):
+    char_sequence_type(s),
+    _hash(h),
+    _borrowed(borrowed),
+    _interned(interned)
   {
   }
 
@@ -74,6 +98,8 @@ namespace json
   {
     char_sequence_type::operator=(s);
     _hash = json::hash(s);
+    _borrowed = false;
+    _interned = false;
     return *this;
   }
 
@@ -98,9 +124,30 @@ namespace json
   hash_key<Char, Traits>::
   equals(const hash_key &k) const
   {
+    // Interned keys share their characters, comparing them is enough.
+    if ((this->data() == k.data()) && (this->size() == k.size()))
+      {
+	return true;
+      }
     return (hash() == k.hash()) && char_sequence_type::equals(k);
   }
 
+  template < typename Char, typename Traits >
+  bool
+  hash_key<Char, Traits>::
+  borrowed() const
+  {
+    return _borrowed;
+  }
+
+  template < typename Char, typename Traits >
+  bool
+  hash_key<Char, Traits>::
+  interned() const
+  {
+    return _interned;
+  }
+
   template < typename Char, typename Traits >
   bool operator==(const hash_key<Char, Traits> &k1,
 		  const hash_key<Char, Traits> &k2)
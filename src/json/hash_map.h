@@ -144,19 +144,37 @@ namespace json
 
     iterator emplace(const char_sequence_type &key, mapped_type &&value);
 
+    /**
+     * @brief Inserts a value without copying its key, the characters of the
+     * key must outlive the map (or the element if it is erased).
+     */
+    iterator emplace_borrowed(const char_sequence_type &key, mapped_type &&value);
+
+    /**
+     * @brief Inserts a value with a key returned by a key table, the map
+     * shares the characters of the key instead of copying them.
+     */
+    iterator emplace_interned(const key_type &key, mapped_type &&value);
+
     iterator begin();
 
     iterator end();
 
     iterator find(const char_sequence_type &key);
 
+    iterator find(const key_type &key);
+
     const_iterator begin() const;
 
     const_iterator end() const;
 
     const_iterator find(const char_sequence_type &key) const;
 
+    const_iterator find(const key_type &key) const;
+
   private:
+    static void release_key(const key_type &k, allocator_type &a);
+
     table_type _table;
 
   };
@@ -24,6 +24,7 @@
 #include <utility>
 #include "json/hash_table.hpp"
 #include "json/hash_key.hpp"
+#include "json/key_table.hpp"
 #include "json/hash_map.h"
 
 namespace json
@@ -45,7 +46,14 @@ namespace json
     {
       for(auto& i : map._table)
       {
-        insert(i.first, i.second);
+        if (i.first.interned())
+          {
+            emplace_interned(i.first, std::move(mapped_type(i.second)));
+          }
+        else
+          {
+            insert(i.first, i.second);
+          }
       }
     }
     catch(...)
@@ -129,8 +137,7 @@ namespace json
     allocator_type a = get_allocator();
 
     std::for_each(begin(), end(), [&](reference x) {
-	const key_type &k = x.first;
-	a.deallocate(const_cast<char_type*>(k.data()), k.size());
+	release_key(x.first, a);
       });
 
     _table.clear();
@@ -144,10 +151,25 @@ namespace json
     allocator_type a = get_allocator();
     key_type k = it->first;
     iterator next = _table.erase(it);
-    a.deallocate(const_cast<char_type*>(k.data()), k.size());
+    release_key(k, a);
     return next;
   }
 
+  template < typename T, typename Char, typename Traits, typename Allocator >
+  void
+  hash_map<T, Char, Traits, Allocator>::
+  release_key(const key_type &k, allocator_type &a)
+  {
+    if (k.interned())
+      {
+	basic_key_table<Char, Traits>::release(k);
+      }
+    else if (!k.borrowed())
+      {
+	a.deallocate(const_cast<char_type*>(k.data()), k.size() + 1);
+      }
+  }
+
   template < typename T, typename Char, typename Traits, typename Allocator >
   typename hash_map<T, Char, Traits, Allocator>::iterator
   hash_map<T, Char, Traits, Allocator>::
@@ -175,11 +197,32 @@ namespace json
       }
     catch (...)
       {
-	a.deallocate(s, n);
+	a.deallocate(s, n + 1);
 	throw;
       }
   }
 
+  template < typename T, typename Char, typename Traits, typename Allocator >
+  typename hash_map<T, Char, Traits, Allocator>::iterator
+  hash_map<T, Char, Traits, Allocator>::
+  emplace_borrowed(const char_sequence_type &key, mapped_type &&value)
+  {
+    key_type   k (key, true);
+    value_type x (k, std::move(value));
+    return _table.insert(std::move(x));
+  }
+
+  template < typename T, typename Char, typename Traits, typename Allocator >
+  typename hash_map<T, Char, Traits, Allocator>::iterator
+  hash_map<T, Char, Traits, Allocator>::
+  emplace_interned(const key_type &key, mapped_type &&value)
+  {
+    value_type x (key, std::move(value));
+    iterator it = _table.insert(std::move(x));
+    basic_key_table<Char, Traits>::retain(key);
+    return it;
+  }
+
   template < typename T, typename Char, typename Traits, typename Allocator >
   typename hash_map<T, Char, Traits, Allocator>::iterator
   hash_map<T, Char, Traits, Allocator>::
@@ -204,6 +247,14 @@ namespace json
     return _table.find(std::make_pair(key, mapped_type()));
   }
 
+  template < typename T, typename Char, typename Traits, typename Allocator >
+  typename hash_map<T, Char, Traits, Allocator>::iterator
+  hash_map<T, Char, Traits, Allocator>::
+  find(const key_type &key)
+  {
+    return _table.find(std::make_pair(key, mapped_type()));
+  }
+
   template < typename T, typename Char, typename Traits, typename Allocator >
   typename hash_map<T, Char, Traits, Allocator>::const_iterator
   hash_map<T, Char, Traits, Allocator>::
@@ -228,6 +279,14 @@ namespace json
     return _table.find(std::make_pair(key, mapped_type()));
   }
 
+  template < typename T, typename Char, typename Traits, typename Allocator >
+  typename hash_map<T, Char, Traits, Allocator>::const_iterator
+  hash_map<T, Char, Traits, Allocator>::
+  find(const key_type &key) const
+  {
+    return _table.find(std::make_pair(key, mapped_type()));
+  }
+
 }
 
 #endif // JSON_HASH_MAP_HPP
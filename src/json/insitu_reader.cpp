@@ -0,0 +1,43 @@
+/*
+ * Copyright 2012 Achille Roussel.
+ *
+ * This file is part of Libjson++.
+ *
+ * Libjson++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Libjson++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstring>
+#include "json/insitu_reader.hpp"
+#include "json/object.hpp"
+
+namespace json
+{
+
+  template char *read_insitu(char *, char *, object &);
+
+  object read_insitu(char *str)
+  {
+    object obj;
+    read_insitu(str, str + std::strlen(str), obj);
+    return obj;
+  }
+
+  object read_insitu(std::string &str)
+  {
+    object obj;
+    read_insitu(&str[0], &str[0] + str.size(), obj);
+    return obj;
+  }
+
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright 2012 Achille Roussel.
+ *
+ * This file is part of Libjson++.
+ *
+ * Libjson++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Libjson++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JSON_INSITU_READER_H
+#define JSON_INSITU_READER_H
+
+#include <string>
+#include "json/def.h"
+
+namespace json
+{
+
+  /**
+   * @brief Reads JSON from a mutable buffer without copying its strings.
+   *
+   * The in-situ reader works like <em>json::read_buffer</em> but the strings,
+   * numbers, booleans and map keys of the resulting object are borrowed from
+   * the buffer instead of being copied (see <em>basic_object::borrow</em>).
+   * Escape sequences are decoded in place, which is always possible because
+   * the decoded form of a string is never longer than its escaped form, this
+   * is why the buffer has to be writable.
+   *
+   * @param first A pointer to the first character of the buffer.
+   * @param last A pointer to the end of the buffer, <em>*last</em> must be
+   * readable and equal to '\\0'.
+   * @param obj The destination object to build from the parsed data.
+   *
+   * @return The function returns a pointer to the first character following
+   * the parsed JSON object.
+   *
+   * @note The buffer must outlive the object and all the objects moved from
+   * it, copies of the object own their strings and don't depend on it.
+   * <br/>
+   * The const <em>get_string</em> of a borrowed string throws a
+   * <em>json::error</em>, use <em>get_char_sequence</em> to read it in
+   * place, or the non-const <em>get_string</em> to copy it to the object.
+   */
+  template < typename Traits, typename Allocator >
+  char *read_insitu(char *first,
+		    char *last,
+		    basic_object<char, Traits, Allocator> &obj);
+
+  extern template char *read_insitu(char *, char *, object &);
+
+  /**
+   * @brief Reads a JSON object in situ from a c-string.
+   *
+   * @param str The string to read the JSON object from, it is modified by the
+   * function and must outlive the returned object.
+   *
+   * @return The function returns the newly created instance of <em>json::object</em>.
+   */
+  object read_insitu(char *str);
+
+  /**
+   * @brief Reads a JSON object in situ from an STL string.
+   *
+   * @param str The string to read the JSON object from, it is modified by the
+   * function and must neither be destroyed nor resized while the returned
+   * object is in use.
+   *
+   * @return The function returns the newly created instance of <em>json::object</em>.
+   */
+  object read_insitu(std::string &str);
+
+}
+
+#endif // JSON_INSITU_READER_H
@@ -0,0 +1,238 @@
+/*
+ * Copyright 2012 Achille Roussel.
+ *
+ * This file is part of Libjson++.
+ *
+ * Libjson++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Libjson++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JSON_INSITU_READER_HPP
+#define JSON_INSITU_READER_HPP
+
+#include <algorithm>
+#include "json/insitu_reader.h"
+#include "json/buffer_reader.hpp"
+
+namespace json
+{
+
+  // The buffer reader helpers work on const pointers, this moves a mutable
+  // pointer to the position they returned.
+  inline char *insitu_advance(char *first, const char *to)
+  {
+    return first + (to - first);
+  }
+
+  // Decodes the escape sequence at 'first' to 'out', both pointers are moved
+  // past what they consumed and produced.
+  inline void insitu_read_escape(char *&first, const char *last, char *&out)
+  {
+    ++first; // consumes '\\'
+    switch (const char c = escape_char(*first))
+      {
+      case 'u':
+	{
+	  // The UTF-8 encoding is never longer than the escape sequence.
+	  const char *it = first;
+	  const char *jt = last;
+	  out = encode_utf8(read_code_point(it, jt), out);
+	  first = insitu_advance(first, it);
+	}
+	break;
+      case 0:
+	if (first == last)
+	  {
+	    error_invalid_input_eof();
+	  }
+	error_invalid_input_non_json();
+      default:
+	*out++ = c;
+      }
+    ++first;
+  }
+
+  // Reads a string whose opening quote 'first' points to and returns a view
+  // on its characters, escaped strings are unescaped in place.
+  template < typename Traits >
+  basic_char_sequence<char, Traits> insitu_read_string(char *&first, const char *last)
+  {
+    typedef basic_char_sequence<char, Traits> char_sequence;
+
+    char *str = ++first; // consumes '"'
+    first = insitu_advance(first, scan_string(first, last));
+    if ((*first) == '"')
+      {
+	return char_sequence(str, (first++) - str);
+      }
+
+    char *out = first;
+    for (;;)
+      {
+	switch (*first)
+	  {
+	  case '"':
+	    ++first;
+	    return char_sequence(str, out - str);
+	  case '\\':
+	    insitu_read_escape(first, last, out);
+	    break;
+	  default:
+	    error_invalid_input_eof();
+	  }
+	char *run = first;
+	first = insitu_advance(first, scan_string(first, last));
+	out = std::copy(run, first, out);
+      }
+  }
+
+  template < typename Traits, typename Allocator >
+  void insitu_read_object(char *&first,
+			  const char *last,
+			  basic_object<char, Traits, Allocator> &obj);
+
+  template < typename Traits, typename Allocator >
+  void insitu_read_list(char *&first,
+			const char *last,
+			basic_object<char, Traits, Allocator> &obj)
+  {
+    obj.make_list();
+    auto &list = obj.get_list();
+    list.clear();
+
+    first = insitu_advance(first, buffer_next_char(first + 1, last)); // consumes '['
+    if ((*first) == ']')
+      {
+	++first;
+	return;
+      }
+
+    for (;;)
+      {
+	list.emplace_back(obj.get_allocator());
+	insitu_read_object(first, last, list.back());
+	first = insitu_advance(first, buffer_next_char(first, last));
+	switch (*first)
+	  {
+	  case ',': ++first; break;
+	  case ']': ++first; return;
+	  default:  error_invalid_input_non_json();
+	  }
+      }
+  }
+
+  template < typename Traits, typename Allocator >
+  void insitu_read_map(char *&first,
+		       const char *last,
+		       basic_object<char, Traits, Allocator> &obj)
+  {
+    typedef basic_object<char, Traits, Allocator> object;
+
+    obj.make_map();
+    auto &map = obj.get_map();
+    map.clear();
+
+    first = insitu_advance(first, buffer_next_char(first + 1, last)); // consumes '{'
+    if ((*first) == '}')
+      {
+	++first;
+	return;
+      }
+
+    for (;;)
+      {
+	if ((*first) != '"')
+	  {
+	    error_invalid_input_non_json();
+	  }
+	const auto k = insitu_read_string<Traits>(first, last);
+	first = insitu_advance(first, buffer_next_char(first, last));
+	if ((*first) != ':')
+	  {
+	    error_invalid_input_non_json();
+	  }
+	++first;
+
+	// Like with the other readers the last of duplicate keys wins, the
+	// key is only borrowed from the buffer when it is first inserted.
+	auto it = map.find(k);
+	if (it == map.end())
+	  {
+	    it = map.emplace_borrowed(k, object(obj.get_allocator()));
+	  }
+	insitu_read_object(first, last, it->second);
+
+	first = insitu_advance(first, buffer_next_char(first, last));
+	switch (*first)
+	  {
+	  case ',': first = insitu_advance(first, buffer_next_char(first + 1, last)); break;
+	  case '}': ++first; return;
+	  default:  error_invalid_input_non_json();
+	  }
+      }
+  }
+
+  template < typename Traits, typename Allocator >
+  void insitu_read_object(char *&first,
+			  const char *last,
+			  basic_object<char, Traits, Allocator> &obj)
+  {
+    typedef basic_char_sequence<char, Traits> char_sequence;
+
+    first = insitu_advance(first, buffer_next_char(first, last));
+    const char *value = first;
+    switch (*first)
+      {
+      case '[': insitu_read_list(first, last, obj); break;
+      case '{': insitu_read_map(first, last, obj);  break;
+
+      case 't':
+	buffer_read_equals(value, last, "true");
+	obj = true;
+	first = insitu_advance(first, value);
+	break;
+
+      case 'f':
+	buffer_read_equals(value, last, "false");
+	obj = false;
+	first = insitu_advance(first, value);
+	break;
+
+      case 'n':
+	buffer_read_equals(value, last, "null");
+	obj.make_null();
+	first = insitu_advance(first, value);
+	break;
+
+      case '"':
+	obj.borrow(insitu_read_string<Traits>(first, last));
+	break;
+
+      default:
+	first = insitu_advance(first, buffer_read_number(first));
+	obj.make_number(char_sequence(value, first - value));
+      }
+  }
+
+  template < typename Traits, typename Allocator >
+  char *read_insitu(char *first,
+		    char *last,
+		    basic_object<char, Traits, Allocator> &obj)
+  {
+    insitu_read_object(first, last, obj);
+    return first;
+  }
+
+}
+
+#endif // JSON_INSITU_READER_HPP
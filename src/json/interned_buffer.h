@@ -0,0 +1,110 @@
+/*
+ * Copyright 2012 Achille Roussel.
+ *
+ * This file is part of Libjson++.
+ *
+ * Libjson++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Libjson++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JSON_INTERNED_BUFFER_H
+#define JSON_INTERNED_BUFFER_H
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <new>
+#include "json/def.h"
+
+namespace json
+{
+
+  /**
+   * @brief Immutable and reference counted buffers of characters, shared by
+   * the keys of a <em>json::basic_key_table</em>.
+   * <br/>
+   * The characters of a buffer follow a header holding its reference count,
+   * the buffer is released with its last reference.
+   *
+   * @note This class is developped for internal purposes only and should not be
+   * used outside of the libjson++ implementation.
+   */
+  template < typename Char >
+  class interned_buffer
+  {
+
+    struct header
+    {
+      std::atomic<std::size_t> references;
+    };
+
+  public:
+
+    typedef std::size_t	size_type;
+
+    /**
+     * @brief Copies the 'n' characters at 's' to a new buffer with a single
+     * reference, a '\\0' follows them.
+     */
+    static Char *create(const Char *s, const size_type n)
+    {
+      header *h = std::allocator<header>().allocate(blocks(n));
+      new (h) header();
+      h->references.store(1, std::memory_order_relaxed);
+
+      Char *p = reinterpret_cast<Char *>(h + 1);
+      std::copy(s, s + n, p);
+      p[n] = Char();
+      return p;
+    }
+
+    static void retain(const Char *p)
+    {
+      header_of(p)->references.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Drops a reference on the buffer of 'n' characters at 'p'.
+     */
+    static void release(const Char *p, const size_type n)
+    {
+      header *h = header_of(p);
+      if (h->references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+	{
+	  h->~header();
+	  std::allocator<header>().deallocate(h, blocks(n));
+	}
+    }
+
+    static size_type references(const Char *p)
+    {
+      return header_of(p)->references.load(std::memory_order_acquire);
+    }
+
+  private:
+    // Buffers are allocated in blocks of the header size to keep it aligned.
+    static size_type blocks(const size_type n)
+    {
+      return 1 + (((n + 1) * sizeof(Char)) + sizeof(header) - 1) / sizeof(header);
+    }
+
+    static header *header_of(const Char *p)
+    {
+      return reinterpret_cast<header *>(const_cast<Char *>(p)) - 1;
+    }
+
+  };
+
+}
+
+#endif // JSON_INTERNED_BUFFER_H
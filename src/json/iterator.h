@@ -21,6 +21,7 @@
 #define JSON_ITERATOR_H
 
 #include <iterator>
+#include <type_traits>
 #include "json/def.h"
 #include "json/types.h"
 #include "json/iterator_body.h"
@@ -95,6 +96,14 @@ namespace json
    *     ++it;
    *   }
    * @endcode
+   * <br/>
+   * <br/>
+   * <strong>Iterating over a packed list:</strong>
+   * <br/>
+   * The members of a packed list of numbers (see
+   * <em>json::object::is_packed</em>) are not objects, a const iterator then
+   * yields them as values held by the iterator: the reference obtained by
+   * dereferencing it is only valid until it is incremented or destroyed.
    */
   template < typename Object,
 	     typename ListIterator,
@@ -150,6 +159,8 @@ namespace json
 
     iterator(const MapIterator &it, const size_type i, const size_type s);
 
+    iterator(const native_value *values, object_type type, size_type i, size_type s);
+
     iterator(const iterator &it);
 
     iterator(iterator &&it);
@@ -175,11 +186,15 @@ namespace json
     void swap(iterator &it);
 
   private:
+    typedef typename std::remove_const<Object>::type value_object;
+
     object_type		_type;
     body_type		_body;
     value_type          _cursor;
     size_type           _index;
     size_type           _size;
+    const native_value *_values; // the numbers of a packed list
+    value_object	_value;  // the current one
 
     void set_cursor();
 
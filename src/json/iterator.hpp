@@ -32,7 +32,9 @@ namespace json
     _body(),
     _cursor(),
     _index(0),
-    _size(0)
+    _size(0),
+    _values(nullptr),
+    _value()
   {
   }
 
@@ -43,7 +45,9 @@ namespace json
     _body(),
     _cursor(),
     _index(i),
-    _size(s)
+    _size(s),
+    _values(nullptr),
+    _value()
   {
     _body.create_list(it);
     set_cursor();
@@ -56,12 +60,30 @@ namespace json
     _body(),
     _cursor(),
     _index(i),
-    _size(s)
+    _size(s),
+    _values(nullptr),
+    _value()
   {
     _body.create_map(it);
     set_cursor();
   }
 
+  // The type of a packed iterator is the one of its numbers, its body isn't
+  // used.
+  template < typename Object, typename ListIterator, typename MapIterator >
+  iterator<Object, ListIterator, MapIterator>::
+  iterator(const native_value *values, const object_type type, const size_type i, const size_type s):
+    _type(type),
+    _body(),
+    _cursor(),
+    _index(i),
+    _size(s),
+    _values(values),
+    _value()
+  {
+    set_cursor();
+  }
+
   template < typename Object, typename ListIterator, typename MapIterator >
   iterator<Object, ListIterator, MapIterator>::
   iterator(const iterator &it):
@@ -69,7 +91,9 @@ namespace json
     _body(),
     _cursor(),
     _index(it._index),
-    _size(it._size)
+    _size(it._size),
+    _values(it._values),
+    _value()
   {
     _body.create_copy(it._type, it._body);
     set_cursor();
@@ -82,7 +106,9 @@ namespace json
     _body(),
     _cursor(),
     _index(it._index),
-    _size(it._size)
+    _size(it._size),
+    _values(it._values),
+    _value()
   {
     _body.create_move(it._type, std::move(it._body));
     set_cursor();
@@ -119,7 +145,10 @@ namespace json
   operator++()
   {
     ++_index;
-    _body.increment(_type);
+    if (_values == nullptr)
+      {
+	_body.increment(_type);
+      }
     set_cursor();
     return *this;
   }
@@ -139,6 +168,10 @@ namespace json
   iterator<Object, ListIterator, MapIterator>::
   operator==(const iterator &it) const
   {
+    if (_values != nullptr)
+      {
+	return (_values == it._values) && (_index == it._index);
+      }
     return (_type == it._type) && _body.equals(_type, it._body);
   }
 
@@ -147,7 +180,7 @@ namespace json
   iterator<Object, ListIterator, MapIterator>::
   operator!=(const iterator &it) const
   {
-    return (_type != it._type) || _body.not_equals(_type, it._body);
+    return !(*this == it);
   }
 
   template < typename Object, typename ListIterator, typename MapIterator >
@@ -186,6 +219,7 @@ namespace json
     std::swap(_type, it._type);
     std::swap(_index, it._index);
     std::swap(_size, it._size);
+    std::swap(_values, it._values);
 
     set_cursor();
     it.set_cursor();
@@ -203,6 +237,26 @@ namespace json
 	  {
 	  case type_list:   new (&_cursor) value_type (*(_body.list)); break;
 	  case type_map:    new (&_cursor) value_type ((*_body.map).first, (*_body.map).second); break;
+	  case type_integer:
+	    if (_values != nullptr)
+	      {
+		_value = _values[_index].integer;
+		new (&_cursor) value_type (_value);
+		break;
+	      }
+	    new (&_cursor) value_type ();
+	    break;
+	  case type_double:
+	    if (_values != nullptr)
+	      {
+		_value = _values[_index].real;
+		new (&_cursor) value_type (_value);
+		break;
+	      }
+	    new (&_cursor) value_type ();
+	    break;
+	  case type_boolean:
+	  case type_unsigned:
 	  case type_string:
 	  case type_null:   new (&_cursor) value_type (); break;
 	  }
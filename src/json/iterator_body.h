@@ -65,6 +65,10 @@ namespace json
 	{
 	case type_list:   create_list(body.list); break;
 	case type_map:    create_map(body.map);   break;
+	case type_boolean:
+	case type_integer:
+	case type_unsigned:
+	case type_double:
 	case type_string:                         break;
 	case type_null:                           break;
 	}
@@ -76,6 +80,10 @@ namespace json
 	{
 	case type_list:   create_list(std::move(body.list)); break;
 	case type_map:    create_map(std::move(body.map));   break;
+	case type_boolean:
+	case type_integer:
+	case type_unsigned:
+	case type_double:
 	case type_string:                                    break;
 	case type_null:                                      break;
 	}
@@ -97,6 +105,10 @@ namespace json
 	{
 	case type_list:   destroy_list(); break;
 	case type_map:    destroy_map();  break;
+	case type_boolean:
+	case type_integer:
+	case type_unsigned:
+	case type_double:
 	case type_string:                 break;
 	case type_null:                   break;
 	}
@@ -108,6 +120,10 @@ namespace json
 	{
 	case type_list:   ++list;   break;
 	case type_map:    ++map;    break;
+	case type_boolean:
+	case type_integer:
+	case type_unsigned:
+	case type_double:
 	case type_string:
 	case type_null: error_null_iterator_cannot_be_incremented();
 	}	
@@ -119,6 +135,10 @@ namespace json
 	{
 	case type_list:   return list == body.list;
 	case type_map:    return map == body.map;
+	case type_boolean:
+	case type_integer:
+	case type_unsigned:
+	case type_double:
 	case type_string: return true;
 	case type_null:   return true;
 	}
@@ -131,6 +151,10 @@ namespace json
 	{
 	case type_list:   return list != body.list;
 	case type_map:    return map != body.map;
+	case type_boolean:
+	case type_integer:
+	case type_unsigned:
+	case type_double:
 	case type_string: return false;
 	case type_null:   return false;
 	}
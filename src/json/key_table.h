@@ -0,0 +1,122 @@
+/*
+ * Copyright 2012 Achille Roussel.
+ *
+ * This file is part of Libjson++.
+ *
+ * Libjson++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Libjson++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JSON_KEY_TABLE_H
+#define JSON_KEY_TABLE_H
+
+#include <mutex>
+#include <unordered_set>
+#include "json/def.h"
+#include "json/hash_key.h"
+
+namespace json
+{
+
+  /**
+   * @brief A table of interned map keys.
+   *
+   * Documents made of many records usually repeat the same few keys, every
+   * map then holds its own copy of each of them. When reading through a key
+   * table, the keys are looked up in the table instead and all the maps share
+   * one immutable, reference counted buffer per distinct key, with a hash
+   * computed once. Two interned keys are equal only if they share their
+   * buffer, which saves comparing their characters when looking up a map
+   * with a key returned by <em>intern</em>.
+   * <br/>
+   * The buffers are released when neither the table nor any map refers to
+   * them anymore, a table can be destroyed before the objects built with it.
+   * A table may be kept for a single document or shared between documents of
+   * the same shape, a table created synchronized can be used by several
+   * threads at once:
+   * <pre>
+   * json::key_table keys;
+   * for (auto &record : records)
+   *   {
+   *     json::object obj (json::read(record, keys));
+   *     handle(obj);
+   *   }
+   * </pre>
+   */
+  template < typename Char, typename Traits >
+  class basic_key_table
+  {
+
+  public:
+
+    typedef Char					char_type;
+    typedef Traits					traits_type;
+    typedef hash_key<Char, Traits>			key_type;
+    typedef typename key_type::char_sequence_type	char_sequence_type;
+    typedef std::size_t					size_type;
+
+    /**
+     * @brief Creates an empty table, 'synchronized' makes the table safe to
+     * use from several threads at the cost of locking a mutex every time a
+     * key is interned.
+     */
+    explicit basic_key_table(bool synchronized = false);
+
+    ~basic_key_table();
+
+    /**
+     * @brief Returns the interned key equal to 's', adding it to the table if
+     * it isn't there yet. The key remains valid as long as the table isn't
+     * cleared or destroyed, a map inserting it takes its own reference.
+     */
+    key_type intern(const char_sequence_type &s);
+
+    /**
+     * @brief Releases the references of the table on the keys, the maps still
+     * using them keep them alive.
+     */
+    void clear();
+
+    size_type size() const;
+
+    bool empty() const;
+
+    bool synchronized() const;
+
+    /**
+     * @brief Takes a reference on the characters of an interned key.
+     */
+    static void retain(const key_type &k);
+
+    /**
+     * @brief Drops a reference on the characters of an interned key, which
+     * are released with the last one.
+     */
+    static void release(const key_type &k);
+
+  private:
+    basic_key_table(const basic_key_table &) = delete;
+
+    basic_key_table &operator=(const basic_key_table &) = delete;
+
+    std::unordered_set<key_type>	_keys;
+    mutable std::mutex			_mutex;
+    bool				_synchronized;
+
+  };
+
+  extern template class basic_key_table<char, char_traits>;
+
+}
+
+#endif // JSON_KEY_TABLE_H
@@ -0,0 +1,144 @@
+/*
+ * Copyright 2012 Achille Roussel.
+ *
+ * This file is part of Libjson++.
+ *
+ * Libjson++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Libjson++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JSON_KEY_TABLE_HPP
+#define JSON_KEY_TABLE_HPP
+
+#include "json/hash_key.hpp"
+#include "json/interned_buffer.h"
+#include "json/key_table.h"
+
+namespace json
+{
+
+  template < typename Char, typename Traits >
+  basic_key_table<Char, Traits>::
+  basic_key_table(const bool synchronized):
+    _keys(),
+    _mutex(),
+    _synchronized(synchronized)
+  {
+  }
+
+  template < typename Char, typename Traits >
+  basic_key_table<Char, Traits>::
+  ~basic_key_table()
+  {
+    clear();
+  }
+
+  template < typename Char, typename Traits >
+  typename basic_key_table<Char, Traits>::key_type
+  basic_key_table<Char, Traits>::
+  intern(const char_sequence_type &s)
+  {
+    const key_type k (s);
+    std::unique_lock<std::mutex> lock (_mutex, std::defer_lock);
+    if (_synchronized)
+      {
+	lock.lock();
+      }
+
+    const auto it = _keys.find(k);
+    if (it != _keys.end())
+      {
+	return *it;
+      }
+
+    const size_type n = s.size();
+    const Char *p = interned_buffer<Char>::create(s.data(), n);
+    const key_type interned (char_sequence_type(p, n), k.hash(), false, true);
+    try
+      {
+	_keys.insert(interned);
+      }
+    catch (...)
+      {
+	interned_buffer<Char>::release(p, n);
+	throw;
+      }
+    return interned;
+  }
+
+  template < typename Char, typename Traits >
+  void
+  basic_key_table<Char, Traits>::
+  clear()
+  {
+    std::unique_lock<std::mutex> lock (_mutex, std::defer_lock);
+    if (_synchronized)
+      {
+	lock.lock();
+      }
+
+    for (const auto &k : _keys)
+      {
+	release(k);
+      }
+    _keys.clear();
+  }
+
+  template < typename Char, typename Traits >
+  typename basic_key_table<Char, Traits>::size_type
+  basic_key_table<Char, Traits>::
+  size() const
+  {
+    std::unique_lock<std::mutex> lock (_mutex, std::defer_lock);
+    if (_synchronized)
+      {
+	lock.lock();
+      }
+    return _keys.size();
+  }
+
+  template < typename Char, typename Traits >
+  bool
+  basic_key_table<Char, Traits>::
+  empty() const
+  {
+    return size() == 0;
+  }
+
+  template < typename Char, typename Traits >
+  bool
+  basic_key_table<Char, Traits>::
+  synchronized() const
+  {
+    return _synchronized;
+  }
+
+  template < typename Char, typename Traits >
+  void
+  basic_key_table<Char, Traits>::
+  retain(const key_type &k)
+  {
+    interned_buffer<Char>::retain(k.data());
+  }
+
+  template < typename Char, typename Traits >
+  void
+  basic_key_table<Char, Traits>::
+  release(const key_type &k)
+  {
+    interned_buffer<Char>::release(k.data(), k.size());
+  }
+
+}
+
+#endif // JSON_KEY_TABLE_HPP
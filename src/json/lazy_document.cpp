@@ -0,0 +1,421 @@
+/*
+ * Copyright 2012 Achille Roussel.
+ *
+ * This file is part of Libjson++.
+ *
+ * Libjson++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Libjson++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstring>
+#include <deque>
+#include <sstream>
+#include "json/error.h"
+#include "json/events.hpp"
+#include "json/lazy_document.h"
+#include "json/structural_index.hpp"
+#include "json/object.hpp"
+
+namespace json
+{
+
+  [[noreturn]]
+  void error_lazy_invalid_type(const object_type expected,
+			       const object_type type,
+			       const char *function)
+  {
+    std::ostringstream s;
+    s << function << ": expected " << expected << " but the value is a " << type;
+    throw error(s.str());
+  }
+
+  [[noreturn]]
+  void error_lazy_no_such_key(const char_sequence &key)
+  {
+    std::ostringstream s;
+    s << "json::lazy_value::operator[key]: no such key '";
+    s.write(key.data(), key.size());
+    s << '\'';
+    throw error(s.str());
+  }
+
+  struct lazy_document_state
+  {
+    typedef structural_index::offset_type offset_type;
+    typedef lazy_value::size_type         size_type;
+
+    std::string				input;
+    structural_index			index;
+
+    // For every '[' and '{' of the index, the position in the index of the
+    // matching ']' or '}', so that containers can be skipped in constant time.
+    std::vector<offset_type>		closers;
+
+    // Unescaped copies of the keys which contain escape sequences, a deque
+    // never moves its elements so the keys can be referenced.
+    mutable std::deque<std::string>	keys;
+
+    const char *at(const size_type token) const
+    {
+      return input.data() + index[token];
+    }
+
+    // Returns the position in the index of the token following the value
+    // starting at 'token'.
+    size_type skip(const size_type token) const
+    {
+      switch (*at(token))
+	{
+	case '[':
+	case '{': return closers[token] + 1;
+	default:  return token + 1;
+	}
+    }
+
+    char_sequence key(const size_type token) const
+    {
+      const char *first = at(token);
+      std::string buffer;
+      const char_sequence k = buffer_read_key(first, input.data() + input.size(), buffer);
+      if (k.data() != buffer.data())
+	{
+	  return k;
+	}
+      keys.push_back(std::move(buffer));
+      return char_sequence(keys.back());
+    }
+  };
+
+  lazy_value::lazy_value(const lazy_document_state *state,
+			 const size_type token,
+			 const char_sequence &key):
+    _state(state),
+    _token(token),
+    _key(key),
+    _expanded(false),
+    _members(),
+    _object()
+  {
+  }
+
+  object_type lazy_value::type() const
+  {
+    switch (*_state->at(_token))
+      {
+      case '[': return type_list;
+      case '{': return type_map;
+      case 'n': return type_null;
+      case '"': return type_string;
+      case 't':
+      case 'f': return type_boolean;
+      default:  return get().type();
+      }
+  }
+
+  lazy_value::size_type lazy_value::size() const
+  {
+    expand();
+    return _members.size();
+  }
+
+  bool lazy_value::empty() const
+  {
+    return size() == 0;
+  }
+
+  const char_sequence &lazy_value::key() const
+  {
+    return _key;
+  }
+
+  const lazy_value &lazy_value::operator[](const size_type index) const
+  {
+    if (type() != type_list)
+      {
+	error_lazy_invalid_type(type_list, type(), "json::lazy_value::operator[index]");
+      }
+    expand();
+    return _members.at(index);
+  }
+
+  const lazy_value &lazy_value::operator[](const char_sequence &key) const
+  {
+    const lazy_value *value = find(key);
+    if (value == nullptr)
+      {
+	error_lazy_no_such_key(key);
+      }
+    return *value;
+  }
+
+  const lazy_value *lazy_value::find(const char_sequence &key) const
+  {
+    if (type() != type_map)
+      {
+	error_lazy_invalid_type(type_map, type(), "json::lazy_value::operator[key]");
+      }
+    expand();
+    for (auto it = _members.rbegin(); it != _members.rend(); ++it)
+      {
+	if (it->_key == key)
+	  {
+	    return &(*it);
+	  }
+      }
+    return nullptr;
+  }
+
+  lazy_value::const_iterator lazy_value::begin() const
+  {
+    expand();
+    return _members.begin();
+  }
+
+  lazy_value::const_iterator lazy_value::end() const
+  {
+    expand();
+    return _members.end();
+  }
+
+  const object &lazy_value::get() const
+  {
+    if (!_object)
+      {
+	const std::string &input = _state->input;
+	std::unique_ptr<object> obj (new object);
+	read_buffer(_state->at(_token), input.data() + input.size(), *obj);
+	_object = std::move(obj);
+      }
+    return *_object;
+  }
+
+  const std::string &lazy_value::get_string() const
+  {
+    // The object is owned by the value, a string interned while it was read
+    // is converted through the non-const accessor.
+    get();
+    return _object->get_string();
+  }
+
+  // The input has been validated when the document was loaded, the members
+  // are found by walking the index without checking the syntax again.
+  void lazy_value::expand() const
+  {
+    if (_expanded)
+      {
+	return;
+      }
+
+    const char c = *_state->at(_token);
+    if ((c == '[') || (c == '{'))
+      {
+	const size_type last = _state->closers[_token];
+	size_type token = _token + 1;
+	while (token != last)
+	  {
+	    if (c == '[')
+	      {
+		_members.push_back(lazy_value(_state, token, char_sequence()));
+	      }
+	    else
+	      {
+		const char_sequence k = _state->key(token);
+		token += 2; // skips the key and ':'
+		_members.push_back(lazy_value(_state, token, k));
+	      }
+	    token = _state->skip(token);
+	    if (token != last)
+	      {
+		++token; // skips ','
+	      }
+	  }
+      }
+    _expanded = true;
+  }
+
+  lazy_document::lazy_document():
+    _state(),
+    _root()
+  {
+    load(std::string("null"));
+  }
+
+  lazy_document::lazy_document(const char *str):
+    _state(),
+    _root()
+  {
+    load(std::string(str, std::strlen(str)));
+  }
+
+  lazy_document::lazy_document(const char_sequence &str):
+    _state(),
+    _root()
+  {
+    load(std::string(str.data(), str.size()));
+  }
+
+  lazy_document::lazy_document(std::string &&str):
+    _state(),
+    _root()
+  {
+    load(std::move(str));
+  }
+
+  lazy_document::lazy_document(lazy_document &&doc):
+    _state(std::move(doc._state)),
+    _root(std::move(doc._root))
+  {
+  }
+
+  lazy_document &lazy_document::operator=(lazy_document &&doc)
+  {
+    _state = std::move(doc._state);
+    _root = std::move(doc._root);
+    return *this;
+  }
+
+  lazy_document::~lazy_document()
+  {
+  }
+
+  void lazy_document::load(std::string &&str)
+  {
+    typedef structural_index::offset_type offset_type;
+
+    std::unique_ptr<lazy_document_state> state (new lazy_document_state);
+    state->input = std::move(str);
+
+    // Validates the whole input once, no object is built.
+    const char *first = state->input.c_str();
+    const char *last  = first + state->input.size();
+    parse_events(first, last, event_handler());
+
+    state->index.build(state->input.data(), last);
+
+    std::vector<offset_type> opened;
+    state->closers.resize(state->index.size());
+    for (offset_type i = 0; i != state->index.size(); ++i)
+      {
+	switch (*state->at(i))
+	  {
+	  case '[':
+	  case '{':
+	    opened.push_back(i);
+	    break;
+	  case ']':
+	  case '}':
+	    state->closers[opened.back()] = i;
+	    opened.pop_back();
+	    break;
+	  }
+	if (opened.empty())
+	  {
+	    break; // end of the top-level value
+	  }
+      }
+
+    _root.reset(new lazy_value(state.get(), 0, char_sequence()));
+    _state = std::move(state);
+  }
+
+  const lazy_value &lazy_document::root() const
+  {
+    return *_root;
+  }
+
+  object_type lazy_document::type() const
+  {
+    return _root->type();
+  }
+
+  lazy_document::size_type lazy_document::size() const
+  {
+    return _root->size();
+  }
+
+  bool lazy_document::empty() const
+  {
+    return _root->empty();
+  }
+
+  const lazy_value &lazy_document::operator[](const size_type index) const
+  {
+    return (*_root)[index];
+  }
+
+  const lazy_value &lazy_document::operator[](const char_sequence &key) const
+  {
+    return (*_root)[key];
+  }
+
+  const lazy_value *lazy_document::find(const char_sequence &key) const
+  {
+    return _root->find(key);
+  }
+
+  lazy_document::const_iterator lazy_document::begin() const
+  {
+    return _root->begin();
+  }
+
+  lazy_document::const_iterator lazy_document::end() const
+  {
+    return _root->end();
+  }
+
+  const object &lazy_document::get() const
+  {
+    return _root->get();
+  }
+
+  int stoi(const lazy_value &value)
+  {
+    return stoi(value.get());
+  }
+
+  long stol(const lazy_value &value)
+  {
+    return stol(value.get());
+  }
+
+  long long stoll(const lazy_value &value)
+  {
+    return stoll(value.get());
+  }
+
+  unsigned long stoul(const lazy_value &value)
+  {
+    return stoul(value.get());
+  }
+
+  unsigned long long stoull(const lazy_value &value)
+  {
+    return stoull(value.get());
+  }
+
+  float stof(const lazy_value &value)
+  {
+    return stof(value.get());
+  }
+
+  double stod(const lazy_value &value)
+  {
+    return stod(value.get());
+  }
+
+  long double stold(const lazy_value &value)
+  {
+    return stold(value.get());
+  }
+
+}
@@ -0,0 +1,247 @@
+/*
+ * Copyright 2012 Achille Roussel.
+ *
+ * This file is part of Libjson++.
+ *
+ * Libjson++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Libjson++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JSON_LAZY_DOCUMENT_H
+#define JSON_LAZY_DOCUMENT_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "json/def.h"
+#include "json/object.h"
+
+namespace json
+{
+
+  struct lazy_document_state;
+
+  /**
+   * @brief A value of a <em>json::lazy_document</em>.
+   *
+   * A lazy value only knows where it starts in the input of its document.
+   * The members of a list or a map are listed the first time they are
+   * accessed through <em>operator[]</em>, <em>size</em> or an iteration,
+   * strings and numbers are parsed the first time they are converted.
+   * Members that are never accessed are never parsed.
+   * <br/>
+   * The values are owned by the document and remain valid as long as it
+   * exists, they are not thread-safe since accessing them modifies the cache
+   * of parsed values.
+   */
+  class lazy_value
+  {
+
+  public:
+
+    typedef std::size_t					size_type;
+    typedef std::vector<lazy_value>::const_iterator	const_iterator;
+
+    object_type type() const;
+
+    /**
+     * @brief Returns the number of members of a list or a map, zero for the
+     * other types.
+     */
+    size_type size() const;
+
+    bool empty() const;
+
+    /**
+     * @brief Returns the key of a member of a map, an empty sequence for the
+     * other values.
+     */
+    const char_sequence &key() const;
+
+    const lazy_value &operator[](size_type index) const;
+
+    /**
+     * @brief Returns the value of a member of a map, if the key appears more
+     * than once the last value is returned (like with <em>json::read</em>).
+     *
+     * @note The function throws a <em>json::error</em> if the key doesn't
+     * exist, see <em>find</em> to test for optional members.
+     */
+    const lazy_value &operator[](const char_sequence &key) const;
+
+    /**
+     * @brief Returns a pointer to the value of a member of a map, or a null
+     * pointer if the key doesn't exist.
+     */
+    const lazy_value *find(const char_sequence &key) const;
+
+    /**
+     * @brief Iterates over the members of a list or a map, the keys of the
+     * members of a map are available through their <em>key</em> function.
+     */
+    const_iterator begin() const;
+
+    const_iterator end() const;
+
+    /**
+     * @brief Returns the value parsed as a <em>json::object</em>.
+     *
+     * The value and all its members are parsed on the first call, the
+     * following calls return the same object.
+     */
+    const object &get() const;
+
+    const std::string &get_string() const;
+
+  private:
+    friend class lazy_document;
+
+    lazy_value(const lazy_document_state *state,
+	       size_type token,
+	       const char_sequence &key);
+
+    void expand() const;
+
+    const lazy_document_state *		_state;
+    size_type				_token;
+    char_sequence			_key;
+    mutable bool			_expanded;
+    mutable std::vector<lazy_value>	_members;
+    mutable std::unique_ptr<object>	_object;
+
+  };
+
+  /**
+   * @brief A JSON document parsed on demand.
+   *
+   * The input is copied, validated and indexed once (see
+   * <em>json::structural_index</em>) when the document is constructed, the
+   * values are then only parsed as they are accessed. This is much cheaper
+   * than <em>json::read</em> when only a few members of a large document are
+   * used, since the lists and maps that aren't accessed are never built.
+   * <br/>
+   * The document mirrors the interface of <em>json::object</em> for reading:
+   * <pre>
+   * json::lazy_document doc (payload);
+   * int id = json::stoi(doc["user"]["id"]);
+   * </pre>
+   *
+   * @note The constructors throw a <em>json::error</em> if the input is not
+   * valid JSON, accessing a value later never fails because of the input.
+   */
+  class lazy_document
+  {
+
+  public:
+
+    typedef lazy_value::size_type	size_type;
+    typedef lazy_value::const_iterator	const_iterator;
+
+    lazy_document();
+
+    explicit lazy_document(const char *str);
+
+    explicit lazy_document(const char_sequence &str);
+
+    explicit lazy_document(std::string &&str);
+
+    lazy_document(lazy_document &&doc);
+
+    lazy_document &operator=(lazy_document &&doc);
+
+    ~lazy_document();
+
+    /**
+     * @brief Returns the top-level value of the document.
+     */
+    const lazy_value &root() const;
+
+    object_type type() const;
+
+    size_type size() const;
+
+    bool empty() const;
+
+    const lazy_value &operator[](size_type index) const;
+
+    const lazy_value &operator[](const char_sequence &key) const;
+
+    const lazy_value *find(const char_sequence &key) const;
+
+    const_iterator begin() const;
+
+    const_iterator end() const;
+
+    const object &get() const;
+
+  private:
+    lazy_document(const lazy_document &) = delete;
+
+    lazy_document &operator=(const lazy_document &) = delete;
+
+    void load(std::string &&str);
+
+    std::unique_ptr<lazy_document_state>	_state;
+    std::unique_ptr<lazy_value>			_root;
+
+  };
+
+  inline bool is_string(const lazy_value &value)
+  {
+    return value.type() == type_string;
+  }
+
+  inline bool is_list(const lazy_value &value)
+  {
+    return value.type() == type_list;
+  }
+
+  inline bool is_map(const lazy_value &value)
+  {
+    return value.type() == type_map;
+  }
+
+  inline bool is_null(const lazy_value &value)
+  {
+    return value.type() == type_null;
+  }
+
+  inline bool is_true(const lazy_value &value)
+  {
+    return is_true(value.get());
+  }
+
+  inline bool is_false(const lazy_value &value)
+  {
+    return is_false(value.get());
+  }
+
+  int stoi(const lazy_value &value);
+
+  long stol(const lazy_value &value);
+
+  long long stoll(const lazy_value &value);
+
+  unsigned long stoul(const lazy_value &value);
+
+  unsigned long long stoull(const lazy_value &value);
+
+  float stof(const lazy_value &value);
+
+  double stod(const lazy_value &value);
+
+  long double stold(const lazy_value &value);
+
+}
+
+#endif // JSON_LAZY_DOCUMENT_H
@@ -0,0 +1,209 @@
+/*
+ * Copyright 2012 Achille Roussel.
+ *
+ * This file is part of Libjson++.
+ *
+ * Libjson++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Libjson++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include "json/error.h"
+#include "json/mapped_file.h"
+#include "json/buffer_reader.hpp"
+#include "json/object.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#  define JSON_HAS_MMAP 1
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#else
+#  define JSON_HAS_MMAP 0
+#  include <fstream>
+#endif
+
+namespace json
+{
+
+  [[noreturn]]
+  void error_mapping_file(const char *path)
+  {
+    throw error(std::string("json::map_file: cannot map '") + path + "': " + std::strerror(errno));
+  }
+
+#if JSON_HAS_MMAP
+
+  mapped_file::mapped_file(const char *path):
+    _data(0),
+    _size(0),
+    _mapping_size(0)
+  {
+    const int fd = ::open(path, O_RDONLY);
+    struct stat st;
+
+    if (fd < 0)
+      {
+	error_mapping_file(path);
+      }
+    if (::fstat(fd, &st) != 0)
+      {
+	::close(fd);
+	error_mapping_file(path);
+      }
+
+    // One more page than the file needs is reserved so there is always at
+    // least one '\0' after the content, even when the file size is a multiple
+    // of the page size. The file is then mapped over the start of the region.
+    const size_type page = ::sysconf(_SC_PAGESIZE);
+    const size_type size = st.st_size;
+    const size_type mapping_size = ((size / page) + 1) * page;
+
+    void *region = ::mmap(0, mapping_size, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (region == MAP_FAILED)
+      {
+	::close(fd);
+	error_mapping_file(path);
+      }
+    if ((size != 0) && (::mmap(region, size, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED))
+      {
+	::munmap(region, mapping_size);
+	::close(fd);
+	error_mapping_file(path);
+      }
+    ::close(fd);
+    if (size != 0)
+      {
+	::madvise(region, size, MADV_SEQUENTIAL);
+      }
+
+    _data = static_cast<char *>(region);
+    _size = size;
+    _mapping_size = mapping_size;
+  }
+
+  void mapped_file::release()
+  {
+    if (_data != 0)
+      {
+	::munmap(_data, _mapping_size);
+      }
+  }
+
+#else
+
+  mapped_file::mapped_file(const char *path):
+    _data(0),
+    _size(0),
+    _mapping_size(0)
+  {
+    std::ifstream file (path, std::ios::in | std::ios::binary);
+    if (!file)
+      {
+	error_mapping_file(path);
+      }
+    file.seekg(0, std::ios::end);
+    const size_type size = file.tellg();
+    file.seekg(0, std::ios::beg);
+
+    std::unique_ptr<char[]> data (new char[size + 1]);
+    if (!file.read(data.get(), size))
+      {
+	error_mapping_file(path);
+      }
+    data[size] = '\0';
+
+    _data = data.release();
+    _size = size;
+    _mapping_size = size + 1;
+  }
+
+  void mapped_file::release()
+  {
+    delete [] _data;
+  }
+
+#endif
+
+  mapped_file::mapped_file(mapped_file &&file):
+    _data(file._data),
+    _size(file._size),
+    _mapping_size(file._mapping_size)
+  {
+    file._data = 0;
+    file._size = 0;
+    file._mapping_size = 0;
+  }
+
+  mapped_file::~mapped_file()
+  {
+    release();
+  }
+
+  mapped_file &mapped_file::operator=(mapped_file &&file)
+  {
+    if (this != &file)
+      {
+	release();
+	_data = file._data;
+	_size = file._size;
+	_mapping_size = file._mapping_size;
+	file._data = 0;
+	file._size = 0;
+	file._mapping_size = 0;
+      }
+    return *this;
+  }
+
+  const char *mapped_file::data() const
+  {
+    return _data;
+  }
+
+  const char *mapped_file::begin() const
+  {
+    return _data;
+  }
+
+  const char *mapped_file::end() const
+  {
+    return _data + _size;
+  }
+
+  mapped_file::size_type mapped_file::size() const
+  {
+    return _size;
+  }
+
+  bool mapped_file::empty() const
+  {
+    return _size == 0;
+  }
+
+  mapped_file map_file(const std::string &path)
+  {
+    return mapped_file(path.c_str());
+  }
+
+  object read_file(const std::string &path)
+  {
+    const mapped_file file (path.c_str());
+    object obj;
+    read_buffer(file.begin(), file.end(), obj);
+    return obj;
+  }
+
+}
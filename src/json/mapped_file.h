@@ -0,0 +1,106 @@
+/*
+ * Copyright 2012 Achille Roussel.
+ *
+ * This file is part of Libjson++.
+ *
+ * Libjson++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Libjson++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JSON_MAPPED_FILE_H
+#define JSON_MAPPED_FILE_H
+
+#include <string>
+#include "json/def.h"
+
+namespace json
+{
+
+  /**
+   * @brief A read-only view on the content of a file.
+   *
+   * On POSIX systems the file is mapped in memory with <em>mmap</em> and the
+   * kernel is advised that it will be read sequentially, elsewhere it is read
+   * in a single pass into a buffer.
+   * <br/>
+   * The content is always followed by a readable '\\0' character, it can then
+   * be parsed in place by <em>json::read_buffer</em>.
+   */
+  class mapped_file
+  {
+
+  public:
+
+    typedef std::size_t		size_type;
+
+    /**
+     * @brief Maps the file at the given path.
+     *
+     * @note The constructor throws a <em>json::error</em> if the file cannot be
+     * opened or mapped.
+     */
+    explicit mapped_file(const char *path);
+
+    mapped_file(mapped_file &&file);
+
+    ~mapped_file();
+
+    mapped_file &operator=(mapped_file &&file);
+
+    const char *data() const;
+
+    const char *begin() const;
+
+    const char *end() const;
+
+    size_type size() const;
+
+    bool empty() const;
+
+  private:
+    mapped_file(const mapped_file &) = delete;
+    mapped_file &operator=(const mapped_file &) = delete;
+
+    void release();
+
+    char	*_data;
+    size_type	_size;
+    size_type	_mapping_size;
+
+  };
+
+  /**
+   * @brief Maps a file in memory.
+   *
+   * @param path The path of the file to map.
+   *
+   * @return The function returns the <em>json::mapped_file</em> holding the
+   * file content.
+   */
+  mapped_file map_file(const std::string &path);
+
+  /**
+   * @brief Reads a JSON object from a file.
+   *
+   * The file is mapped in memory and parsed directly from the mapping with
+   * <em>json::read_buffer</em>, without going through a stream.
+   *
+   * @param path The path of the file to read the JSON object from.
+   *
+   * @return The function returns the newly created instance of <em>json::object</em>.
+   */
+  object read_file(const std::string &path);
+
+}
+
+#endif // JSON_MAPPED_FILE_H
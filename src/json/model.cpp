@@ -43,4 +43,9 @@ namespace json
     throw error("json::model<?>: trying to load an object from a JSON object which is not a dictionnary");
   }
 
+  void error_loading_integer()
+  {
+    throw error("json::model<?>: trying to load an integer which doesn't fit in the field");
+  }
+
 }
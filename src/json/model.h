@@ -60,61 +60,86 @@ namespace json
 
   void error_loading_object();
 
+  void error_loading_integer();
+
+  // Narrows an integer loaded from a JSON object to the type of a field.
+  template < typename Integer, typename Wide >
+  inline Integer narrow_integer(const Wide x)
+  {
+    if (static_cast<Wide>(static_cast<Integer>(x)) != x)
+      {
+        error_loading_integer();
+      }
+    return static_cast<Integer>(x);
+  }
+
   // Overloading of the '<<' operator to provide a way to transform a JSON
   // object into C++ types.
 
   template < typename Char, typename Traits, typename Allocator >
   inline void operator<<(short &field, const basic_object<Char, Traits, Allocator> &obj)
   {
-    field = std::stoi(obj);
+    field = narrow_integer<short>(json::stol(obj));
   }
 
   template < typename Char, typename Traits, typename Allocator >
   inline void operator<<(unsigned short &field, const basic_object<Char, Traits, Allocator> &obj)
   {
-    field = std::stoul(obj);
+    field = narrow_integer<unsigned short>(json::stoul(obj));
   }
 
   template < typename Char, typename Traits, typename Allocator >
   inline void operator<<(int &field, const basic_object<Char, Traits, Allocator> &obj)
   {
-    field = std::stoi(obj);
+    field = json::stoi(obj);
   }
 
   template < typename Char, typename Traits, typename Allocator >
   inline void operator<<(unsigned int &field, const basic_object<Char, Traits, Allocator> &obj)
   {
-    field = std::stoul(obj);
+    field = narrow_integer<unsigned int>(json::stoul(obj));
   }
 
   template < typename Char, typename Traits, typename Allocator >
   inline void operator<<(long &field, const basic_object<Char, Traits, Allocator> &obj)
   {
-    field = std::stol(obj);
+    field = json::stol(obj);
   }
 
   template < typename Char, typename Traits, typename Allocator >
   inline void operator<<(unsigned long &field, const basic_object<Char, Traits, Allocator> &obj)
   {
-    field = std::stoul(obj);
+    field = json::stoul(obj);
+  }
+
+  template < typename Char, typename Traits, typename Allocator >
+  inline void operator<<(long long &field, const basic_object<Char, Traits, Allocator> &obj)
+  {
+    field = json::stoll(obj);
+  }
+
+  template < typename Char, typename Traits, typename Allocator >
+  inline void operator<<(unsigned long long &field, const basic_object<Char, Traits, Allocator> &obj)
+  {
+    field = json::stoull(obj);
   }
 
   template < typename Char, typename Traits, typename Allocator >
   inline void operator<<(float &field, const basic_object<Char, Traits, Allocator> &obj)
   {
-    field = std::stof(obj);
+    field = json::stof(obj);
   }
 
   template < typename Char, typename Traits, typename Allocator >
   inline void operator<<(double &field, const basic_object<Char, Traits, Allocator> &obj)
   {
-    field = std::stod(obj);
+    field = json::stod(obj);
   }
 
   template < typename Char, typename Traits, typename Allocator >
   inline void operator<<(long double &field, const basic_object<Char, Traits, Allocator> &obj)
   {
-    field = std::stold(obj);
+    field = json::stold(obj);
   }
 
   template < typename Char, typename Traits, typename Allocator >
@@ -138,7 +163,8 @@ namespace json
   inline void operator<<(std::basic_string<Char, Traits, Allocator1> &field,
                          const basic_object<Char, Traits, Allocator2> &obj)
   {
-    field = obj;
+    const auto s = obj.get_char_sequence();
+    field.assign(s.data(), s.size());
   }
 
   template < typename Char, typename Traits, typename Allocator1, typename Allocator2 >
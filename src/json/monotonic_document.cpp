@@ -0,0 +1,119 @@
+/*
+ * Copyright 2012 Achille Roussel.
+ *
+ * This file is part of Libjson++.
+ *
+ * Libjson++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Libjson++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstring>
+#include <ostream>
+#include "json/buffer_reader.hpp"
+#include "json/monotonic_document.h"
+#include "json/object.hpp"
+#include "json/writer.hpp"
+
+namespace json
+{
+
+  template class basic_object<char, std::char_traits<char>, arena_allocator<char> >;
+
+  template void monotonic_object::copy_body(const monotonic_object &);
+  template void monotonic_object::copy_body(const object &);
+  template void object::copy_body(const monotonic_object &);
+
+  template class iterator<monotonic_object,
+			  monotonic_object::object_list::iterator,
+			  monotonic_object::object_map::iterator>;
+
+  template class iterator<const monotonic_object,
+			  monotonic_object::object_list::const_iterator,
+			  monotonic_object::object_map::const_iterator>;
+
+  template const char *read_buffer(const char *, const char *, monotonic_object &);
+
+  template void write_object(std::ostream &, const monotonic_object &);
+
+  template bool operator==(const monotonic_object &, const monotonic_object &);
+  template bool operator!=(const monotonic_object &, const monotonic_object &);
+  template bool operator==(const monotonic_object &, const object &);
+  template bool operator!=(const monotonic_object &, const object &);
+  template bool operator==(const monotonic_object &, const char *);
+  template bool operator!=(const monotonic_object &, const char *);
+
+  monotonic_document::monotonic_document(const arena::size_type chunk_size):
+    _arena(chunk_size),
+    _root(nullptr)
+  {
+    clear();
+  }
+
+  monotonic_document::monotonic_document(const char *str):
+    _arena(),
+    _root(nullptr)
+  {
+    load(str, str + std::strlen(str));
+  }
+
+  monotonic_document::monotonic_document(const char_sequence &str):
+    _arena(),
+    _root(nullptr)
+  {
+    // The buffer reader needs a '\0' after the input.
+    const std::string copy (str.data(), str.size());
+    load(copy.c_str(), copy.c_str() + copy.size());
+  }
+
+  monotonic_document::monotonic_document(const std::string &str):
+    _arena(),
+    _root(nullptr)
+  {
+    load(str.c_str(), str.c_str() + str.size());
+  }
+
+  // All the memory of the values is in the arena, their destructors would
+  // only walk the tree to release it piece by piece so they are not run.
+  monotonic_document::~monotonic_document()
+  {
+  }
+
+  monotonic_object &monotonic_document::root()
+  {
+    return *_root;
+  }
+
+  const monotonic_object &monotonic_document::root() const
+  {
+    return *_root;
+  }
+
+  monotonic_document::allocator_type monotonic_document::get_allocator()
+  {
+    return allocator_type(_arena);
+  }
+
+  void monotonic_document::clear()
+  {
+    _arena.reset();
+    void *p = _arena.allocate(sizeof(monotonic_object), alignof(monotonic_object));
+    _root = new (p) monotonic_object(get_allocator());
+  }
+
+  const char *monotonic_document::load(const char *first, const char *last)
+  {
+    clear();
+    return read_buffer(first, last, *_root);
+  }
+
+}
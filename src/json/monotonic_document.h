@@ -0,0 +1,137 @@
+/*
+ * Copyright 2012 Achille Roussel.
+ *
+ * This file is part of Libjson++.
+ *
+ * Libjson++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Libjson++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JSON_MONOTONIC_DOCUMENT_H
+#define JSON_MONOTONIC_DOCUMENT_H
+
+#include <string>
+#include "json/def.h"
+#include "json/arena.h"
+#include "json/object.h"
+
+namespace json
+{
+
+  /**
+   * @brief A JSON object whose memory comes from a <em>json::arena</em>.
+   */
+  typedef basic_object<char, std::char_traits<char>, arena_allocator<char> > monotonic_object;
+
+  /**
+   * @brief A JSON document allocated in an arena.
+   *
+   * All the lists, map slots, keys and strings of the document are allocated
+   * in an arena owned by the document. Destroying or clearing the document
+   * releases the arena at once instead of destroying the values one by one,
+   * which makes freeing a large document as cheap as freeing a small one.
+   * <br/>
+   * The root of the document is a regular <em>json::basic_object</em> which
+   * can be read and modified like any other object:
+   * <pre>
+   * json::monotonic_document doc (payload);
+   * int id = json::stoi(doc.root()["user"]["id"]);
+   * </pre>
+   * Values assigned to members of the document are copied in its arena,
+   * objects built separately should use <em>get_allocator</em> so they can
+   * be moved in without a copy.
+   *
+   * @note The memory of values that are removed or overwritten is not
+   * reclaimed until the document is cleared or destroyed.
+   */
+  class monotonic_document
+  {
+
+  public:
+
+    typedef monotonic_object::allocator_type	allocator_type;
+
+    explicit monotonic_document(arena::size_type chunk_size = arena::default_chunk_size);
+
+    explicit monotonic_document(const char *str);
+
+    explicit monotonic_document(const char_sequence &str);
+
+    explicit monotonic_document(const std::string &str);
+
+    ~monotonic_document();
+
+    monotonic_object &root();
+
+    const monotonic_object &root() const;
+
+    allocator_type get_allocator();
+
+    /**
+     * @brief Discards the content of the document, the root becomes null.
+     * The memory of the arena is kept for the next values.
+     */
+    void clear();
+
+    /**
+     * @brief Replaces the content of the document with the JSON value
+     * starting at 'first', see <em>json::read_buffer</em> for the
+     * requirements on the buffer. Loading documents of similar sizes in
+     * the same <em>json::monotonic_document</em> reuses its memory.
+     */
+    const char *load(const char *first, const char *last);
+
+  private:
+    monotonic_document(const monotonic_document &) = delete;
+
+    monotonic_document &operator=(const monotonic_document &) = delete;
+
+    arena		_arena;
+    monotonic_object *	_root;
+
+  };
+
+  extern template class basic_object<char, std::char_traits<char>, arena_allocator<char> >;
+
+  extern template void monotonic_object::copy_body(const monotonic_object &);
+  extern template void monotonic_object::copy_body(const object &);
+  extern template void object::copy_body(const monotonic_object &);
+
+  extern template class iterator<monotonic_object,
+				 monotonic_object::object_list::iterator,
+				 monotonic_object::object_map::iterator>;
+
+  extern template class iterator<const monotonic_object,
+				 monotonic_object::object_list::const_iterator,
+				 monotonic_object::object_map::const_iterator>;
+
+  extern template const char *read_buffer(const char *, const char *, monotonic_object &);
+
+  extern template void write_object(std::ostream &, const monotonic_object &);
+
+  extern template bool operator==(const monotonic_object &, const monotonic_object &);
+  extern template bool operator!=(const monotonic_object &, const monotonic_object &);
+  extern template bool operator==(const monotonic_object &, const object &);
+  extern template bool operator!=(const monotonic_object &, const object &);
+  extern template bool operator==(const monotonic_object &, const char *);
+  extern template bool operator!=(const monotonic_object &, const char *);
+
+  inline std::ostream &operator<<(std::ostream &os, const monotonic_object &obj)
+  {
+    write_object(os, obj);
+    return os;
+  }
+
+}
+
+#endif // JSON_MONOTONIC_DOCUMENT_H
@@ -0,0 +1,352 @@
+/*
+ * Copyright 2012 Achille Roussel.
+ *
+ * This file is part of Libjson++.
+ *
+ * Libjson++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Libjson++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <istream>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "json/error.h"
+#include "json/ndjson_reader.h"
+#include "json/buffer_reader.hpp"
+#include "json/object.hpp"
+
+namespace json
+{
+
+  namespace
+  {
+
+    bool is_blank(const std::string &line)
+    {
+      return (*buffer_skip_spaces(line.c_str())) == '\0';
+    }
+
+    void read_record(const std::string &line, object &obj)
+    {
+      const char *first = line.c_str();
+      const char *last  = first + line.size();
+      if (buffer_skip_spaces(read_buffer(first, last, obj)) != last)
+	{
+	  error_invalid_input_non_json();
+	}
+    }
+
+  }
+
+  struct ndjson_reader::parallel_state
+  {
+
+    struct batch
+    {
+      size_type				sequence;
+      std::vector<std::string>		lines;
+      std::vector<size_type>		numbers;
+      std::vector<object>		objects;
+      std::vector<std::exception_ptr>	errors;
+    };
+
+    typedef std::unique_ptr<batch> batch_pointer;
+
+    std::mutex				mutex;
+    std::condition_variable		work_ready;
+    std::condition_variable		batch_done;
+    std::condition_variable		space_available;
+    std::deque<batch_pointer>		work;
+    std::map<size_type, batch_pointer>	done;
+    batch_pointer			current;
+    size_type				position;
+    size_type				batch_size;
+    size_type				max_in_flight;
+    size_type				in_flight;
+    size_type				produced;
+    size_type				consumed;
+    std::exception_ptr			error;
+    bool				packing;
+    bool				eof;
+    bool				stop;
+    std::thread				reader;
+    std::vector<std::thread>		workers;
+
+    parallel_state(size_type batch_size, size_type max_in_flight):
+      mutex(),
+      work_ready(),
+      batch_done(),
+      space_available(),
+      work(),
+      done(),
+      current(),
+      position(0),
+      batch_size(batch_size),
+      max_in_flight(max_in_flight),
+      in_flight(0),
+      produced(0),
+      consumed(0),
+      error(),
+      packing(packing_scope::enabled()),
+      eof(false),
+      stop(false),
+      reader(),
+      workers()
+    {
+    }
+
+    void parse(batch &b)
+    {
+      const size_type n = b.lines.size();
+      b.objects.resize(n);
+      b.errors.resize(n);
+      for (size_type i = 0; i != n; ++i)
+	{
+	  try
+	    {
+	      read_record(b.lines[i], b.objects[i]);
+	    }
+	  catch (...)
+	    {
+	      b.errors[i] = std::current_exception();
+	    }
+	  std::string().swap(b.lines[i]);
+	}
+    }
+
+    // The workers pack lists of numbers like the thread which created the
+    // reader.
+    void run_worker()
+    {
+      const packing_scope scope (packing);
+      std::unique_lock<std::mutex> lock (mutex);
+      for (;;)
+	{
+	  work_ready.wait(lock, [this] { return stop || !work.empty(); });
+	  if (stop)
+	    {
+	      return;
+	    }
+	  batch_pointer b (std::move(work.front()));
+	  work.pop_front();
+	  lock.unlock();
+	  parse(*b);
+	  lock.lock();
+	  const size_type sequence = b->sequence;
+	  done[sequence] = std::move(b);
+	  batch_done.notify_all();
+	}
+    }
+
+    void run_reader(ndjson_reader &r)
+    {
+      for (;;)
+	{
+	  {
+	    std::unique_lock<std::mutex> lock (mutex);
+	    space_available.wait(lock, [this] { return stop || (in_flight < max_in_flight); });
+	    if (stop)
+	      {
+		return;
+	      }
+	  }
+
+	  // An exception thrown while reading ends the input, the lines read
+	  // before it are still parsed and next rethrows it once they have been
+	  // returned.
+	  batch_pointer      b;
+	  std::exception_ptr failure;
+	  try
+	    {
+	      b.reset(new batch());
+	      std::string line;
+	      size_type   number;
+	      while ((b->lines.size() != batch_size) && r.read_line(line, number))
+		{
+		  b->numbers.push_back(number);
+		  b->lines.push_back(std::move(line));
+		}
+	    }
+	  catch (...)
+	    {
+	      failure = std::current_exception();
+	    }
+
+	  std::lock_guard<std::mutex> lock (mutex);
+	  const bool empty = !b || b->lines.empty();
+	  if (!empty)
+	    {
+	      b->sequence = produced++;
+	      ++in_flight;
+	      work.push_back(std::move(b));
+	      work_ready.notify_one();
+	    }
+	  if (empty || failure)
+	    {
+	      error = failure;
+	      eof   = true;
+	      batch_done.notify_all();
+	      return;
+	    }
+	}
+    }
+
+    void shutdown()
+    {
+      {
+	std::lock_guard<std::mutex> lock (mutex);
+	stop = true;
+	work_ready.notify_all();
+	space_available.notify_all();
+      }
+      if (reader.joinable())
+	{
+	  reader.join();
+	}
+      for (auto &worker : workers)
+	{
+	  worker.join();
+	}
+    }
+
+  };
+
+  ndjson_reader::ndjson_reader(std::istream &is):
+    _is(is),
+    _buffer(),
+    _line_count(0),
+    _line(0),
+    _parallel()
+  {
+  }
+
+  ndjson_reader::ndjson_reader(std::istream &is,
+			       const size_type threads,
+			       const size_type batch_size,
+			       const size_type queue_size):
+    _is(is),
+    _buffer(),
+    _line_count(0),
+    _line(0),
+    _parallel()
+  {
+    if (threads == 0)
+      {
+	return;
+      }
+
+    _parallel.reset(new parallel_state((batch_size == 0) ? 1 : batch_size,
+				       (queue_size == 0) ? (2 * threads) : queue_size));
+    try
+      {
+	for (size_type i = 0; i != threads; ++i)
+	  {
+	    _parallel->workers.emplace_back(&parallel_state::run_worker, _parallel.get());
+	  }
+	_parallel->reader = std::thread(&parallel_state::run_reader, _parallel.get(), std::ref(*this));
+      }
+    catch (...)
+      {
+	_parallel->shutdown();
+	throw;
+      }
+  }
+
+  ndjson_reader::~ndjson_reader()
+  {
+    if (_parallel)
+      {
+	_parallel->shutdown();
+      }
+  }
+
+  bool ndjson_reader::read_line(std::string &line, size_type &number)
+  {
+    while (std::getline(_is, line))
+      {
+	number = ++_line_count;
+	if (!is_blank(line))
+	  {
+	    return true;
+	  }
+      }
+    return false;
+  }
+
+  bool ndjson_reader::next(object &obj)
+  {
+    if (!_parallel)
+      {
+	if (!read_line(_buffer, _line))
+	  {
+	    return false;
+	  }
+	read_record(_buffer, obj);
+	return true;
+      }
+
+    parallel_state &p = *_parallel;
+    for (;;)
+      {
+	if (p.current && (p.position != p.current->objects.size()))
+	  {
+	    const size_type i = p.position++;
+	    _line = p.current->numbers[i];
+	    if (p.current->errors[i])
+	      {
+		std::rethrow_exception(p.current->errors[i]);
+	      }
+	    obj = std::move(p.current->objects[i]);
+	    return true;
+	  }
+
+	std::unique_lock<std::mutex> lock (p.mutex);
+	if (p.current)
+	  {
+	    p.current.reset();
+	    --p.in_flight;
+	    ++p.consumed;
+	    p.space_available.notify_one();
+	  }
+	p.batch_done.wait(lock, [&p] {
+	    return (p.done.count(p.consumed) != 0) || (p.eof && (p.consumed == p.produced));
+	  });
+	auto it = p.done.find(p.consumed);
+	if (it == p.done.end())
+	  {
+	    if (p.error)
+	      {
+		std::exception_ptr error;
+		std::swap(error, p.error);
+		std::rethrow_exception(error);
+	      }
+	    return false;
+	  }
+	p.current  = std::move(it->second);
+	p.position = 0;
+	p.done.erase(it);
+      }
+  }
+
+  ndjson_reader::size_type ndjson_reader::line() const
+  {
+    return _line;
+  }
+
+}
@@ -0,0 +1,121 @@
+/*
+ * Copyright 2012 Achille Roussel.
+ *
+ * This file is part of Libjson++.
+ *
+ * Libjson++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Libjson++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JSON_NDJSON_READER_H
+#define JSON_NDJSON_READER_H
+
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include "json/def.h"
+#include "json/object.h"
+
+namespace json
+{
+
+  /**
+   * @brief Reads newline-delimited JSON (NDJSON, JSON Lines).
+   *
+   * Each non-blank line of the input stream holds one JSON object, the reader
+   * returns them one after the other through <em>next</em>.
+   * <br/>
+   * In sequential mode the lines are read and parsed by the thread calling
+   * <em>next</em>. In parallel mode a thread reads batches of lines from the
+   * stream and a pool of threads parses them, the objects are still returned
+   * in the order of the input. The number of batches read ahead of the
+   * consumer is bounded, which bounds the memory used by the reader.
+   * <br/>
+   * A line that isn't valid JSON makes <em>next</em> throw a
+   * <em>json::error</em> when its turn comes, the following records can
+   * still be read by calling <em>next</em> again.
+   * <br/>
+   * An exception thrown while reading the stream in parallel mode is
+   * rethrown by <em>next</em> after the records read before it, the end of
+   * the input is then reached.
+   *
+   * @note In parallel mode the stream is read by another thread, it must not
+   * be used by the program until the reader is destroyed.
+   */
+  class ndjson_reader
+  {
+
+  public:
+
+    typedef std::size_t	size_type;
+
+    enum
+      {
+	default_batch_size = 1024
+      };
+
+    /**
+     * @brief Creates a sequential reader.
+     */
+    explicit ndjson_reader(std::istream &is);
+
+    /**
+     * @brief Creates a parallel reader.
+     *
+     * @param is The stream to read the records from.
+     * @param threads The number of threads parsing the records, a sequential
+     * reader is created if this is zero.
+     * @param batch_size The number of lines parsed at once by a thread.
+     * @param queue_size The maximum number of batches read ahead of the
+     * consumer, which defaults to twice the number of threads.
+     */
+    ndjson_reader(std::istream &is,
+		  size_type threads,
+		  size_type batch_size = default_batch_size,
+		  size_type queue_size = 0);
+
+    ~ndjson_reader();
+
+    /**
+     * @brief Reads the next record into 'obj'.
+     *
+     * @return The function returns false when the end of the stream has been
+     * reached.
+     */
+    bool next(object &obj);
+
+    /**
+     * @brief Returns the line number (starting at 1) of the last record
+     * returned or rejected by <em>next</em>.
+     */
+    size_type line() const;
+
+  private:
+    ndjson_reader(const ndjson_reader &) = delete;
+    ndjson_reader &operator=(const ndjson_reader &) = delete;
+
+    struct parallel_state;
+
+    bool read_line(std::string &line, size_type &number);
+
+    std::istream			&_is;
+    std::string				_buffer;
+    size_type				_line_count;
+    size_type				_line;
+    std::unique_ptr<parallel_state>	_parallel;
+
+  };
+
+}
+
+#endif // JSON_NDJSON_READER_H
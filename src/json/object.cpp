@@ -27,6 +27,8 @@ namespace json
 
   template class basic_object<char>;
 
+  template void object::copy_body(const object &);
+
   const object null;
 
   void error_json_object_invalid_type(const void *const at,
@@ -46,6 +48,28 @@ namespace json
     throw error(s.str());
   }
 
+  void error_json_object_borrowed_string(const void *const at, const char *function)
+  {
+    std::ostringstream s;
+    s << function;
+    s << ": the string is borrowed, it can only be read through get_char_sequence"
+      " on a const object (at ";
+    s << at;
+    s << ")";
+    throw error(s.str());
+  }
+
+  void error_json_object_packed(const void *const at, const char *function)
+  {
+    std::ostringstream s;
+    s << function;
+    s << ": the list is packed, its members are only read through the iterators,"
+      " get_integers and get_doubles on a const object (at ";
+    s << at;
+    s << ")";
+    throw error(s.str());
+  }
+
   void error_json_object_no_such_key(const void *const at,
 				     const void *const data,
 				     const std::size_t size)
@@ -20,15 +20,25 @@
 #ifndef JSON_OBJECT_H
 #define JSON_OBJECT_H
 
+#include <atomic>
 #include <iosfwd>
+#include <type_traits>
 #include <vector>
 #include "json/def.h"
 #include "json/types.h"
 #include "json/for_each.h"
 #include "json/hash_map.h"
+#include "json/key_table.h"
+#include "json/string_pool.h"
+#include "json/span.h"
 #include "json/parsing.h"
 #include "json/string.h"
 #include "json/reader.h"
+#include "json/buffer_reader.h"
+#include "json/insitu_reader.h"
+#include "json/path_filter.h"
+#include "json/stream_reader.h"
+#include "json/structural_index.h"
 #include "json/writer.h"
 #include "json/iterator.h"
 
@@ -43,12 +53,37 @@ namespace json
    * of a JSON object.
    * <br/>
    * JSON objects may be of 4 different types which are 'null', 'string', 'list'
-   * and 'map'.
+   * and 'map', or hold a 'boolean' or a number.
    * <br/>
-   * The JSON standard also specify a 'number' type but to keep the code simple
-   * and avoid useless work those types are stored under the 'string' type in
-   * the object, they can be converted to integers or floating point numbers
-   * using the <em>std::stol</em> and <em>std::stod</em> functions.
+   * Numbers are stored inline as an 'integer', 'unsigned' or 'double' value
+   * along with their text: the readers keep the text a number was read from
+   * when it is no longer than <em>number_text_size</em> characters, so that
+   * it is written back unchanged, the other numbers hold the text of their
+   * value. They can be converted to other types with the
+   * <em>json::stol</em> and <em>json::stod</em> functions. Only strings
+   * compare equal to character strings, and only booleans are true or false
+   * (see <em>json::is_true</em>).
+   * </p>
+   * <p>
+   * A string may also be borrowed: the object then only references characters
+   * owned by someone else (see <em>borrow</em> and <em>json::read_insitu</em>),
+   * which must outlive it. A borrowed string is converted to an owned one when
+   * it is accessed through the non-const <em>get_string</em>, the const one
+   * throws a <em>json::error</em> since it can't modify the object, and
+   * <em>get_char_sequence</em> reads it in place. Copies of an object always
+   * own their strings.
+   * </p>
+   * <p>
+   * While a <em>json::basic_string_pool</em> is in use, strings are shared
+   * through the pool instead (see <em>intern</em>): the const
+   * <em>get_string</em> returns the pooled string, the non-const one
+   * converts it like a borrowed one, and copies of an object share it.
+   * </p>
+   * <p>
+   * Lists and maps may be shared by several objects as well (see
+   * <em>share</em> and <em>json::deduplicate</em>): copies of the object
+   * then share its body, which is copied the first time one of them is
+   * modified.
    * </p>
    */
   template < typename Char,
@@ -71,6 +106,8 @@ namespace json
     typedef Char							char_type;
     typedef basic_char_sequence<Char, Traits>				char_sequence_type;
     typedef typename object_string::size_type				size_type;
+    typedef typename Allocator::template rebind<native_value>::other	native_allocator;
+    typedef std::vector<native_value, native_allocator>			native_list;
 
   private:
 
@@ -80,12 +117,41 @@ namespace json
     // of complex types by overloading the default constructor and the
     // destructor.
 
+    struct number_body
+    {
+      native_value value;
+      char_type    text[number_text_size]; // ends with a '\0' unless full
+    };
+
+    // Lists of numbers may be stored as one buffer of values, which all are
+    // integers or all are doubles.
+    struct packed_list
+    {
+      native_list values;
+      object_type type;
+    };
+
+    // Lists and maps shared by several objects, see share.
+    struct shared_body;
+
+    typedef typename basic_string_pool<Char, Traits>::pooled_string	pooled_string;
+
+    // Only the objects whose strings have the type of the pooled ones use a
+    // pool, the const get_string returns the pooled strings.
+    typedef std::is_same<object_string,
+			 typename basic_string_pool<Char, Traits>::string_type>	uses_string_pool;
+
     union object_body
     {
 
-      object_string string;
-      object_list   list;
-      object_map    map;
+      object_string      string;
+      object_list        list;
+      object_map         map;
+      char_sequence_type sequence; // borrowed strings
+      const pooled_string *pooled; // interned strings
+      number_body        number;   // booleans and numbers
+      packed_list        array;    // packed lists of numbers
+      shared_body       *node;     // shared lists and maps
 
       object_body()
       {
@@ -101,6 +167,11 @@ namespace json
 	new (&string) object_string ( std::forward<Args>(args)... );
       }
 
+      void create_sequence(const char_sequence_type &s)
+      {
+	new (&sequence) char_sequence_type ( s );
+      }
+
       template < typename... Args >
       void create_list(Args&&... args)
       {
@@ -114,26 +185,85 @@ namespace json
 	new (&map) object_map ( std::forward<Args>(args)... );
       }
 
-      void create_copy(const object_type type, const object_body &body)
+      void create_packed(const packed_list &p)
+      {
+	new (&array) packed_list ( p );
+      }
+
+      void create_packed(packed_list &&p)
+      {
+	new (&array) packed_list ( std::move(p) );
+      }
+
+      void create_copy(const object_type type, const bool packed, const object_body &body)
       {
 	switch (type)
 	  {
-	  case type_string: create_string(body.string); break;
-	  case type_list:   create_list(body.list);     break;
-	  case type_map:    create_map(body.map);       break;
-	  case type_null:                               break;
+	  case type_string:   create_string(body.string); break;
+	  case type_list:
+	    if (packed)
+	      {
+		create_packed(body.array);
+	      }
+	    else
+	      {
+		create_list(body.list);
+	      }
+	    break;
+	  case type_map:      create_map(body.map);       break;
+	  case type_boolean:
+	  case type_integer:
+	  case type_unsigned:
+	  case type_double:   number = body.number;       break;
+	  case type_null:                                 break;
 	  }
       }
 
-      void create_move(const object_type type, object_body &&body)
+      void create_move(const object_type type,
+		       const bool borrowed,
+		       const bool interned,
+		       const bool packed,
+		       const bool shared,
+		       object_body &&body)
       {
+	if (shared)
+	  {
+	    node = body.node;
+	    return;
+	  }
 	switch (type)
 	  {
-	  case type_string: create_string(std::move(body.string)); break;
-	  case type_list:   create_list(std::move(body.list));     break;
-	  case type_map:    create_map(std::move(body.map));       break;
-	  case type_null:                                          break;
-	  }	
+	  case type_string:
+	    if (interned)
+	      {
+		pooled = body.pooled;
+	      }
+	    else if (borrowed)
+	      {
+		create_sequence(body.sequence);
+	      }
+	    else
+	      {
+		create_string(std::move(body.string));
+	      }
+	    break;
+	  case type_list:
+	    if (packed)
+	      {
+		create_packed(std::move(body.array));
+	      }
+	    else
+	      {
+		create_list(std::move(body.list));
+	      }
+	    break;
+	  case type_map:      create_map(std::move(body.map));   break;
+	  case type_boolean:
+	  case type_integer:
+	  case type_unsigned:
+	  case type_double:   number = body.number;              break;
+	  case type_null:                                        break;
+	  }
       }
 
       void destroy_string()
@@ -151,48 +281,88 @@ namespace json
 	map.~object_map();
       }
 
-      void destroy(const object_type type)
+      void destroy_packed()
+      {
+	array.~packed_list();
+      }
+
+      // Shared bodies are released by the objects.
+      void destroy(const object_type type,
+		   const bool borrowed,
+		   const bool packed,
+		   const bool shared)
       {
+	if (shared)
+	  {
+	    return;
+	  }
 	switch (type)
 	  {
-	  case type_string: destroy_string(); break;
-	  case type_list:   destroy_list();   break;
-	  case type_map:    destroy_map();    break;
+	  case type_string:
+	    if (!borrowed)
+	      {
+		destroy_string();
+	      }
+	    break;
+	  case type_list:
+	    if (packed)
+	      {
+		destroy_packed();
+	      }
+	    else
+	      {
+		destroy_list();
+	      }
+	    break;
+	  case type_map:      destroy_map();  break;
+	  case type_boolean:
+	  case type_integer:
+	  case type_unsigned:
+	  case type_double:
 	  case type_null:                     break;
 	  }
       }
 
       void assign_string(const object_type type,
+			 const bool borrowed,
+			 const bool packed,
+			 const bool shared,
 			 const char_sequence_type &s,
 			 const allocator_type &a)
       {
-	if (type != type_string)
+	if ((type != type_string) || borrowed)
 	  {
-	    destroy(type);
+	    destroy(type, borrowed, packed, shared);
 	    create_string(a);
 	  }
 	string.assign(s.data(), s.size());
       }
 
       void assign_string(const object_type type,
+			 const bool borrowed,
+			 const bool packed,
+			 const bool shared,
 			 const object_string &s,
 			 const allocator_type &a)
       {
-	if (type != type_string)
+	if ((type != type_string) || borrowed)
 	  {
-	    destroy(type);
+	    destroy(type, borrowed, packed, shared);
 	    create_string(a);
 	  }
 	string.assign(s);
       }
 
       void assign_string(const object_type type,
+			 const bool borrowed,
+			 const bool packed,
+			 const bool shared,
 			 object_string &&s,
 			 const allocator_type &a)
       {
-	if (type != type_string)
+	if ((type != type_string) || borrowed)
 	  {
-	    destroy(type);
+	    destroy(type, borrowed, packed, shared);
 	    create_string(a);
 	  }
 	string.assign(std::forward<object_string>(s));
@@ -220,7 +390,7 @@ namespace json
 
     basic_object(const basic_object &obj);
 
-    basic_object(basic_object &&obj);
+    basic_object(basic_object &&obj) noexcept;
 
     basic_object(bool x,
 		 const allocator_type &a = allocator_type());
@@ -265,6 +435,10 @@ namespace json
     basic_object(const char_type (&s)[N],
 		 const allocator_type &a = allocator_type()):
       _allocator(a),
+      _borrowed(false),
+      _interned(false),
+      _packed(false),
+      _shared(false),
       _type(type_null),
       _body()
     {
@@ -275,26 +449,32 @@ namespace json
     basic_object(const std::basic_string<Char, Traits, _Alloc> &s,
 		 const allocator_type &a = allocator_type()):
       _allocator(a),
+      _borrowed(false),
+      _interned(false),
+      _packed(false),
+      _shared(false),
       _type(type_null),
       _body()
     {
       (*this) = s;
     }
 
+    /**
+     * @brief Copies an object with the given allocator, which is also used by
+     * all the members of lists and maps.
+     */
     template < typename _Alloc >
     basic_object(const basic_object<Char, Traits, _Alloc> &obj,
 		 const allocator_type &a = allocator_type()):
       _allocator(a),
-      _type(obj.type()),
+      _borrowed(false),
+      _interned(false),
+      _packed(false),
+      _shared(false),
+      _type(type_null),
       _body()
     {
-      switch (obj.type())
-	{
-	case type_string: _body.create_string(obj.get_string()); break;
-	case type_list:   _body.create_list(obj.get_list());     break;
-	case type_map:    _body.create_map(obj.get_map());       break;
-	case type_null:                                          break;
-	}
+      copy_body(obj);
     }
 
     ~basic_object();
@@ -348,9 +528,9 @@ namespace json
     }
 
     template < typename _Alloc >
-    basic_object &operator=(const basic_object<_Alloc> &obj)
+    basic_object &operator=(const basic_object<Char, Traits, _Alloc> &obj)
     {
-      basic_object(obj).swap(*this);
+      basic_object(obj, _allocator).swap(*this);
       return *this;
     }
 
@@ -388,8 +568,139 @@ namespace json
 
     void make_map();
 
+    /**
+     * @brief Makes the object a string referencing the given characters
+     * without copying them, they must outlive the object.
+     */
+    void borrow(const char_sequence_type &s);
+
+    /**
+     * @brief Returns true if the object is a borrowed string.
+     */
+    bool is_borrowed() const;
+
+    /**
+     * @brief Moves a string to the given pool and returns true, or returns
+     * false if the object is not a string or the pool has no room for it.
+     */
+    bool intern(basic_string_pool<Char, Traits> &pool);
+
+    /**
+     * @brief Returns true if the object is a string shared through a pool.
+     */
+    bool is_interned() const;
+
+    /**
+     * @brief Makes the object the number written in the given JSON text,
+     * stored as the narrowest of 'integer', 'unsigned' and 'double' holding
+     * it. The text is kept to be written back if it fits in the object.
+     */
+    void make_number(const char_sequence_type &s);
+
+    /**
+     * @brief Returns the characters of a string object, borrowed or not,
+     * without converting it.
+     * <br/>
+     * Booleans and numbers return their text.
+     */
+    char_sequence_type get_char_sequence() const;
+
+    /**
+     * @brief Returns true if the object is a list of numbers packed in one
+     * buffer of integers or doubles.
+     * <br/>
+     * Lists are packed by <em>pack</em> and <em>make_packed</em>, and by the
+     * readers while a <em>json::packing_scope</em> is enabled.
+     * <br/>
+     * Packed lists are lists like the others, but their members have to be
+     * unpacked to be accessed as objects: the non-const <em>operator[]</em>,
+     * <em>get_list</em> and iterators unpack the list first. A const object
+     * is never modified, its const iterators yield the numbers as values and
+     * the const <em>operator[]</em> and <em>get_list</em> throw a
+     * <em>json::error</em>. The numbers can be accessed in place with
+     * <em>get_integers</em> and <em>get_doubles</em> as well.
+     */
+    bool is_packed() const;
+
+    /**
+     * @brief Returns the type of the numbers of a packed list, which is
+     * either 'type_integer' or 'type_double', and 'type_null' for objects
+     * which are not packed lists.
+     */
+    object_type packed_type() const;
+
+    /**
+     * @brief Packs a list of numbers and returns true. Other objects, lists
+     * with members which are not numbers and lists of numbers which no
+     * common type holds exactly are left unchanged and false is returned.
+     * <br/>
+     * Integers and doubles are packed together as doubles when that doesn't
+     * round any of them. The texts of packed numbers are not kept.
+     */
+    bool pack();
+
+    /**
+     * @brief Converts a packed list back to a list of objects.
+     */
+    void unpack();
+
+    /**
+     * @brief Makes the object a packed list of the given values, whose type
+     * is either 'type_integer' or 'type_double'.
+     */
+    void make_packed(object_type type, native_list &&values);
+
+    span<const long long> get_integers() const;
+
+    span<long long> get_integers();
+
+    span<const double> get_doubles() const;
+
+    span<double> get_doubles();
+
+    /**
+     * @brief Returns true if the list or map of the object is shared with
+     * other objects.
+     */
+    bool is_shared() const;
+
+    /**
+     * @brief Makes the object share the list or map of 'obj' instead of
+     * copying it, other objects and objects with different allocators are
+     * copied.
+     * <br/>
+     * A shared body is never modified: the non-const accessors
+     * (<em>operator[]</em>, <em>get_list</em>, <em>get_map</em>, the
+     * iterators...) first give the object its own copy, whose members still
+     * share their lists and maps. References to members obtained through
+     * the const accessors are only valid while the body is shared.
+     * <br/>
+     * 'obj' may be a member of this object, but not the other way around.
+     */
+    void share(basic_object &obj);
+
+    bool get_boolean() const;
+
+    long long get_integer() const;
+
+    unsigned long long get_unsigned() const;
+
+    double get_double() const;
+
+    /**
+     * @brief Returns the string of the object, a borrowed or pooled string is
+     * first copied to a string owned by the object.
+     */
     object_string &get_string();
 
+    /**
+     * @brief Returns the string of the object, or the pooled string it
+     * shares.
+     * <br/>
+     * A borrowed string, such as the ones read by <em>json::read_insitu</em>,
+     * has no string to return and throws a <em>json::error</em>, its
+     * characters are read with <em>get_char_sequence</em>.
+     */
     const_object_string &get_string() const;
 
     object_list &get_list();
@@ -409,24 +720,87 @@ namespace json
     const_iterator end() const;
 
   private:
+    template < typename, typename, typename >
+    friend class basic_object;
+
+    template < typename, typename, typename >
+    friend class basic_deduplicator;
+
+    template < typename C, typename T, typename A1, typename A2 >
+    friend bool equals_string(const basic_object<C, T, A1> &obj1,
+			      const basic_object<C, T, A2> &obj2);
+
+    typedef typename Allocator::template rebind<shared_body>::other	shared_allocator;
+
     allocator_type	_allocator;
+    bool		_borrowed; // also set for interned strings
+    bool		_interned;
+    bool		_packed;
+    bool		_shared;
     object_type		_type;
     object_body		_body;
 
-    template < typename Integer >
-    void assign_number(const Integer &x)
-    {
-      object_string s ( to_string<char_type, traits_type>(x, _allocator) );
-      _body.assign_string(_type, std::move(s), _allocator);
-      _type = type_string;
-    }
+    void assign_native(object_type type, const native_value &x);
+
+    template < typename Text >
+    void assign_text(const Text *s, std::size_t n);
+
+    void assign_number(long long x);
+
+    void assign_number(unsigned long long x);
+
+    void assign_number(double x);
+
+    template < typename Object >
+    void copy_body(const Object &obj);
+
+    bool assign_interned(const char_sequence_type &s);
+
+    void make_interned(const pooled_string *s);
+
+    template < typename String >
+    void store_string(String &&s);
+
+    const basic_object &shared_value() const;
+
+    void make_shared();
+
+    void share_body(shared_body *node);
+
+    void copy_shared(shared_body *node);
+
+    template < typename Body >
+    void copy_shared(const Body *node);
+
+    void release_shared(shared_body *node) const;
+
+    void unshare();
+
+    void own_string();
 
     void assert_type_is(object_type, const char *) const;
 
+    void assert_packed_type_is(object_type, const char *) const;
+
+  };
+
+  template < typename Char, typename Traits, typename Allocator >
+  struct basic_object<Char, Traits, Allocator>::shared_body
+  {
+    std::atomic<std::size_t> references;
+    basic_object             value;
+
+    shared_body(const Allocator &a):
+      references(1),
+      value(a)
+    {
+    }
   };
 
   extern template class basic_object<char>;
 
+  extern template void object::copy_body(const object &);
+
   extern template class iterator<object,
 				 object::object_list::iterator,
 				 object::object_map::iterator>;
@@ -443,6 +817,18 @@ namespace json
     return obj.type() == type_string;
   }
 
+  template < typename Char, typename Traits, typename Allocator >
+  inline bool is_boolean(const basic_object<Char, Traits, Allocator> &obj)
+  {
+    return obj.type() == type_boolean;
+  }
+
+  template < typename Char, typename Traits, typename Allocator >
+  inline bool is_number(const basic_object<Char, Traits, Allocator> &obj)
+  {
+    return is_number_type(obj.type());
+  }
+
   template < typename Char, typename Traits, typename Allocator >
   inline bool is_list(const basic_object<Char, Traits, Allocator> &obj)
   {
@@ -464,13 +850,13 @@ namespace json
   template < typename Char, typename Traits, typename Allocator >
   inline bool is_true(const basic_object<Char, Traits, Allocator> &obj)
   {
-    return (obj.type() == type_string) && is_json_true(obj);
+    return (obj.type() == type_boolean) && obj.get_boolean();
   }
 
   template < typename Char, typename Traits, typename Allocator >
   inline bool is_false(const basic_object<Char, Traits, Allocator> &obj)
   {
-    return (obj.type() == type_string) && is_json_false(obj);
+    return (obj.type() == type_boolean) && !obj.get_boolean();
   }
 
   template < typename Char,
@@ -565,8 +951,7 @@ namespace json
 
   inline std::istream &operator>>(std::istream &is, json::object &obj)
   {
-    read_object(is, obj);
-    return is;
+    return read_stream(is, obj);
   }
 
   inline std::ostream &operator<<(std::ostream &os, const json::object &obj)
@@ -620,6 +1005,18 @@ namespace std
     return json::stoll(obj);
   }
 
+  template < typename Char, typename Traits, typename Allocator >
+  inline unsigned long stoul(const json::basic_object<Char, Traits, Allocator> &obj)
+  {
+    return json::stoul(obj);
+  }
+
+  template < typename Char, typename Traits, typename Allocator >
+  inline unsigned long long stoull(const json::basic_object<Char, Traits, Allocator> &obj)
+  {
+    return json::stoull(obj);
+  }
+
   template < typename Char, typename Traits, typename Allocator >
   inline float stof(const json::basic_object<Char, Traits, Allocator> &obj)
   {
@@ -20,11 +20,19 @@
 #ifndef JSON_OBJECT_HPP
 #define JSON_OBJECT_HPP
 
+#include <algorithm>
+#include <limits>
 #include "json/char_sequence.hpp"
 #include "json/parsing.hpp"
 #include "json/hash_map.hpp"
+#include "json/string_pool.hpp"
+#include "json/arena.h"
 #include "json/iterator.hpp"
 #include "json/reader.hpp"
+#include "json/buffer_reader.hpp"
+#include "json/insitu_reader.hpp"
+#include "json/path_filter.hpp"
+#include "json/structural_index.hpp"
 #include "json/writer.hpp"
 #include "json/object.h"
 
@@ -36,6 +44,11 @@ namespace json
 				      object_type found,
 				      const char *function);
 
+  void error_json_object_borrowed_string(const void *at, const char *function);
+
+
+  void error_json_object_packed(const void *at, const char *function);
+
   void error_json_object_no_such_key(const void *at,
 				     const void *data,
 				     std::size_t size);
@@ -44,6 +57,10 @@ namespace json
   basic_object<Char, Traits, Allocator>::
   basic_object(const allocator_type &a):
     _allocator(a),
+    _borrowed(false),
+    _interned(false),
+    _packed(false),
+    _shared(false),
     _type(type_null),
     _body()
   {
@@ -53,16 +70,39 @@ namespace json
   basic_object<Char, Traits, Allocator>::
   basic_object(const basic_object &obj):
     _allocator(obj._allocator),
+    _borrowed(false),
+    _interned(false),
+    _packed(obj._packed),
+    _shared(false),
     _type(obj._type),
     _body()
   {
-    _body.create_copy(obj._type, obj._body);
+    if (obj._shared)
+      {
+	share_body(obj._body.node);
+      }
+    else if (obj._interned)
+      {
+	make_interned(obj._body.pooled);
+      }
+    else if (obj._borrowed)
+      {
+	_body.create_string(obj._body.sequence.data(), obj._body.sequence.size(), _allocator);
+      }
+    else
+      {
+	_body.create_copy(obj._type, obj._packed, obj._body);
+      }
   }
 
   template < typename Char, typename Traits, typename Allocator >
   basic_object<Char, Traits, Allocator>::
-  basic_object(basic_object &&obj):
+  basic_object(basic_object &&obj) noexcept:
     _allocator(),
+    _borrowed(false),
+    _interned(false),
+    _packed(false),
+    _shared(false),
     _type(type_null),
     _body()
   {
@@ -73,6 +113,10 @@ namespace json
   basic_object<Char, Traits, Allocator>::
   basic_object(const bool x, const allocator_type &a):
     _allocator(a),
+    _borrowed(false),
+    _interned(false),
+    _packed(false),
+    _shared(false),
     _type(type_null),
     _body()
   {
@@ -83,6 +127,10 @@ namespace json
   basic_object<Char, Traits, Allocator>::
   basic_object(const short x, const allocator_type &a):
     _allocator(a),
+    _borrowed(false),
+    _interned(false),
+    _packed(false),
+    _shared(false),
     _type(type_null),
     _body()
   {
@@ -93,6 +141,10 @@ namespace json
   basic_object<Char, Traits, Allocator>::
   basic_object(const int x, const allocator_type &a):
     _allocator(a),
+    _borrowed(false),
+    _interned(false),
+    _packed(false),
+    _shared(false),
     _type(type_null),
     _body()
   {
@@ -103,6 +155,10 @@ namespace json
   basic_object<Char, Traits, Allocator>::
   basic_object(const long x, const allocator_type &a):
     _allocator(a),
+    _borrowed(false),
+    _interned(false),
+    _packed(false),
+    _shared(false),
     _type(type_null),
     _body()
   {
@@ -113,6 +169,10 @@ namespace json
   basic_object<Char, Traits, Allocator>::
   basic_object(const long long x, const allocator_type &a):
     _allocator(a),
+    _borrowed(false),
+    _interned(false),
+    _packed(false),
+    _shared(false),
     _type(type_null),
     _body()
   {
@@ -123,6 +183,10 @@ namespace json
   basic_object<Char, Traits, Allocator>::
   basic_object(const unsigned short x, const allocator_type &a):
     _allocator(a),
+    _borrowed(false),
+    _interned(false),
+    _packed(false),
+    _shared(false),
     _type(type_null),
     _body()
   {
@@ -133,6 +197,10 @@ namespace json
   basic_object<Char, Traits, Allocator>::
   basic_object(const unsigned int x, const allocator_type &a):
     _allocator(a),
+    _borrowed(false),
+    _interned(false),
+    _packed(false),
+    _shared(false),
     _type(type_null),
     _body()
   {
@@ -143,6 +211,10 @@ namespace json
   basic_object<Char, Traits, Allocator>::
   basic_object(const unsigned long x, const allocator_type &a):
     _allocator(a),
+    _borrowed(false),
+    _interned(false),
+    _packed(false),
+    _shared(false),
     _type(type_null),
     _body()
   {
@@ -153,6 +225,10 @@ namespace json
   basic_object<Char, Traits, Allocator>::
   basic_object(const unsigned long long x, const allocator_type &a):
     _allocator(a),
+    _borrowed(false),
+    _interned(false),
+    _packed(false),
+    _shared(false),
     _type(type_null),
     _body()
   {
@@ -163,6 +239,10 @@ namespace json
   basic_object<Char, Traits, Allocator>::
   basic_object(const float x, const allocator_type &a):
     _allocator(a),
+    _borrowed(false),
+    _interned(false),
+    _packed(false),
+    _shared(false),
     _type(type_null),
     _body()
   {
@@ -173,6 +253,10 @@ namespace json
   basic_object<Char, Traits, Allocator>::
   basic_object(const double x, const allocator_type &a):
     _allocator(a),
+    _borrowed(false),
+    _interned(false),
+    _packed(false),
+    _shared(false),
     _type(type_null),
     _body()
   {
@@ -183,6 +267,10 @@ namespace json
   basic_object<Char, Traits, Allocator>::
   basic_object(const long double x, const allocator_type &a):
     _allocator(a),
+    _borrowed(false),
+    _interned(false),
+    _packed(false),
+    _shared(false),
     _type(type_null),
     _body()
   {
@@ -193,6 +281,10 @@ namespace json
   basic_object<Char, Traits, Allocator>::
   basic_object(const char_sequence_type &s, const allocator_type &a):
     _allocator(a),
+    _borrowed(false),
+    _interned(false),
+    _packed(false),
+    _shared(false),
     _type(type_null),
     _body()
   {
@@ -213,7 +305,7 @@ namespace json
   {
     if (this != &obj)
       {
-	basic_object(obj).swap(*this);
+	basic_object(obj, _allocator).swap(*this);
       }
     return *this;
   }
@@ -223,7 +315,16 @@ namespace json
   basic_object<Char, Traits, Allocator>::
   operator=(basic_object &&obj)
   {
-    obj.swap(*this);
+    // The memory of an object using another allocator can't be taken over,
+    // it may be released before this object (an arena for example).
+    if (_allocator == obj._allocator)
+      {
+	obj.swap(*this);
+      }
+    else
+      {
+	basic_object(obj, _allocator).swap(*this);
+      }
     return *this;
   }
 
@@ -232,8 +333,10 @@ namespace json
   basic_object<Char, Traits, Allocator>::
   operator=(const char_sequence_type &s)
   {
-    _body.assign_string(_type, s, _allocator);
-    _type = type_string;
+    if (!assign_interned(s))
+      {
+	store_string(s);
+      }
     return *this;
   }
 
@@ -242,8 +345,10 @@ namespace json
   basic_object<Char, Traits, Allocator>::
   operator=(const object_string &s)
   {
-    _body.assign_string(_type, s, _allocator);
-    _type = type_string;
+    if (!assign_interned(s))
+      {
+	store_string(s);
+      }
     return *this;
   }
 
@@ -252,8 +357,10 @@ namespace json
   basic_object<Char, Traits, Allocator>::
   operator=(object_string &&s)
   {
-    _body.assign_string(_type, std::forward<object_string>(s), _allocator);
-    _type = type_string;
+    if (!assign_interned(char_sequence_type(s)))
+      {
+	store_string(std::forward<object_string>(s));
+      }
     return *this;
   }
 
@@ -262,14 +369,9 @@ namespace json
   basic_object<Char, Traits, Allocator>::
   operator=(const bool x)
   {
-    if (x)
-      {
-	(*this) = "true";
-      }
-    else
-      {
-	(*this) = "false";
-      }
+    native_value v;
+    v.boolean = x;
+    assign_native(type_boolean, v);
     return *this;
   }
 
@@ -278,7 +380,7 @@ namespace json
   basic_object<Char, Traits, Allocator>::
   operator=(const short x)
   {
-    assign_number(x);
+    assign_number(static_cast<long long>(x));
     return *this;
   }
 
@@ -287,7 +389,7 @@ namespace json
   basic_object<Char, Traits, Allocator>::
   operator=(const int x)
   {
-    assign_number(x);
+    assign_number(static_cast<long long>(x));
     return *this;
   }
 
@@ -296,7 +398,7 @@ namespace json
   basic_object<Char, Traits, Allocator>::
   operator=(const long x)
   {
-    assign_number(x);
+    assign_number(static_cast<long long>(x));
     return *this;
   }
 
@@ -314,7 +416,7 @@ namespace json
   basic_object<Char, Traits, Allocator>::
   operator=(const unsigned short x)
   {
-    assign_number(x);
+    assign_number(static_cast<unsigned long long>(x));
     return *this;
   }
 
@@ -323,7 +425,7 @@ namespace json
   basic_object<Char, Traits, Allocator>::
   operator=(const unsigned int x)
   {
-    assign_number(x);
+    assign_number(static_cast<unsigned long long>(x));
     return *this;
   }
 
@@ -332,7 +434,7 @@ namespace json
   basic_object<Char, Traits, Allocator>::
   operator=(const unsigned long x)
   {
-    assign_number(x);
+    assign_number(static_cast<unsigned long long>(x));
     return *this;
   }
 
@@ -350,7 +452,7 @@ namespace json
   basic_object<Char, Traits, Allocator>::
   operator=(const float x)
   {
-    assign_number(x);
+    assign_number(static_cast<double>(x));
     return *this;
   }
 
@@ -368,7 +470,7 @@ namespace json
   basic_object<Char, Traits, Allocator>::
   operator=(const long double x)
   {
-    assign_number(x);
+    assign_number(static_cast<double>(x));
     return *this;
   }
 
@@ -387,6 +489,8 @@ namespace json
 	error_json_object_invalid_type(this, type_list, _type,
 				       "json::basic_object<?>::operator[index]");
       }
+    unshare();
+    unpack();
     if (_body.list.size() <= index)
       {
 	_body.list.resize(index + 1);
@@ -404,6 +508,14 @@ namespace json
 	error_json_object_invalid_type(this, type_list, _type,
 				       "json::basic_object<?>::operator[index]");
       }
+    if (_shared)
+      {
+	return shared_value()[index];
+      }
+    if (_packed)
+      {
+	error_json_object_packed(this, "json::basic_object<?>::operator[index]");
+      }
     return _body.list.at(index);
   }
 
@@ -447,17 +559,22 @@ namespace json
   {
     object_body tmp;
 
-    tmp.create_move(_type, std::move(_body));
+    tmp.create_move(_type, _borrowed, _interned, _packed, _shared, std::move(_body));
 
-    _body.destroy(_type);
-    _body.create_move(obj._type, std::move(obj._body));
+    _body.destroy(_type, _borrowed, _packed, _shared);
+    _body.create_move(obj._type, obj._borrowed, obj._interned, obj._packed, obj._shared,
+		      std::move(obj._body));
 
-    obj._body.destroy(obj._type);
-    obj._body.create_move(_type, std::move(tmp));
+    obj._body.destroy(obj._type, obj._borrowed, obj._packed, obj._shared);
+    obj._body.create_move(_type, _borrowed, _interned, _packed, _shared, std::move(tmp));
 
-    tmp.destroy(_type);
+    tmp.destroy(_type, _borrowed, _packed, _shared);
 
     std::swap(_type, obj._type);
+    std::swap(_borrowed, obj._borrowed);
+    std::swap(_interned, obj._interned);
+    std::swap(_packed, obj._packed);
+    std::swap(_shared, obj._shared);
     std::swap(_allocator, obj._allocator);
   }
 
@@ -479,12 +596,20 @@ namespace json
   typename basic_object<Char, Traits, Allocator>::size_type
   basic_object<Char, Traits, Allocator>::size() const
   {
+    if (_shared)
+      {
+	return shared_value().size();
+      }
     switch (_type)
       {
-      case type_null:   return 0;
-      case type_string: return 1;
-      case type_list:   return _body.list.size();
-      case type_map:    return _body.map.size();
+      case type_null:     return 0;
+      case type_string:   return 1;
+      case type_list:     return _packed ? _body.array.values.size() : _body.list.size();
+      case type_map:      return _body.map.size();
+      case type_boolean:
+      case type_integer:
+      case type_unsigned:
+      case type_double:   return 1;
       }
     return 0;
   }
@@ -493,8 +618,20 @@ namespace json
   void
   basic_object<Char, Traits, Allocator>::clear()
   {
-    _body.destroy(_type);
+    if (_interned)
+      {
+	basic_string_pool<Char, Traits>::release(_body.pooled);
+      }
+    if (_shared)
+      {
+	release_shared(_body.node);
+      }
+    _body.destroy(_type, _borrowed, _packed, _shared);
     _type = type_null;
+    _borrowed = false;
+    _interned = false;
+    _packed = false;
+    _shared = false;
   }
 
   template < typename Char, typename Traits, typename Allocator >
@@ -514,6 +651,314 @@ namespace json
 	_body.create_string(_allocator);
 	_type = type_string;
       }
+    else if (_borrowed)
+      {
+	own_string();
+      }
+  }
+
+  template < typename Char, typename Traits, typename Allocator >
+  void
+  basic_object<Char, Traits, Allocator>::borrow(const char_sequence_type &s)
+  {
+    clear();
+    _body.create_sequence(s);
+    _type = type_string;
+    _borrowed = true;
+  }
+
+  template < typename Char, typename Traits, typename Allocator >
+  bool
+  basic_object<Char, Traits, Allocator>::is_borrowed() const
+  {
+    return _borrowed && !_interned;
+  }
+
+  template < typename Char, typename Traits, typename Allocator >
+  bool
+  basic_object<Char, Traits, Allocator>::intern(basic_string_pool<Char, Traits> &pool)
+  {
+    if (_interned || (_type != type_string) || !uses_string_pool::value)
+      {
+	return _interned;
+      }
+
+    const pooled_string *s;
+    if (!pool.acquire(get_char_sequence(), s))
+      {
+	return false;
+      }
+    clear();
+    _body.pooled = s;
+    _type = type_string;
+    _borrowed = true;
+    _interned = true;
+    return true;
+  }
+
+  template < typename Char, typename Traits, typename Allocator >
+  bool
+  basic_object<Char, Traits, Allocator>::is_interned() const
+  {
+    return _interned;
+  }
+
+  template < typename Char, typename Traits, typename Allocator >
+  bool
+  basic_object<Char, Traits, Allocator>::assign_interned(const char_sequence_type &s)
+  {
+    basic_string_pool<Char, Traits> *pool = basic_string_pool<Char, Traits>::current();
+    const pooled_string *pooled;
+    if ((pool == nullptr) || !uses_string_pool::value || !pool->acquire(s, pooled))
+      {
+	return false;
+      }
+    clear();
+    _body.pooled = pooled;
+    _type = type_string;
+    _borrowed = true;
+    _interned = true;
+    return true;
+  }
+
+  // Shares the pooled string 's' with another object, this object must be
+  // empty.
+  template < typename Char, typename Traits, typename Allocator >
+  void
+  basic_object<Char, Traits, Allocator>::make_interned(const pooled_string *s)
+  {
+    basic_string_pool<Char, Traits>::retain(s);
+    _body.pooled = s;
+    _type = type_string;
+    _borrowed = true;
+    _interned = true;
+  }
+
+  // The characters of an interned string, or the shared body of a list or
+  // map, are released once the new string has been stored, 's' may refer to
+  // them.
+  template < typename Char, typename Traits, typename Allocator >
+  template < typename String >
+  void
+  basic_object<Char, Traits, Allocator>::store_string(String &&s)
+  {
+    const pooled_string *const pooled = _interned ? _body.pooled : nullptr;
+    shared_body *const node = _shared ? _body.node : nullptr;
+    _body.assign_string(_type, _borrowed, _packed, _shared, std::forward<String>(s), _allocator);
+    if (_interned)
+      {
+	basic_string_pool<Char, Traits>::release(pooled);
+      }
+    if (_shared)
+      {
+	release_shared(node);
+      }
+    _type = type_string;
+    _borrowed = false;
+    _interned = false;
+    _packed = false;
+    _shared = false;
+  }
+
+  // Objects using a string pool hold strings of the type of the pooled ones,
+  // the others never hold pooled strings.
+  template < typename String >
+  const String *pooled_object_string(const String &s, std::true_type)
+  {
+    return &s;
+  }
+
+  template < typename String, typename Pooled >
+  const String *pooled_object_string(const Pooled &, std::false_type)
+  {
+    return nullptr;
+  }
+
+  // Allocators of different types are never the same, the interned keys of a
+  // map are only shared with objects released the usual way.
+  template < typename Allocator >
+  bool same_allocator(const Allocator &a1, const Allocator &a2)
+  {
+    return a1 == a2;
+  }
+
+  template < typename Allocator1, typename Allocator2 >
+  bool same_allocator(const Allocator1 &, const Allocator2 &)
+  {
+    return false;
+  }
+
+  template < typename Char, typename Traits, typename Allocator >
+  template < typename Object >
+  void
+  basic_object<Char, Traits, Allocator>::copy_body(const Object &obj)
+  {
+    if (obj._shared)
+      {
+	copy_shared(obj._body.node);
+	return;
+      }
+    switch (obj.type())
+      {
+      case type_string:
+	if (obj._interned && uses_string_pool::value)
+	  {
+	    make_interned(obj._body.pooled);
+	  }
+	else
+	  {
+	    const char_sequence_type s = obj.get_char_sequence();
+	    _body.create_string(s.data(), s.size(), _allocator);
+	    _type = type_string;
+	  }
+	break;
+
+      case type_list:
+	if (obj._packed)
+	  {
+	    const auto &values = obj._body.array.values;
+	    make_packed(obj._body.array.type,
+			native_list(values.begin(), values.end(), native_allocator(_allocator)));
+	    break;
+	  }
+	_body.create_list(_allocator);
+	_type = type_list;
+	for (const auto &x : obj.get_list())
+	  {
+	    _body.list.emplace_back(x, _allocator);
+	  }
+	break;
+
+      case type_map:
+	_body.create_map(_allocator);
+	_type = type_map;
+	for (const auto &x : obj.get_map())
+	  {
+	    if (x.first.interned() && same_allocator(_allocator, obj.get_allocator()))
+	      {
+		_body.map.emplace_interned(x.first, basic_object(x.second, _allocator));
+	      }
+	    else
+	      {
+		_body.map.emplace(x.first, basic_object(x.second, _allocator));
+	      }
+	  }
+	break;
+
+      case type_boolean:
+      case type_integer:
+      case type_unsigned:
+      case type_double:
+	_body.number.value = obj._body.number.value;
+	traits_type::copy(_body.number.text, obj._body.number.text, number_text_size);
+	_type = obj.type();
+	break;
+
+      case type_null:
+	break;
+      }
+  }
+
+  template < typename Char, typename Traits, typename Allocator >
+  void
+  basic_object<Char, Traits, Allocator>::own_string()
+  {
+    const char_sequence_type s = get_char_sequence();
+    const pooled_string *const pooled = _interned ? _body.pooled : nullptr;
+    _body.create_string(s.data(), s.size(), _allocator);
+    if (_interned)
+      {
+	basic_string_pool<Char, Traits>::release(pooled);
+      }
+    _borrowed = false;
+    _interned = false;
+  }
+
+  template < typename Char, typename Traits, typename Allocator >
+  void
+  basic_object<Char, Traits, Allocator>::make_number(const char_sequence_type &s)
+  {
+    native_value x;
+    const object_type type = decimal_to_native(s.data(), s.data() + s.size(), x,
+					       "json::basic_object<?>::make_number");
+    if (s.size() > number_text_size)
+      {
+	assign_native(type, x);
+	return;
+      }
+    clear();
+    _body.number.value = x;
+    assign_text(s.data(), s.size());
+    _type = type;
+  }
+
+  template < typename Char, typename Traits, typename Allocator >
+  typename basic_object<Char, Traits, Allocator>::char_sequence_type
+  basic_object<Char, Traits, Allocator>::get_char_sequence() const
+  {
+    switch (_type)
+      {
+      case type_string:
+	if (_interned)
+	  {
+	    return char_sequence_type(_body.pooled->string);
+	  }
+	if (_borrowed)
+	  {
+	    return _body.sequence;
+	  }
+	return char_sequence_type(_body.string);
+
+      case type_boolean:
+	return _body.number.value.boolean ? char_sequence_type("true") : char_sequence_type("false");
+
+      case type_integer:
+      case type_unsigned:
+      case type_double:
+	{
+	  const char_type *text = _body.number.text;
+	  return char_sequence_type(text, std::find(text, text + number_text_size, char_type()) - text);
+	}
+
+      case type_list:
+      case type_map:
+      case type_null:
+	break;
+      }
+    assert_type_is(type_string, "json::basic_object<?>::get_char_sequence");
+    return char_sequence_type();
+  }
+
+  template < typename Char, typename Traits, typename Allocator >
+  bool
+  basic_object<Char, Traits, Allocator>::get_boolean() const
+  {
+    assert_type_is(type_boolean, "json::basic_object<?>::get_boolean");
+    return _body.number.value.boolean;
+  }
+
+  template < typename Char, typename Traits, typename Allocator >
+  long long
+  basic_object<Char, Traits, Allocator>::get_integer() const
+  {
+    assert_type_is(type_integer, "json::basic_object<?>::get_integer");
+    return _body.number.value.integer;
+  }
+
+  template < typename Char, typename Traits, typename Allocator >
+  unsigned long long
+  basic_object<Char, Traits, Allocator>::get_unsigned() const
+  {
+    assert_type_is(type_unsigned, "json::basic_object<?>::get_unsigned");
+    return _body.number.value.unsigned_integer;
+  }
+
+  template < typename Char, typename Traits, typename Allocator >
+  double
+  basic_object<Char, Traits, Allocator>::get_double() const
+  {
+    assert_type_is(type_double, "json::basic_object<?>::get_double");
+    return _body.number.value.real;
   }
 
   template < typename Char, typename Traits, typename Allocator >
@@ -526,6 +971,288 @@ namespace json
 	_body.create_list(_allocator);
 	_type = type_list;
       }
+    else
+      {
+	unpack();
+      }
+  }
+
+  template < typename Char, typename Traits, typename Allocator >
+  bool
+  basic_object<Char, Traits, Allocator>::is_packed() const
+  {
+    return _shared ? shared_value().is_packed() : _packed;
+  }
+
+  template < typename Char, typename Traits, typename Allocator >
+  object_type
+  basic_object<Char, Traits, Allocator>::packed_type() const
+  {
+    if (_shared)
+      {
+	return shared_value().packed_type();
+      }
+    return _packed ? _body.array.type : type_null;
+  }
+
+  template < typename Char, typename Traits, typename Allocator >
+  bool
+  basic_object<Char, Traits, Allocator>::pack()
+  {
+    if (_shared && shared_value().is_packed())
+      {
+	return true;
+      }
+    unshare();
+    if ((_type != type_list) || _packed)
+      {
+	return _packed;
+      }
+
+    object_type type = type_integer;
+    for (const auto &x : _body.list)
+      {
+	switch (x.type())
+	  {
+	  case type_integer: break;
+	  case type_double:  type = type_double; break;
+	  default:           return false;
+	  }
+      }
+
+    native_list values (_allocator);
+    values.reserve(_body.list.size());
+    for (const auto &x : _body.list)
+      {
+	native_value v = x._body.number.value;
+	if ((type == type_double) && (x.type() == type_integer))
+	  {
+	    if (!is_exact_double(v.integer))
+	      {
+		return false;
+	      }
+	    v.real = static_cast<double>(v.integer);
+	  }
+	values.push_back(v);
+      }
+    make_packed(type, std::move(values));
+    return true;
+  }
+
+  template < typename Char, typename Traits, typename Allocator >
+  void
+  basic_object<Char, Traits, Allocator>::unpack()
+  {
+    if (_shared && shared_value().is_packed())
+      {
+	unshare();
+      }
+    if (_packed)
+      {
+	const packed_list &array = _body.array;
+	object_list list (_allocator);
+	list.reserve(array.values.size());
+	for (const native_value &x : array.values)
+	  {
+	    list.emplace_back(_allocator);
+	    list.back().assign_native(array.type, x);
+	  }
+	_body.destroy_packed();
+	_body.create_list(std::move(list));
+	_packed = false;
+      }
+  }
+
+  template < typename Char, typename Traits, typename Allocator >
+  void
+  basic_object<Char, Traits, Allocator>::make_packed(const object_type type, native_list &&values)
+  {
+    if ((type != type_integer) && (type != type_double))
+      {
+	error_json_object_invalid_type(this, type_double, type,
+				       "json::basic_object<?>::make_packed");
+      }
+    clear();
+    if (values.get_allocator() == native_allocator(_allocator))
+      {
+	_body.create_packed(packed_list { std::move(values), type });
+      }
+    else
+      {
+	_body.create_packed(packed_list { native_list(values.begin(), values.end(), native_allocator(_allocator)), type });
+      }
+    _type = type_list;
+    _packed = true;
+  }
+
+  template < typename Char, typename Traits, typename Allocator >
+  span<const long long>
+  basic_object<Char, Traits, Allocator>::get_integers() const
+  {
+    if (_shared)
+      {
+	return shared_value().get_integers();
+      }
+    assert_packed_type_is(type_integer, "json::basic_object<?>::get_integers");
+    const native_list &values = _body.array.values;
+    return span<const long long>(reinterpret_cast<const long long *>(values.data()), values.size());
+  }
+
+  template < typename Char, typename Traits, typename Allocator >
+  span<long long>
+  basic_object<Char, Traits, Allocator>::get_integers()
+  {
+    unshare();
+    assert_packed_type_is(type_integer, "json::basic_object<?>::get_integers");
+    native_list &values = _body.array.values;
+    return span<long long>(reinterpret_cast<long long *>(values.data()), values.size());
+  }
+
+  template < typename Char, typename Traits, typename Allocator >
+  span<const double>
+  basic_object<Char, Traits, Allocator>::get_doubles() const
+  {
+    if (_shared)
+      {
+	return shared_value().get_doubles();
+      }
+    assert_packed_type_is(type_double, "json::basic_object<?>::get_doubles");
+    const native_list &values = _body.array.values;
+    return span<const double>(reinterpret_cast<const double *>(values.data()), values.size());
+  }
+
+  template < typename Char, typename Traits, typename Allocator >
+  span<double>
+  basic_object<Char, Traits, Allocator>::get_doubles()
+  {
+    unshare();
+    assert_packed_type_is(type_double, "json::basic_object<?>::get_doubles");
+    native_list &values = _body.array.values;
+    return span<double>(reinterpret_cast<double *>(values.data()), values.size());
+  }
+
+  template < typename Char, typename Traits, typename Allocator >
+  bool
+  basic_object<Char, Traits, Allocator>::is_shared() const
+  {
+    return _shared;
+  }
+
+  template < typename Char, typename Traits, typename Allocator >
+  void
+  basic_object<Char, Traits, Allocator>::share(basic_object &obj)
+  {
+    if ((&obj == this) || (_shared && obj._shared && (_body.node == obj._body.node)))
+      {
+	return;
+      }
+    if (((obj._type != type_list) && (obj._type != type_map)) || !(_allocator == obj._allocator))
+      {
+	*this = obj;
+	return;
+      }
+    obj.make_shared();
+
+    // 'obj' may be a member of this object.
+    basic_object tmp (_allocator);
+    tmp.share_body(obj._body.node);
+    swap(tmp);
+  }
+
+  template < typename Char, typename Traits, typename Allocator >
+  const basic_object<Char, Traits, Allocator> &
+  basic_object<Char, Traits, Allocator>::shared_value() const
+  {
+    return _body.node->value;
+  }
+
+  // Moves the list or map of the object to a shared body.
+  template < typename Char, typename Traits, typename Allocator >
+  void
+  basic_object<Char, Traits, Allocator>::make_shared()
+  {
+    if (!_shared)
+      {
+	shared_allocator a (_allocator);
+	shared_body *const node = a.allocate(1);
+	new (node) shared_body (_allocator);
+	node->value.swap(*this);
+	_body.node = node;
+	_type = node->value._type;
+	_shared = true;
+      }
+  }
+
+  // Shares the body 'node' with another object, this object must be empty.
+  template < typename Char, typename Traits, typename Allocator >
+  void
+  basic_object<Char, Traits, Allocator>::share_body(shared_body *node)
+  {
+    node->references.fetch_add(1, std::memory_order_relaxed);
+    _body.node = node;
+    _type = node->value._type;
+    _shared = true;
+  }
+
+  // Shared bodies are only shared with objects of the same allocator, the
+  // others get a copy.
+  template < typename Char, typename Traits, typename Allocator >
+  void
+  basic_object<Char, Traits, Allocator>::copy_shared(shared_body *node)
+  {
+    if (same_allocator(_allocator, node->value._allocator))
+      {
+	share_body(node);
+      }
+    else
+      {
+	copy_body(node->value);
+      }
+  }
+
+  template < typename Char, typename Traits, typename Allocator >
+  template < typename Body >
+  void
+  basic_object<Char, Traits, Allocator>::copy_shared(const Body *node)
+  {
+    copy_body(node->value);
+  }
+
+  template < typename Char, typename Traits, typename Allocator >
+  void
+  basic_object<Char, Traits, Allocator>::release_shared(shared_body *node) const
+  {
+    if (node->references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+      {
+	shared_allocator a (_allocator);
+	node->~shared_body();
+	a.deallocate(node, 1);
+      }
+  }
+
+  // Gives the object its own copy of a shared body before it is modified,
+  // the body is taken over when no other object shares it anymore.
+  template < typename Char, typename Traits, typename Allocator >
+  void
+  basic_object<Char, Traits, Allocator>::unshare()
+  {
+    if (_shared)
+      {
+	shared_body *const node = _body.node;
+	basic_object value (_allocator);
+	if (node->references.load(std::memory_order_acquire) == 1)
+	  {
+	    value.swap(node->value);
+	  }
+	else
+	  {
+	    basic_object(node->value).swap(value);
+	  }
+	release_shared(node);
+	_type = type_null;
+	_shared = false;
+	swap(value);
+      }
   }
 
   template < typename Char, typename Traits, typename Allocator >
@@ -545,6 +1272,10 @@ namespace json
   basic_object<Char, Traits, Allocator>::get_string()
   {
     assert_type_is(type_string, "json::basic_object<?>::get_string");
+    if (_borrowed)
+      {
+	own_string();
+      }
     return _body.string;
   }
 
@@ -553,6 +1284,14 @@ namespace json
   basic_object<Char, Traits, Allocator>::get_string() const
   {
     assert_type_is(type_string, "json::basic_object<?>::get_string");
+    if (_interned)
+      {
+	return *pooled_object_string<object_string>(_body.pooled->string, uses_string_pool());
+      }
+    if (_borrowed)
+      {
+	error_json_object_borrowed_string(this, "json::basic_object<?>::get_string");
+      }
     return _body.string;
   }
 
@@ -561,6 +1300,8 @@ namespace json
   basic_object<Char, Traits, Allocator>::get_list()
   {
     assert_type_is(type_list, "json::basic_object<?>::get_list");
+    unshare();
+    unpack();
     return _body.list;
   }
 
@@ -569,6 +1310,14 @@ namespace json
   basic_object<Char, Traits, Allocator>::get_list() const
   {
     assert_type_is(type_list, "json::basic_object<?>::get_list");
+    if (_shared)
+      {
+	return shared_value().get_list();
+      }
+    if (_packed)
+      {
+	error_json_object_packed(this, "json::basic_object<?>::get_list");
+      }
     return _body.list;
   }
 
@@ -577,6 +1326,7 @@ namespace json
   basic_object<Char, Traits, Allocator>::get_map()
   {
     assert_type_is(type_map, "json::basic_object<?>::get_map");
+    unshare();
     return _body.map;
   }
 
@@ -585,6 +1335,10 @@ namespace json
   basic_object<Char, Traits, Allocator>::get_map() const
   {
     assert_type_is(type_map, "json::basic_object<?>::get_map");
+    if (_shared)
+      {
+	return shared_value().get_map();
+      }
     return _body.map;
   }
 
@@ -592,12 +1346,18 @@ namespace json
   typename basic_object<Char, Traits, Allocator>::iterator
   basic_object<Char, Traits, Allocator>::begin()
   {
+    unshare();
+    unpack();
     switch (_type)
       {
-      case type_list:   return iterator(_body.list.begin(), 0, _body.list.size());
-      case type_map:    return iterator(_body.map.begin(), 0, _body.map.size());
-      case type_string: break;
-      case type_null:   break;
+      case type_list:     return iterator(_body.list.begin(), 0, _body.list.size());
+      case type_map:      return iterator(_body.map.begin(), 0, _body.map.size());
+      case type_string:
+      case type_boolean:
+      case type_integer:
+      case type_unsigned:
+      case type_double:
+      case type_null:     break;
       }
     return iterator();
   }
@@ -606,12 +1366,18 @@ namespace json
   typename basic_object<Char, Traits, Allocator>::iterator
   basic_object<Char, Traits, Allocator>::end()
   {
+    unshare();
+    unpack();
     switch (_type)
       {
-      case type_list:   return iterator(_body.list.end(), _body.list.size(), _body.list.size());
-      case type_map:    return iterator(_body.map.end(), _body.map.size(), _body.map.size());
-      case type_string: break;
-      case type_null:   break;
+      case type_list:     return iterator(_body.list.end(), _body.list.size(), _body.list.size());
+      case type_map:      return iterator(_body.map.end(), _body.map.size(), _body.map.size());
+      case type_string:
+      case type_boolean:
+      case type_integer:
+      case type_unsigned:
+      case type_double:
+      case type_null:     break;
       }
     return iterator();
   }
@@ -620,12 +1386,25 @@ namespace json
   typename basic_object<Char, Traits, Allocator>::const_iterator
   basic_object<Char, Traits, Allocator>::begin() const
   {
+    if (_shared)
+      {
+	return shared_value().begin();
+      }
+    if (_packed)
+      {
+	const native_list &values = _body.array.values;
+	return const_iterator(values.data(), _body.array.type, 0, values.size());
+      }
     switch (_type)
       {
-      case type_list:   return const_iterator(_body.list.begin(), 0, _body.list.size());
-      case type_map:    return const_iterator(_body.map.begin(), 0, _body.map.size());
-      case type_string: break;
-      case type_null:   break;
+      case type_list:     return const_iterator(_body.list.begin(), 0, _body.list.size());
+      case type_map:      return const_iterator(_body.map.begin(), 0, _body.map.size());
+      case type_string:
+      case type_boolean:
+      case type_integer:
+      case type_unsigned:
+      case type_double:
+      case type_null:     break;
       }
     return const_iterator();
   }
@@ -634,16 +1413,94 @@ namespace json
   typename basic_object<Char, Traits, Allocator>::const_iterator
   basic_object<Char, Traits, Allocator>::end() const
   {
+    if (_shared)
+      {
+	return shared_value().end();
+      }
+    if (_packed)
+      {
+	const native_list &values = _body.array.values;
+	return const_iterator(values.data(), _body.array.type, _body.array.values.size(), values.size());
+      }
     switch (_type)
       {
-      case type_list:   return const_iterator(_body.list.end(), _body.list.size(), _body.list.size());
-      case type_map:    return const_iterator(_body.map.end(), _body.map.size(), _body.map.size());
-      case type_string: break;
-      case type_null:   break;
+      case type_list:     return const_iterator(_body.list.end(), _body.list.size(), _body.list.size());
+      case type_map:      return const_iterator(_body.map.end(), _body.map.size(), _body.map.size());
+      case type_string:
+      case type_boolean:
+      case type_integer:
+      case type_unsigned:
+      case type_double:
+      case type_null:     break;
       }
     return const_iterator();
   }
 
+  // Numbers which are not read from a text hold the text of their value, so
+  // that it can be returned by the const get_char_sequence.
+  template < typename Char, typename Traits, typename Allocator >
+  void
+  basic_object<Char, Traits, Allocator>::
+  assign_native(const object_type type, const native_value &x)
+  {
+    clear();
+    _body.number.value = x;
+    if (is_number_type(type))
+      {
+	char str[number_text_size];
+	assign_text(str, format_number(type, x, str));
+      }
+    _type = type;
+  }
+
+  template < typename Char, typename Traits, typename Allocator >
+  template < typename Text >
+  void
+  basic_object<Char, Traits, Allocator>::assign_text(const Text *s, const std::size_t n)
+  {
+    std::copy(s, s + n, _body.number.text);
+    if (n != number_text_size)
+      {
+	_body.number.text[n] = char_type();
+      }
+  }
+
+  template < typename Char, typename Traits, typename Allocator >
+  void
+  basic_object<Char, Traits, Allocator>::assign_number(const long long x)
+  {
+    native_value v;
+    v.integer = x;
+    assign_native(type_integer, v);
+  }
+
+  // Unsigned integers which fit in a long long are stored like the signed
+  // ones, so that equal numbers always have the same type.
+  template < typename Char, typename Traits, typename Allocator >
+  void
+  basic_object<Char, Traits, Allocator>::assign_number(const unsigned long long x)
+  {
+    if (x <= static_cast<unsigned long long>(std::numeric_limits<long long>::max()))
+      {
+	assign_number(static_cast<long long>(x));
+      }
+    else
+      {
+	native_value v;
+	v.unsigned_integer = x;
+	assign_native(type_unsigned, v);
+      }
+  }
+
+  template < typename Char, typename Traits, typename Allocator >
+  void
+  basic_object<Char, Traits, Allocator>::assign_number(const double x)
+  {
+    native_value v;
+    v.real = x;
+    assign_native(type_double, v);
+  }
+
   template < typename Char, typename Traits, typename Allocator >
   void
   basic_object<Char, Traits, Allocator>::
@@ -655,6 +1512,21 @@ namespace json
       }
   }
 
+  template < typename Char, typename Traits, typename Allocator >
+  void
+  basic_object<Char, Traits, Allocator>::
+  assert_packed_type_is(const object_type type, const char *function) const
+  {
+    if (!_packed)
+      {
+	error_json_object_invalid_type(this, type, _type, function);
+      }
+    if (type != _body.array.type)
+      {
+	error_json_object_invalid_type(this, type, _body.array.type, function);
+      }
+  }
+
   template < typename Char,
 	     typename Traits,
 	     typename Allocator1,
@@ -662,7 +1534,8 @@ namespace json
   bool equals_address(const basic_object<Char, Traits, Allocator1> &obj1,
 		      const basic_object<Char, Traits, Allocator2> &obj2)
   {
-    return std::addressof(obj1) == std::addressof(obj2);
+    return static_cast<const void *>(std::addressof(obj1))
+      == static_cast<const void *>(std::addressof(obj2));
   }
 
   template < typename Char,
@@ -672,8 +1545,119 @@ namespace json
   bool equals_string(const basic_object<Char, Traits, Allocator1> &obj1,
 		     const basic_object<Char, Traits, Allocator2> &obj2)
   {
-    typedef basic_char_sequence<Char, Traits> char_sequence;
-    return char_sequence(obj1.get_string()) == char_sequence(obj2.get_string());
+    if (obj1._interned && obj2._interned)
+      {
+	if (obj1._body.pooled == obj2._body.pooled)
+	  {
+	    return true;
+	  }
+	if (basic_string_pool<Char, Traits>::same_pool(obj1._body.pooled, obj2._body.pooled))
+	  {
+	    return false;
+	  }
+      }
+    return obj1.get_char_sequence() == obj2.get_char_sequence();
+  }
+
+  template < typename Char, typename Traits, typename Allocator >
+  long double number_value(const basic_object<Char, Traits, Allocator> &obj)
+  {
+    switch (obj.type())
+      {
+      case type_integer:  return obj.get_integer();
+      case type_unsigned: return obj.get_unsigned();
+      default:            return obj.get_double();
+      }
+  }
+
+  // Integers and unsigned never hold the same value (see object_type), a
+  // long double holds any 64 bits integer to compare them with doubles.
+  template < typename Char,
+	     typename Traits,
+	     typename Allocator1,
+	     typename Allocator2 >
+  bool equals_number(const basic_object<Char, Traits, Allocator1> &obj1,
+		     const basic_object<Char, Traits, Allocator2> &obj2)
+  {
+    if ((obj1.type() == type_double) || (obj2.type() == type_double))
+      {
+	return number_value(obj1) == number_value(obj2);
+      }
+    if (obj1.type() != obj2.type())
+      {
+	return false;
+      }
+    if (obj1.type() == type_integer)
+      {
+	return obj1.get_integer() == obj2.get_integer();
+      }
+    return obj1.get_unsigned() == obj2.get_unsigned();
+  }
+
+  template < typename Char, typename Traits, typename Allocator >
+  long double packed_value(const basic_object<Char, Traits, Allocator> &obj, const std::size_t index)
+  {
+    if (obj.packed_type() == type_integer)
+      {
+	return obj.get_integers()[index];
+      }
+    return obj.get_doubles()[index];
+  }
+
+  // Compares a list, packed or not, to a packed list without unpacking
+  // them, the numbers are compared by value like in equals_number.
+  template < typename Char,
+	     typename Traits,
+	     typename Allocator1,
+	     typename Allocator2 >
+  bool equals_packed(const basic_object<Char, Traits, Allocator1> &obj,
+		     const basic_object<Char, Traits, Allocator2> &packed)
+  {
+    const std::size_t n = packed.size();
+    if (obj.size() != n)
+      {
+	return false;
+      }
+
+    const bool integers = packed.packed_type() == type_integer;
+    if (obj.is_packed())
+      {
+	if (obj.packed_type() == packed.packed_type())
+	  {
+	    return integers
+	      ? std::equal(packed.get_integers().begin(), packed.get_integers().end(), obj.get_integers().begin())
+	      : std::equal(packed.get_doubles().begin(), packed.get_doubles().end(), obj.get_doubles().begin());
+	  }
+	for (std::size_t i = 0; i != n; ++i)
+	  {
+	    if (packed_value(obj, i) != packed_value(packed, i))
+	      {
+		return false;
+	      }
+	  }
+	return true;
+      }
+
+    auto it = obj.get_list().begin();
+    for (std::size_t i = 0; i != n; ++i, ++it)
+      {
+	if (!is_number(*it))
+	  {
+	    return false;
+	  }
+	if (integers && (it->type() == type_integer))
+	  {
+	    if (it->get_integer() != packed.get_integers()[i])
+	      {
+		return false;
+	      }
+	  }
+	else if (number_value(*it) != packed_value(packed, i))
+	  {
+	    return false;
+	  }
+      }
+    return true;
   }
 
   template < typename Char,
@@ -683,8 +1667,20 @@ namespace json
   bool equals_list(const basic_object<Char, Traits, Allocator1> &obj1,
 		   const basic_object<Char, Traits, Allocator2> &obj2)
   {
+    if (obj2.is_packed())
+      {
+	return equals_packed(obj1, obj2);
+      }
+    if (obj1.is_packed())
+      {
+	return equals_packed(obj2, obj1);
+      }
     auto &list1 = obj1.get_list();
     auto &list2 = obj2.get_list();
+    if (static_cast<const void *>(&list1) == static_cast<const void *>(&list2))
+      {
+	return true;
+      }
     if (list1.size() != list2.size())
       {
 	return false;
@@ -713,6 +1709,10 @@ namespace json
   {
     auto &map1 = obj1.get_map();
     auto &map2 = obj2.get_map();
+    if (static_cast<const void *>(&map1) == static_cast<const void *>(&map2))
+      {
+	return true;
+      }
     if (map1.size() != map2.size())
       {
 	return false;
@@ -741,16 +1741,24 @@ namespace json
   {
     if (!equals_address(obj1, obj2))
       {
+	if (is_number_type(obj1.type()) && is_number_type(obj2.type()))
+	  {
+	    return equals_number(obj1, obj2);
+	  }
 	if (obj1.type() != obj2.type())
 	  {
 	    return false;
 	  }
 	switch (obj1.type())
 	  {
-	  case type_null:   return true;
-	  case type_string: return equals_string(obj1, obj2);
-	  case type_list:   return equals_list(obj1, obj2);
-	  case type_map:    return equals_map(obj1, obj2);
+	  case type_null:     return true;
+	  case type_string:   return equals_string(obj1, obj2);
+	  case type_list:     return equals_list(obj1, obj2);
+	  case type_map:      return equals_map(obj1, obj2);
+	  case type_boolean:  return obj1.get_boolean() == obj2.get_boolean();
+	  case type_integer:
+	  case type_unsigned:
+	  case type_double:   break;
 	  }
       }
     return true;
@@ -782,8 +1790,7 @@ namespace json
   bool operator==(const basic_object<Char, Traits, Allocator> &obj,
 		  const basic_char_sequence<Char, Traits> &str)
   {
-    typedef basic_char_sequence<Char, Traits> char_sequence;
-    return (obj.type() == type_string) && (char_sequence(obj.get_string()) == str);
+    return (obj.type() == type_string) && (obj.get_char_sequence() == str);
   }
 
   template < typename Char,
@@ -792,8 +1799,7 @@ namespace json
   bool operator!=(const basic_object<Char, Traits, Allocator> &obj,
 		  const basic_char_sequence<Char, Traits> &str)
   {
-    typedef basic_char_sequence<Char, Traits> char_sequence;
-    return (obj.type() != type_string) || (char_sequence(obj.get_string()) != str);
+    return !(obj == str);
   }
 
   template < typename Char,
@@ -0,0 +1,194 @@
+/*
+ * Copyright 2012 Achille Roussel.
+ *
+ * This file is part of Libjson++.
+ *
+ * Libjson++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Libjson++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <thread>
+#include <vector>
+#include "json/error.h"
+#include "json/parallel_reader.h"
+#include "json/buffer_reader.hpp"
+#include "json/object.hpp"
+
+namespace json
+{
+
+  namespace
+  {
+
+    enum
+      {
+	// Each thread parses a few ranges so that the work stays balanced when
+	// the elements don't all take the same time to parse.
+	ranges_per_thread = 4
+      };
+
+    struct element_range
+    {
+      const char		*first;
+      std::size_t		count;
+      object::object_list	list;
+      std::exception_ptr	error;
+    };
+
+    // Finds the elements of the list starting at 'first' and splits them in
+    // ranges of about 'range_size' bytes, returns a pointer to the character
+    // following the list.
+    const char *split_list(const char *first,
+			   const char *last,
+			   const std::size_t range_size,
+			   std::vector<element_range> &ranges)
+    {
+      first = buffer_next_char(first + 1, last); // consumes '['
+      if ((*first) == ']')
+	{
+	  return first + 1;
+	}
+
+      for (;;)
+	{
+	  if (ranges.empty() || ((first - ranges.back().first) >= static_cast<std::ptrdiff_t>(range_size)))
+	    {
+	      ranges.push_back(element_range());
+	      ranges.back().first = first;
+	      ranges.back().count = 0;
+	    }
+	  ++ranges.back().count;
+
+	  first = buffer_skip_value(first, last);
+	  first = buffer_next_char(first, last);
+	  switch (*first)
+	    {
+	    case ',': first = buffer_next_char(first + 1, last); break;
+	    case ']': return first + 1;
+	    default:  error_invalid_input_non_json();
+	    }
+	}
+    }
+
+    void read_range(const char *last, element_range &range)
+    {
+      try
+	{
+	  const char *first = range.first;
+	  range.list.reserve(range.count);
+	  for (std::size_t i = 0; i != range.count; ++i)
+	    {
+	      range.list.emplace_back();
+	      first = read_buffer(first, last, range.list.back());
+	      first = buffer_next_char(first, last);
+	      if ((*first) == ',')
+		{
+		  ++first;
+		}
+	    }
+	}
+      catch (...)
+	{
+	  range.error = std::current_exception();
+	}
+    }
+
+  }
+
+  object read_parallel(const char *first, const char *last, unsigned threads)
+  {
+    object obj;
+
+    first = buffer_next_char(first, last);
+    if ((*first) != '[')
+      {
+	read_buffer(first, last, obj);
+	return obj;
+      }
+
+    if (threads == 0)
+      {
+	threads = std::max(1u, std::thread::hardware_concurrency());
+      }
+
+    std::vector<element_range> ranges;
+    split_list(first, last, (last - first) / (threads * ranges_per_thread) + 1, ranges);
+
+    std::atomic<std::size_t> next (0);
+    const bool packing = packing_scope::enabled();
+    auto work = [&]() {
+      const packing_scope scope (packing);
+      for (std::size_t i = next++; i < ranges.size(); i = next++)
+	{
+	  read_range(last, ranges[i]);
+	}
+    };
+
+    // When a thread can't be created the workers already started are joined
+    // before the exception is propagated, the ranges they are reading live on
+    // this stack.
+    std::vector<std::thread> workers;
+    try
+      {
+	for (unsigned i = 1; (i < threads) && (i < ranges.size()); ++i)
+	  {
+	    workers.emplace_back(work);
+	  }
+      }
+    catch (...)
+      {
+	for (auto &worker : workers)
+	  {
+	    worker.join();
+	  }
+	throw;
+      }
+    work();
+    for (auto &worker : workers)
+      {
+	worker.join();
+      }
+
+    std::size_t count = 0;
+    for (const auto &range : ranges)
+      {
+	if (range.error)
+	  {
+	    std::rethrow_exception(range.error);
+	  }
+	count += range.count;
+      }
+
+    obj.make_list();
+    auto &list = obj.get_list();
+    list.reserve(count);
+    for (auto &range : ranges)
+      {
+	for (auto &element : range.list)
+	  {
+	    list.push_back(std::move(element));
+	  }
+	object::object_list().swap(range.list);
+      }
+    return obj;
+  }
+
+  object read_parallel(const std::string &str, const unsigned threads)
+  {
+    return read_parallel(str.c_str(), str.c_str() + str.size(), threads);
+  }
+
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright 2012 Achille Roussel.
+ *
+ * This file is part of Libjson++.
+ *
+ * Libjson++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Libjson++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JSON_PARALLEL_READER_H
+#define JSON_PARALLEL_READER_H
+
+#include <string>
+#include "json/def.h"
+
+namespace json
+{
+
+  /**
+   * @brief Reads a JSON document made of a large top-level list with several
+   * threads.
+   *
+   * The buffer is first scanned once to find where the elements of the list
+   * start, brackets are matched and strings skipped without building
+   * anything. The elements are then split in ranges of about the same size
+   * which are parsed concurrently with <em>json::read_buffer</em>, each
+   * thread building the elements of the ranges it takes. The resulting list
+   * is assembled by moving the elements, in the order of the input.
+   * <br/>
+   * A document which isn't a list is read by the calling thread.
+   *
+   * @param first A pointer to the first character of the buffer.
+   * @param last A pointer to the end of the buffer, <em>*last</em> must be
+   * readable and equal to '\\0' (see <em>json::read_buffer</em>), which is
+   * the case for STL strings and <em>json::mapped_file</em>.
+   * @param threads The number of threads to use, zero uses one thread per
+   * hardware thread.
+   *
+   * @return The function returns the newly created instance of <em>json::object</em>.
+   *
+   * @note If several elements are invalid the error of the first one is
+   * thrown.
+   */
+  object read_parallel(const char *first, const char *last, unsigned threads = 0);
+
+  object read_parallel(const std::string &str, unsigned threads = 0);
+
+}
+
+#endif // JSON_PARALLEL_READER_H
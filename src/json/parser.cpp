@@ -0,0 +1,227 @@
+/*
+ * Copyright 2012 Achille Roussel.
+ *
+ * This file is part of Libjson++.
+ *
+ * Libjson++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Libjson++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include "json/buffer_reader.hpp"
+#include "json/object.hpp"
+#include "json/parser.h"
+
+namespace json
+{
+
+  parser::parser():
+    _keys(nullptr),
+    _key(),
+    _input(),
+    _seen()
+  {
+  }
+
+  parser::parser(key_table &keys):
+    _keys(&keys),
+    _key(),
+    _input(),
+    _seen()
+  {
+  }
+
+  const char *parser::parse(const char *first, const char *last, object &obj)
+  {
+    _seen.clear();
+    parse_value(first, last, obj);
+    return first;
+  }
+
+  void parser::parse(const char *str, object &obj)
+  {
+    parse(str, str + std::strlen(str), obj);
+  }
+
+  void parser::parse(const std::string &str, object &obj)
+  {
+    parse(str.c_str(), str.c_str() + str.size(), obj);
+  }
+
+  void parser::parse(const char_sequence &str, object &obj)
+  {
+    // The buffer reader needs a '\0' after the input.
+    _input.assign(str.data(), str.size());
+    parse(_input.c_str(), _input.c_str() + _input.size(), obj);
+  }
+
+  void parser::parse_value(const char *&first, const char *last, object &obj)
+  {
+    first = buffer_next_char(first, last);
+    switch (*first)
+      {
+      case '[': parse_list(first, last, obj); break;
+      case '{': parse_map(first, last, obj);  break;
+
+      case 't':
+	buffer_read_equals(first, last, "true");
+	obj = true;
+	break;
+
+      case 'f':
+	buffer_read_equals(first, last, "false");
+	obj = false;
+	break;
+
+      case 'n':
+	buffer_read_equals(first, last, "null");
+	obj.make_null();
+	break;
+
+      case '"':
+	if (string_pool::current() == nullptr)
+	  {
+	    obj.make_string();
+	    obj.get_string().clear();
+	    buffer_read_string(++first, last, obj.get_string());
+	  }
+	else
+	  {
+	    obj = buffer_read_key(first, last, _key);
+	  }
+	break;
+
+      default:
+	const char *number = first;
+	first = buffer_read_number(first);
+	obj.make_number(char_sequence(number, first - number));
+      }
+  }
+
+  // The members already in the list are parsed over, the list is only
+  // extended or truncated when the number of members changes.
+  void parser::parse_list(const char *&first, const char *last, object &obj)
+  {
+    obj.make_list();
+    auto &list = obj.get_list();
+    std::size_t n = 0;
+
+    first = buffer_next_char(first + 1, last); // consumes '['
+    if ((*first) != ']')
+      {
+	for (;;)
+	  {
+	    if (n == list.size())
+	      {
+		list.emplace_back(obj.get_allocator());
+	      }
+	    parse_value(first, last, list[n++]);
+	    first = buffer_next_char(first, last);
+	    if ((*first) == ']')
+	      {
+		break;
+	      }
+	    if ((*first) != ',')
+	      {
+		error_invalid_input_non_json();
+	      }
+	    ++first;
+	  }
+      }
+    ++first;
+
+    if (n != list.size())
+      {
+	list.erase(list.begin() + n, list.end());
+      }
+  }
+
+  // Members whose key is already in the map are parsed over. The characters
+  // of the keys found in the input are recorded (they don't move when the map
+  // grows) so the members that disappeared can be removed at the end.
+  void parser::parse_map(const char *&first, const char *last, object &obj)
+  {
+    obj.make_map();
+    auto &map = obj.get_map();
+    const std::size_t mark = _seen.size();
+
+    first = buffer_next_char(first + 1, last); // consumes '{'
+    if ((*first) != '}')
+      {
+	for (;;)
+	  {
+	    if ((*first) != '"')
+	      {
+		error_invalid_input_non_json();
+	      }
+	    const char_sequence k = buffer_read_key(first, last, _key);
+	    first = buffer_next_char(first, last);
+	    if ((*first) != ':')
+	      {
+		error_invalid_input_non_json();
+	      }
+	    ++first;
+
+	    auto it = map.find(k);
+	    if (it == map.end())
+	      {
+		it = (_keys == nullptr) ?
+		  map.emplace(k, object(obj.get_allocator())) :
+		  map.emplace_interned(_keys->intern(k), object(obj.get_allocator()));
+	      }
+	    _seen.push_back(it->first.data());
+	    parse_value(first, last, it->second);
+
+	    first = buffer_next_char(first, last);
+	    if ((*first) == '}')
+	      {
+		break;
+	      }
+	    if ((*first) != ',')
+	      {
+		error_invalid_input_non_json();
+	      }
+	    first = buffer_next_char(first + 1, last);
+	  }
+      }
+    ++first;
+
+    remove_unseen_keys(map, mark);
+  }
+
+  void parser::remove_unseen_keys(object::object_map &map, const std::size_t mark)
+  {
+    const auto begin = _seen.begin() + mark;
+    std::sort(begin, _seen.end());
+    const auto end = std::unique(begin, _seen.end());
+
+    if (static_cast<std::size_t>(end - begin) != map.size())
+      {
+	auto it = map.begin();
+	while (it != map.end())
+	  {
+	    if (std::binary_search(begin, end, it->first.data()))
+	      {
+		++it;
+	      }
+	    else
+	      {
+		it = map.erase(it);
+	      }
+	  }
+      }
+    _seen.resize(mark);
+  }
+
+}
@@ -0,0 +1,108 @@
+/*
+ * Copyright 2012 Achille Roussel.
+ *
+ * This file is part of Libjson++.
+ *
+ * Libjson++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Libjson++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JSON_PARSER_H
+#define JSON_PARSER_H
+
+#include <string>
+#include <vector>
+#include "json/def.h"
+#include "json/object.h"
+
+namespace json
+{
+
+  /**
+   * @brief A JSON parser keeping its buffers from one document to the next.
+   *
+   * <em>json::read</em> builds every document from scratch, a parser instead
+   * reuses the storage of the object it parses into: the members of lists,
+   * the keys and slots of maps and the characters of strings which already
+   * exist in the destination are overwritten in place, only the members that
+   * don't appear in the new document are destroyed. The scratch buffers of
+   * the parser itself (unescaped keys, copies of the input) are kept between
+   * calls too.
+   * <br/>
+   * In a loop parsing messages of the same shape into the same object, the
+   * parser stops allocating memory once the first message has been parsed:
+   * <pre>
+   * json::parser parser;
+   * json::object obj;
+   * while (next_message(payload))
+   *   {
+   *     parser.parse(payload, obj);
+   *     handle(obj);
+   *   }
+   * </pre>
+   *
+   * A parser constructed with a <em>json::key_table</em> interns the keys
+   * of the maps it creates in the table.
+   *
+   * @note The functions throw a <em>json::error</em> if the input is not
+   * valid JSON, the destination object is then left in an unspecified but
+   * valid state. Like <em>json::read</em>, parsing stops at the end of the
+   * first value of the input.
+   */
+  class parser
+  {
+
+  public:
+
+    parser();
+
+    explicit parser(key_table &keys);
+
+    /**
+     * @brief Parses the buffer into 'obj', see <em>json::read_buffer</em>
+     * for the requirements on the buffer.
+     *
+     * @return The function returns a pointer to the first character
+     * following the parsed value.
+     */
+    const char *parse(const char *first, const char *last, object &obj);
+
+    void parse(const char *str, object &obj);
+
+    void parse(const std::string &str, object &obj);
+
+    void parse(const char_sequence &str, object &obj);
+
+  private:
+    parser(const parser &) = delete;
+
+    parser &operator=(const parser &) = delete;
+
+    void parse_value(const char *&first, const char *last, object &obj);
+
+    void parse_list(const char *&first, const char *last, object &obj);
+
+    void parse_map(const char *&first, const char *last, object &obj);
+
+    void remove_unseen_keys(object::object_map &map, std::size_t mark);
+
+    key_table *			_keys;
+    std::string			_key;
+    std::string			_input;
+    std::vector<const char *>	_seen;
+
+  };
+
+}
+
+#endif // JSON_PARSER_H
@@ -31,6 +31,10 @@ namespace json
 
   long long stoll(const object &obj);
 
+  unsigned long stoul(const object &obj);
+
+  unsigned long long stoull(const object &obj);
+
   float stof(const object &obj);
 
   double stod(const object &obj);
@@ -20,11 +20,12 @@
 #ifndef JSON_PARSING_HPP
 #define JSON_PARSING_HPP
 
-#include <tuple>
 #include <cmath>
 #include <cctype>
 #include <iosfwd>
 #include <iterator>
+#include <string>
+#include "json/types.h"
 #include "json/parsing.h"
 
 namespace json
@@ -36,6 +37,8 @@ namespace json
 
   void error_parsing_non_digit(const char *function);
 
+  void error_parsing_out_of_range(const char *function);
+
   template < typename Iterable >
   auto begin(Iterable &&it) -> decltype(std::begin(*it))
   {
@@ -105,68 +108,119 @@ namespace json
       }
   }
 
+  /**
+   * @brief Converts a JSON number to an integer.
+   *
+   * The digits are converted eight at a time when the input is long enough,
+   * by loading them in a 64 bits word and combining them with three
+   * multiplications (SWAR). Values which don't fit in the destination type
+   * are detected exactly and reported with an exception instead of
+   * wrapping around. A number with a fraction or an exponent is converted
+   * exactly then truncated toward zero.
+   */
+  void decimal_to_number(const char *first, const char *last, int &x, const char *function);
+
+  void decimal_to_number(const char *first, const char *last, long &x, const char *function);
+
+  void decimal_to_number(const char *first, const char *last, long long &x, const char *function);
+
+  void decimal_to_number(const char *first, const char *last, unsigned long &x, const char *function);
+
+  void decimal_to_number(const char *first, const char *last, unsigned long long &x, const char *function);
+
+  /**
+   * @brief Converts a JSON number to the nearest floating point value.
+   *
+   * Up to 19 significant digits are read in a 64 bits integer, the value is
+   * then computed exactly with one floating point operation when the integer
+   * and the power of ten both fit in the mantissa of the result (Clinger's
+   * fast path). Other float and double values are rounded with a 128 bits
+   * approximation of the power of ten (Eisel-Lemire), only the rare inputs
+   * that this can't round unambiguously go through the C library.
+   * <br/>
+   * The result is correctly rounded to nearest, ties to even.
+   */
+  void decimal_to_number(const char *first, const char *last, float &x, const char *function);
+
+  void decimal_to_number(const char *first, const char *last, double &x, const char *function);
+
+  void decimal_to_number(const char *first, const char *last, long double &x, const char *function);
+
+  /**
+   * @brief Converts a JSON number to the narrowest native value holding it
+   * and returns its type: 'type_integer' or 'type_unsigned' for integers
+   * which fit in 64 bits and 'type_double' for the other numbers.
+   */
+  object_type decimal_to_native(const char *first, const char *last, native_value &x, const char *function);
+
+  enum
+    {
+      number_buffer_size = 64
+    };
+
+  template < typename Number >
+  Number str_to_number(const char *first,
+		       const char *last,
+		       const char *function)
+  {
+    Number x;
+    decimal_to_number(first, last, x, function);
+    return x;
+  }
+
+  // Numbers which aren't in a contiguous buffer are copied to one first,
+  // on the stack unless they are unusually long.
   template < typename Number, typename InputIterator >
-  std::tuple<Number, InputIterator> parse_sign(InputIterator first,
-						      InputIterator last,
-						      const char *function)
+  Number str_to_number(InputIterator first,
+		       InputIterator last,
+		       const char *function)
   {
-    Number sign = 1;
-    assert_non_empty(first, last, function);
-    switch (*first)
-      {
-      case '-': sign = -1;
-      case '+': ++first;
-      }
-    return std::make_tuple(sign, first);
-  }
+    char buffer[number_buffer_size];
+    std::size_t n = 0;
 
-  template < typename Number, typename InputIterator >
-  std::tuple<Number, InputIterator> parse_integer(InputIterator first,
-							 InputIterator last,
-							 const char *function)
-  {
-    Number value = 0;
-    assert_non_empty(first, last, function);
-    assert_has_digit(first, last, function);
-    while ((first != last) && std::isdigit(*first))
+    while ((first != last) && (n != number_buffer_size))
       {
-	value *= 10;
-	value += (*first) - '0';
+	buffer[n++] = *first;
 	++first;
       }
-    return std::make_tuple(value, first);
-  }
-
-  template < typename Integer, typename InputIterator >
-  Integer str_to_int(InputIterator first,
-			    InputIterator last,
-			    const char *function)
-  {
-    Integer sign  = 1;
-    Integer value = 0;
+    if (first == last)
+      {
+	return str_to_number<Number>(static_cast<const char *>(buffer), buffer + n, function);
+      }
 
-    std::tie(sign, first) = parse_sign<Integer>(first, last, function);
-    std::tie(value, first) = parse_integer<Integer>(first, last, function);
-    assert_empty(first, last, function);
-    return sign * value;
+    std::string str (buffer, n);
+    str.append(first, last);
+    return str_to_number<Number>(str.data(), str.data() + str.size(), function);
   }
 
   template < typename InputIterator >
   int stoi(const InputIterator &first, const InputIterator &last)
   {
-    return str_to_int<int>(first, last, "json::stoi");
+    return str_to_number<int>(first, last, "json::stoi");
   }
 
   template < typename InputIterator >
   long stol(const InputIterator &first, const InputIterator &last)
   {
-    return str_to_int<long>(first, last, "json::stol");
+    return str_to_number<long>(first, last, "json::stol");
   }
 
   template < typename InputIterator >
   long long stoll(const InputIterator &first, const InputIterator &last)
   {
-    return str_to_int<long long>(first, last, "json::stoll");
+    return str_to_number<long long>(first, last, "json::stoll");
+  }
+
+  template < typename InputIterator >
+  unsigned long stoul(const InputIterator &first, const InputIterator &last)
+  {
+    return str_to_number<unsigned long>(first, last, "json::stoul");
+  }
+
+  template < typename InputIterator >
+  unsigned long long stoull(const InputIterator &first, const InputIterator &last)
+  {
+    return str_to_number<unsigned long long>(first, last, "json::stoull");
   }
 
   template < typename Iterable >
@@ -187,79 +241,34 @@ namespace json
     return stoll(std::begin(object), std::end(object));
   }
 
-  template < typename Float, typename InputIterator >
-  std::tuple<Float, InputIterator> parse_decimal(InputIterator first,
-							InputIterator last,
-							const char *function)
-  {
-    Float value = 0;
-
-    if ((first != last) && one_of(*first, '.'))
-      {
-	++first;
-	assert_non_empty(first, last, function);
-	assert_has_digit(first, last, function);
-	while ((first != last) && std::isdigit(*first))
-	  {
-	    value /= 10;
-	    value += (*first) - '0';
-	    ++first;
-	  }
-      }
-    return std::make_tuple(value / 10, first);
-  }
-
-  template < typename Float, typename InputIterator >
-  std::tuple<Float, InputIterator> parse_exponent(InputIterator first,
-							 InputIterator last,
-							 const char *function)
+  template < typename Iterable >
+  unsigned long stoul(Iterable &object)
   {
-    Float sign  = 0;
-    Float value = 0;
-
-    if ((first != last) && one_of(*first, 'e', 'E'))
-      {
-	++first;
-	std::tie(sign, first)  = parse_sign<Float>(first, last, function);
-	std::tie(value, first) = parse_integer<Float>(first, last, function);
-      }
-    return std::make_tuple(sign * value, first);
+    return stoul(std::begin(object), std::end(object));
   }
 
-  template < typename Float, typename InputIterator >
-  Float str_to_float(InputIterator first,
-			    InputIterator last,
-			    const char *function)
+  template < typename Iterable >
+  unsigned long long stoull(Iterable &object)
   {
-    Float sign    = 0;
-    Float i_value = 0;
-    Float d_value = 0;
-    Float e_value = 0;
-
-    std::tie(sign, first)    = parse_sign<Float>(first, last, function);
-    std::tie(i_value, first) = parse_integer<Float>(first, last, function);
-    std::tie(d_value, first) = parse_decimal<Float>(first, last, function);
-    std::tie(e_value, first) = parse_exponent<Float>(first, last, function);
-    assert_empty(first, last, function);
-    return sign * ((i_value + d_value) * std::pow(10, e_value));
+    return stoull(std::begin(object), std::end(object));
   }
 
   template < typename InputIterator >
   float stof(const InputIterator &first, const InputIterator &last)
   {
-    return str_to_float<double>(first, last, "json::stof");
+    return str_to_number<float>(first, last, "json::stof");
   }
 
   template < typename InputIterator >
   double stod(const InputIterator &first, const InputIterator &last)
   {
-    return str_to_float<double>(first, last, "json::stod");
+    return str_to_number<double>(first, last, "json::stod");
   }
 
   template < typename InputIterator >
   long double stold(const InputIterator &first, const InputIterator &last)
   {
-    return str_to_float<long double>(first, last, "json::stod");
+    return str_to_number<long double>(first, last, "json::stold");
   }
 
   template < typename Iterable >
@@ -271,13 +280,13 @@ namespace json
   template < typename Iterable >
   double stod(Iterable &object)
   {
-    return stof(std::begin(object), std::end(object));
+    return stod(std::begin(object), std::end(object));
   }
 
   template < typename Iterable >
   long double stold(Iterable &object)
   {
-    return stof(std::begin(object), std::end(object));
+    return stold(std::begin(object), std::end(object));
   }
 
   template < typename InputIterator, typename OutputCallback >
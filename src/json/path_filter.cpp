@@ -0,0 +1,225 @@
+/*
+ * Copyright 2012 Achille Roussel.
+ *
+ * This file is part of Libjson++.
+ *
+ * Libjson++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Libjson++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstring>
+#include "json/error.h"
+#include "json/path_filter.hpp"
+#include "json/object.hpp"
+
+namespace json
+{
+
+  [[noreturn]]
+  void error_path_filter_invalid_pointer(const char_sequence &pointer)
+  {
+    std::string s ("json::path_filter: invalid JSON pointer '");
+    s.append(pointer.data(), pointer.size());
+    s += '\'';
+    throw error(std::move(s));
+  }
+
+  const path_filter::size_type path_filter::npos;
+
+  path_filter::path_filter():
+    _nodes()
+  {
+    create();
+  }
+
+  path_filter::path_filter(std::initializer_list<const char *> pointers):
+    _nodes()
+  {
+    create();
+    for (auto pointer : pointers)
+      {
+	add(char_sequence(pointer, std::strlen(pointer)));
+      }
+  }
+
+  void path_filter::add(const char_sequence &pointer)
+  {
+    std::vector<std::string> path;
+    auto it = pointer.begin();
+    auto jt = pointer.end();
+
+    if ((it != jt) && ((*it) != '/'))
+      {
+	error_path_filter_invalid_pointer(pointer);
+      }
+    while (it != jt)
+      {
+	path.emplace_back();
+	for (++it; (it != jt) && ((*it) != '/'); ++it)
+	  {
+	    if ((*it) != '~')
+	      {
+		path.back().push_back(*it);
+		continue;
+	      }
+	    if ((++it) == jt)
+	      {
+		error_path_filter_invalid_pointer(pointer);
+	      }
+	    switch (*it)
+	      {
+	      case '0': path.back().push_back('~'); break;
+	      case '1': path.back().push_back('/'); break;
+	      default:  error_path_filter_invalid_pointer(pointer);
+	      }
+	  }
+      }
+
+    insert(root(), path, 0);
+  }
+
+  path_filter::size_type path_filter::root() const
+  {
+    return 0;
+  }
+
+  bool path_filter::selected(const size_type node) const
+  {
+    return _nodes[node].selected;
+  }
+
+  path_filter::size_type path_filter::find(const size_type node, const char_sequence &key) const
+  {
+    for (const auto &member : _nodes[node].members)
+      {
+	if (key == char_sequence(member.first))
+	  {
+	    return member.second;
+	  }
+      }
+    return _nodes[node].any;
+  }
+
+  path_filter::size_type path_filter::find(const size_type node, size_type index) const
+  {
+    if (_nodes[node].members.empty())
+      {
+	return _nodes[node].any;
+      }
+
+    char  buffer[24];
+    char *last  = buffer + sizeof(buffer);
+    char *first = last;
+    do
+      {
+	*(--first) = '0' + (index % 10);
+	index /= 10;
+      }
+    while (index != 0);
+    return find(node, char_sequence(first, last - first));
+  }
+
+  path_filter::size_type path_filter::create()
+  {
+    path_node n;
+    n.any      = npos;
+    n.selected = false;
+    _nodes.push_back(std::move(n));
+    return _nodes.size() - 1;
+  }
+
+  path_filter::size_type path_filter::copy(const size_type node)
+  {
+    const size_type n = create();
+    _nodes[n].selected = _nodes[node].selected;
+    if (_nodes[node].any != npos)
+      {
+	const size_type any = copy(_nodes[node].any);
+	_nodes[n].any = any;
+      }
+    for (size_type i = 0; i != _nodes[node].members.size(); ++i)
+      {
+	const size_type member = copy(_nodes[node].members[i].second);
+	_nodes[n].members.emplace_back(_nodes[node].members[i].first, member);
+      }
+    return n;
+  }
+
+  // The tree is kept deterministic: the paths going through a wildcard are
+  // also added below every named member of the same map, and a new member is
+  // created as a copy of the wildcard subtree.
+  // Nodes are referenced by index since creating one may move the others.
+  void path_filter::insert(const size_type node,
+			   const std::vector<std::string> &path,
+			   const size_type i)
+  {
+    if (i == path.size())
+      {
+	_nodes[node].selected = true;
+	return;
+      }
+
+    if (path[i] == "*")
+      {
+	if (_nodes[node].any == npos)
+	  {
+	    const size_type any = create();
+	    _nodes[node].any = any;
+	  }
+	insert(_nodes[node].any, path, i + 1);
+	for (size_type m = 0; m != _nodes[node].members.size(); ++m)
+	  {
+	    insert(_nodes[node].members[m].second, path, i + 1);
+	  }
+	return;
+      }
+
+    for (size_type m = 0; m != _nodes[node].members.size(); ++m)
+      {
+	if (_nodes[node].members[m].first == path[i])
+	  {
+	    insert(_nodes[node].members[m].second, path, i + 1);
+	    return;
+	  }
+      }
+
+    const size_type member = (_nodes[node].any == npos) ? create() : copy(_nodes[node].any);
+    _nodes[node].members.emplace_back(path[i], member);
+    insert(member, path, i + 1);
+  }
+
+  template const char *read_filtered(const char *,
+				     const char *,
+				     const path_filter &,
+				     object &);
+
+  object read(const char *str, const path_filter &filter)
+  {
+    object obj;
+    read_filtered(str, str + std::strlen(str), filter, obj);
+    return obj;
+  }
+
+  object read(const char_sequence &str, const path_filter &filter)
+  {
+    return read(std::string(str.data(), str.size()), filter);
+  }
+
+  object read(const std::string &str, const path_filter &filter)
+  {
+    object obj;
+    read_filtered(str.c_str(), str.c_str() + str.size(), filter, obj);
+    return obj;
+  }
+
+}
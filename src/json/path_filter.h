@@ -0,0 +1,155 @@
+/*
+ * Copyright 2012 Achille Roussel.
+ *
+ * This file is part of Libjson++.
+ *
+ * Libjson++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Libjson++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JSON_PATH_FILTER_H
+#define JSON_PATH_FILTER_H
+
+#include <initializer_list>
+#include <string>
+#include <utility>
+#include <vector>
+#include "json/def.h"
+
+namespace json
+{
+
+  /**
+   * @brief A set of JSON Pointers selecting the parts of a document to read.
+   *
+   * The paths follow the JSON Pointer syntax (RFC 6901): "/user/id" selects
+   * the member "id" of the member "user" of the top-level map, "/items/0"
+   * the first element of the list "items" and "" the whole document. A "*"
+   * segment is a wildcard matching any member of a map or any element of a
+   * list, as in "/items/ * /price" (without the spaces).
+   * <br/>
+   * The paths are stored as a tree where wildcards are merged with the other
+   * members of their map, so matching a key or an index during parsing is a
+   * single lookup.
+   */
+  class path_filter
+  {
+
+  public:
+
+    typedef std::size_t	size_type;
+
+    static const size_type npos = static_cast<size_type>(-1);
+
+    path_filter();
+
+    path_filter(std::initializer_list<const char *> pointers);
+
+    /**
+     * @brief Adds a JSON Pointer to the filter.
+     *
+     * @note The function throws a <em>json::error</em> if the pointer is
+     * neither empty nor starting with a '/', or if it contains an invalid
+     * escape sequence.
+     */
+    void add(const char_sequence &pointer);
+
+    /**
+     * @brief Returns the node of the top-level value.
+     */
+    size_type root() const;
+
+    /**
+     * @brief Returns true if the value of the node is selected entirely.
+     */
+    bool selected(size_type node) const;
+
+    /**
+     * @brief Returns the node matching a member of a map, or npos if the
+     * member is not part of any path.
+     */
+    size_type find(size_type node, const char_sequence &key) const;
+
+    /**
+     * @brief Returns the node matching an element of a list, or npos if the
+     * element is not part of any path.
+     */
+    size_type find(size_type node, size_type index) const;
+
+  private:
+    struct path_node
+    {
+      std::vector< std::pair<std::string, size_type> >	members;
+      size_type						any;
+      bool						selected;
+    };
+
+    size_type create();
+    size_type copy(size_type node);
+    void insert(size_type node, const std::vector<std::string> &path, size_type i);
+
+    std::vector<path_node>	_nodes;
+
+  };
+
+  /**
+   * @brief Reads the parts of a JSON document selected by a filter.
+   *
+   * Only the values matched by the filter and the lists and maps leading to
+   * them are built, everything else is skipped by matching brackets and
+   * strings without allocating memory or decoding escape sequences.
+   * <br/>
+   * The members of a map that aren't selected are left out of the resulting
+   * map. The elements of a list are kept up to the last selected one so
+   * indices are preserved, those that aren't selected are null.
+   *
+   * @param first A pointer to the first character of the buffer.
+   * @param last A pointer to the end of the buffer, <em>*last</em> must be
+   * readable and equal to '\\0' (see <em>json::read_buffer</em>).
+   * @param filter The paths to read.
+   * @param obj The destination object to build from the parsed data.
+   *
+   * @return The function returns a pointer to the first character following
+   * the parsed JSON object.
+   *
+   * @note The values that are skipped are not fully validated.
+   */
+  template < typename Traits, typename Allocator >
+  const char *read_filtered(const char *first,
+			    const char *last,
+			    const path_filter &filter,
+			    basic_object<char, Traits, Allocator> &obj);
+
+  extern template const char *read_filtered(const char *,
+					    const char *,
+					    const path_filter &,
+					    object &);
+
+  /**
+   * @brief Reads the parts of a JSON object selected by a list of paths.
+   *
+   * <pre>
+   * json::object obj = json::read(event, { "/user/id", "/items/ * /price" });
+   * </pre>
+   *
+   * @see json::read_filtered
+   */
+  object read(const char *str, const path_filter &filter);
+
+  object read(const char_sequence &str, const path_filter &filter);
+
+  object read(const std::string &str, const path_filter &filter);
+
+}
+
+#endif // JSON_PATH_FILTER_H
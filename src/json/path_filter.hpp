@@ -0,0 +1,182 @@
+/*
+ * Copyright 2012 Achille Roussel.
+ *
+ * This file is part of Libjson++.
+ *
+ * Libjson++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Libjson++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JSON_PATH_FILTER_HPP
+#define JSON_PATH_FILTER_HPP
+
+#include "json/path_filter.h"
+#include "json/buffer_reader.hpp"
+
+namespace json
+{
+
+  template < typename Traits, typename Allocator >
+  void filter_read_object(const char *&first,
+			  const char *last,
+			  const path_filter &filter,
+			  path_filter::size_type node,
+			  basic_object<char, Traits, Allocator> &obj);
+
+  // Returns true if the value starting at 'first' has to be read for 'node',
+  // false if it can be skipped.
+  inline bool filter_reads(const char *&first,
+			   const char *last,
+			   const path_filter &filter,
+			   const path_filter::size_type node)
+  {
+    if (node == path_filter::npos)
+      {
+	return false;
+      }
+    first = buffer_next_char(first, last);
+    return filter.selected(node) || one_of(*first, '[', '{');
+  }
+
+  template < typename Traits, typename Allocator >
+  void filter_read_list(const char *&first,
+			const char *last,
+			const path_filter &filter,
+			const path_filter::size_type node,
+			basic_object<char, Traits, Allocator> &obj)
+  {
+    obj.make_list();
+    auto &list = obj.get_list();
+    list.clear();
+
+    first = buffer_next_char(first + 1, last); // consumes '['
+    if ((*first) == ']')
+      {
+	++first;
+	return;
+      }
+
+    for (path_filter::size_type index = 0; true; ++index)
+      {
+	const auto child = filter.find(node, index);
+	if (filter_reads(first, last, filter, child))
+	  {
+	    while (list.size() <= index)
+	      {
+		list.emplace_back(obj.get_allocator());
+	      }
+	    filter_read_object(first, last, filter, child, list.back());
+	  }
+	else
+	  {
+	    first = buffer_skip_value(first, last);
+	  }
+	first = buffer_next_char(first, last);
+	switch (*first)
+	  {
+	  case ',': ++first; break;
+	  case ']': ++first; return;
+	  default:  error_invalid_input_non_json();
+	  }
+      }
+  }
+
+  template < typename Traits, typename Allocator >
+  void filter_read_map(const char *&first,
+		       const char *last,
+		       const path_filter &filter,
+		       const path_filter::size_type node,
+		       basic_object<char, Traits, Allocator> &obj)
+  {
+    typedef basic_object<char, Traits, Allocator> object;
+    typedef typename object::object_string        string;
+
+    obj.make_map();
+    obj.get_map().clear();
+
+    first = buffer_next_char(first + 1, last); // consumes '{'
+    if ((*first) == '}')
+      {
+	++first;
+	return;
+      }
+
+    string key (obj.get_allocator());
+    for (;;)
+      {
+	if ((*first) != '"')
+	  {
+	    error_invalid_input_non_json();
+	  }
+	const auto k = buffer_read_key(first, last, key);
+	first = buffer_next_char(first, last);
+	if ((*first) != ':')
+	  {
+	    error_invalid_input_non_json();
+	  }
+	++first;
+
+	const auto child = filter.find(node, k);
+	if (filter_reads(first, last, filter, child))
+	  {
+	    filter_read_object(first, last, filter, child, obj[k]);
+	  }
+	else
+	  {
+	    first = buffer_skip_value(first, last);
+	  }
+
+	first = buffer_next_char(first, last);
+	switch (*first)
+	  {
+	  case ',': first = buffer_next_char(first + 1, last); break;
+	  case '}': ++first; return;
+	  default:  error_invalid_input_non_json();
+	  }
+      }
+  }
+
+  template < typename Traits, typename Allocator >
+  void filter_read_object(const char *&first,
+			  const char *last,
+			  const path_filter &filter,
+			  const path_filter::size_type node,
+			  basic_object<char, Traits, Allocator> &obj)
+  {
+    if (filter.selected(node))
+      {
+	buffer_read_object(first, last, obj);
+	return;
+      }
+    first = buffer_next_char(first, last);
+    switch (*first)
+      {
+      case '[': filter_read_list(first, last, filter, node, obj); break;
+      case '{': filter_read_map(first, last, filter, node, obj);  break;
+      default:  first = buffer_skip_value(first, last);
+      }
+  }
+
+  template < typename Traits, typename Allocator >
+  const char *read_filtered(const char *first,
+			    const char *last,
+			    const path_filter &filter,
+			    basic_object<char, Traits, Allocator> &obj)
+  {
+    filter_read_object(first, last, filter, filter.root(), obj);
+    return first;
+  }
+
+}
+
+#endif // JSON_PATH_FILTER_HPP
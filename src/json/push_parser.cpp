@@ -0,0 +1,424 @@
+/*
+ * Copyright 2012 Achille Roussel.
+ *
+ * This file is part of Libjson++.
+ *
+ * Libjson++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Libjson++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "json/error.h"
+#include "json/push_parser.h"
+#include "json/buffer_reader.hpp"
+#include "json/object.hpp"
+
+namespace json
+{
+
+  namespace
+  {
+
+    bool is_delimiter(const char c)
+    {
+      return is_buffer_space(c) || one_of(c, '[', ']', '{', '}', ',', ':', '"');
+    }
+
+    // Top-level numbers and literals only end on the character following
+    // them, the other values end on their last character.
+    bool ends_on_delimiter(const object &obj)
+    {
+      return (obj.type() != type_string) && (obj.type() != type_list) && (obj.type() != type_map);
+    }
+
+  }
+
+  push_parser::push_parser():
+    _objects(),
+    _value(),
+    _stack(),
+    _token(),
+    _key(),
+    _buffer(),
+    _literal(nullptr),
+    _state(expect_value),
+    _active(false),
+    _escape(false),
+    _complete(false)
+  {
+  }
+
+  push_parser::size_type push_parser::feed(const char *data, const size_type size)
+  {
+    const char     *first = data;
+    const char     *last  = data + size;
+    const size_type count = _objects.size();
+
+    while (first != last)
+      {
+	first = feed_value(first, last);
+
+	// Only whitespace may follow a top-level number or literal when values
+	// are fed back to back, "1[2]" would otherwise be read as two values.
+	if ((first != last) && !is_buffer_space(*first) && ends_on_delimiter(_objects.back()))
+	  {
+	    error_invalid_input_non_json();
+	  }
+      }
+
+    return _objects.size() - count;
+  }
+
+  const char *push_parser::feed_value(const char *first, const char *last)
+  {
+    while ((first != last) && !_complete)
+      {
+	switch (_state)
+	  {
+	  case in_string:
+	  case in_key:
+	    first = read_string(first, last);
+	    break;
+
+	  case in_number:
+	  case in_literal:
+	    // The delimiter is left to the caller or to the enclosing container.
+	    if (is_delimiter(*first))
+	      {
+		end_scalar();
+	      }
+	    else
+	      {
+		read_scalar(*(first++));
+	      }
+	    break;
+
+	  default:
+	    if (!is_buffer_space(*first))
+	      {
+		read_char(*first);
+	      }
+	    ++first;
+	  }
+      }
+
+    if (_complete)
+      {
+	complete();
+      }
+    return first;
+  }
+
+  // Handles a character found between tokens.
+  void push_parser::read_char(const char c)
+  {
+    switch (_state)
+      {
+      case expect_member:
+	if (c == ']')
+	  {
+	    close();
+	    return;
+	  }
+	begin_value(c);
+	return;
+
+      case expect_value:
+	begin_value(c);
+	return;
+
+      case expect_first_key:
+	if (c == '}')
+	  {
+	    close();
+	    return;
+	  }
+	break;
+
+      case expect_colon:
+	if (c != ':')
+	  {
+	    error_invalid_input_non_json();
+	  }
+	_state = expect_value;
+	return;
+
+      case expect_separator:
+	if (c == ',')
+	  {
+	    _state = (_stack.back()->type() == type_list) ? expect_value : expect_key;
+	    return;
+	  }
+	if (c != ((_stack.back()->type() == type_list) ? ']' : '}'))
+	  {
+	    error_invalid_input_non_json();
+	  }
+	close();
+	return;
+
+      default:
+	break;
+      }
+
+    // A key is expected.
+    if (c != '"')
+      {
+	error_invalid_input_non_json();
+      }
+    _token.assign(1, c);
+    _state = in_key;
+  }
+
+  // Lists and maps are created in their parent as soon as they open, strings
+  // and scalars once their last character has been received.
+  void push_parser::begin_value(const char c)
+  {
+    _active = true;
+    switch (c)
+      {
+      case '[':
+	{
+	  object &obj = destination();
+	  obj.make_list();
+	  _stack.push_back(&obj);
+	  _state = expect_member;
+	  return;
+	}
+
+      case '{':
+	{
+	  object &obj = destination();
+	  obj.make_map();
+	  _stack.push_back(&obj);
+	  _state = expect_first_key;
+	  return;
+	}
+
+      case '"':
+	_state = in_string;
+	break;
+
+      case 't':
+	_literal = "true";
+	_state   = in_literal;
+	break;
+
+      case 'f':
+	_literal = "false";
+	_state   = in_literal;
+	break;
+
+      case 'n':
+	_literal = "null";
+	_state   = in_literal;
+	break;
+
+      default:
+	if (!is_buffer_number(c))
+	  {
+	    error_invalid_input_non_json();
+	  }
+	_state = in_number;
+      }
+    _token.assign(1, c);
+  }
+
+  // Appends the characters of the string being received up to its closing
+  // quote or the end of the chunk, escape sequences are decoded once the
+  // string ends.
+  const char *push_parser::read_string(const char *first, const char *last)
+  {
+    while (first != last)
+      {
+	if (_escape)
+	  {
+	    _escape = false;
+	    _token.push_back(*(first++));
+	    continue;
+	  }
+
+	const char *run = first;
+	first = scan_string(first, last);
+	_token.append(run, first - run);
+	if (first == last)
+	  {
+	    break;
+	  }
+
+	_token.push_back(*first);
+	if ((*(first++)) == '"')
+	  {
+	    end_string();
+	    break;
+	  }
+	_escape = true;
+      }
+    return first;
+  }
+
+  void push_parser::read_scalar(const char c)
+  {
+    if (_state == in_literal)
+      {
+	if (c != _literal[_token.size()])
+	  {
+	    error_invalid_input_non_json();
+	  }
+      }
+    else if (!is_buffer_number(c) && !one_of(c, '.', 'e', 'E'))
+      {
+	error_invalid_input_non_json();
+      }
+    _token.push_back(c);
+  }
+
+  void push_parser::end_string()
+  {
+    const char *first = _token.c_str();
+    const char *last  = first + _token.size();
+
+    if (_state == in_key)
+      {
+	_key.clear();
+	buffer_read_string(++first, last, _key);
+	_state = expect_colon;
+      }
+    else
+      {
+	const char_sequence s = buffer_read_key(first, last, _buffer);
+	destination() = s;
+	end_value();
+      }
+  }
+
+  void push_parser::end_scalar()
+  {
+    if (_state == in_literal)
+      {
+	if (_literal[_token.size()] != '\0')
+	  {
+	    error_invalid_input_non_json();
+	  }
+	switch (_literal[0])
+	  {
+	  case 't': destination() = true;        break;
+	  case 'f': destination() = false;       break;
+	  default:  destination().make_null();   break;
+	  }
+      }
+    else
+      {
+	const char *first = _token.c_str();
+	if (buffer_read_number(first) != (first + _token.size()))
+	  {
+	    error_invalid_input_non_json();
+	  }
+	destination().make_number(char_sequence(_token));
+      }
+    end_value();
+  }
+
+  void push_parser::end_value()
+  {
+    _state    = expect_separator;
+    _complete = _stack.empty();
+  }
+
+  // Lists of numbers are packed once they end, like the ones read by
+  // json::read_buffer.
+  void push_parser::close()
+  {
+    object &obj = *_stack.back();
+    if ((obj.type() == type_list) && (obj.size() != 0) && packing_scope::enabled())
+      {
+	obj.pack();
+      }
+    _stack.pop_back();
+    end_value();
+  }
+
+  // Returns the object receiving the value that begins, a new member when a
+  // list or map is being filled. The containers on the stack are the last
+  // members of their parents, which don't move while they are filled.
+  object &push_parser::destination()
+  {
+    if (_stack.empty())
+      {
+	return _value;
+      }
+
+    object &obj = *_stack.back();
+    if (obj.type() == type_list)
+      {
+	auto &list = obj.get_list();
+	list.emplace_back();
+	return list.back();
+      }
+    return obj[char_sequence(_key)];
+  }
+
+  void push_parser::complete()
+  {
+    _objects.push_back(std::move(_value));
+    _value.make_null();
+    _state    = expect_value;
+    _active   = false;
+    _complete = false;
+  }
+
+  void push_parser::finish()
+  {
+    if (_active && _stack.empty() && one_of(_state, in_number, in_literal))
+      {
+	end_scalar();
+	complete();
+      }
+    else if (_active)
+      {
+	error_invalid_input_eof();
+      }
+  }
+
+  bool push_parser::next(object &obj)
+  {
+    if (_objects.empty())
+      {
+	return false;
+      }
+    obj = std::move(_objects.front());
+    _objects.pop_front();
+    return true;
+  }
+
+  push_parser::size_type push_parser::available() const
+  {
+    return _objects.size();
+  }
+
+  bool push_parser::pending() const
+  {
+    return _active;
+  }
+
+  void push_parser::reset()
+  {
+    _objects.clear();
+    _value.make_null();
+    _stack.clear();
+    _token.clear();
+    _state    = expect_value;
+    _active   = false;
+    _escape   = false;
+    _complete = false;
+  }
+
+}
@@ -0,0 +1,169 @@
+/*
+ * Copyright 2012 Achille Roussel.
+ *
+ * This file is part of Libjson++.
+ *
+ * Libjson++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Libjson++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JSON_PUSH_PARSER_H
+#define JSON_PUSH_PARSER_H
+
+#include <deque>
+#include <string>
+#include <vector>
+#include "json/def.h"
+#include "json/object.h"
+
+namespace json
+{
+
+  /**
+   * @brief A parser fed with chunks of input, which completes the top-level
+   * JSON objects as their last character arrives.
+   *
+   * The input is passed to <em>feed</em> as it becomes available, in chunks of
+   * any size. The parser keeps its state across calls, so a chunk may end
+   * anywhere: in the middle of a string, an escape sequence or a number.
+   * Every top-level JSON object found in the input is made available through
+   * <em>next</em> as soon as its last character has been fed.
+   * <br/>
+   * Objects are built while their characters arrive: the lists and maps being
+   * filled are kept on a stack and only the token being received (a string,
+   * a key, a number or a literal) is buffered. Errors are reported by the
+   * chunk holding the offending character, except invalid escape sequences
+   * which are reported when their string ends.
+   * <br/>
+   * A top-level number or literal only ends when the next character arrives,
+   * <em>finish</em> has to be called to complete one that ends the input.
+   * Between the values passed to <em>feed</em> this character has to be a
+   * whitespace.
+   *
+   * @note The parser throws a <em>json::error</em> when the input is not
+   * valid JSON, the objects completed before the error can still be retrieved
+   * but the parser has to be <em>reset</em> before being fed again.
+   */
+  class push_parser
+  {
+
+  public:
+
+    typedef std::size_t	size_type;
+
+    push_parser();
+
+    /**
+     * @brief Feeds the next chunk of input to the parser.
+     *
+     * @return The function returns the number of JSON objects completed by
+     * this chunk.
+     */
+    size_type feed(const char *data, size_type size);
+
+    /**
+     * @brief Feeds input until the end of the JSON object being received.
+     *
+     * Unlike <em>feed</em> the function stops after the first completed
+     * object, the rest of the input is left to the caller.
+     *
+     * @return The function returns a pointer to the first character that was
+     * not consumed, 'last' if the object is not complete yet.
+     */
+    const char *feed_value(const char *first, const char *last);
+
+    /**
+     * @brief Signals the end of the input.
+     *
+     * A pending top-level number or literal is completed, the function throws
+     * a <em>json::error</em> if the input ends in the middle of a value.
+     */
+    void finish();
+
+    /**
+     * @brief Moves the next completed JSON object into 'obj'.
+     *
+     * @return The function returns false if no JSON object is available.
+     */
+    bool next(object &obj);
+
+    /**
+     * @brief Returns the number of completed JSON objects that haven't been
+     * retrieved with <em>next</em>.
+     */
+    size_type available() const;
+
+    /**
+     * @brief Returns true if the parser holds the beginning of a JSON object
+     * that is not complete yet.
+     */
+    bool pending() const;
+
+    /**
+     * @brief Discards the parser state and the completed JSON objects.
+     */
+    void reset();
+
+  private:
+    // What the parser expects from the next character.
+    enum state
+      {
+	expect_value,
+	expect_member,     // a value or the end of an empty list
+	expect_key,
+	expect_first_key,  // a key or the end of an empty map
+	expect_colon,
+	expect_separator,  // a comma or the end of the container
+	in_string,
+	in_key,
+	in_number,
+	in_literal
+      };
+
+    void read_char(char c);
+
+    void begin_value(char c);
+
+    const char *read_string(const char *first, const char *last);
+
+    void read_scalar(char c);
+
+    void end_string();
+
+    void end_scalar();
+
+    void end_value();
+
+    void close();
+
+    object &destination();
+
+    void complete();
+
+    std::deque<object>		_objects;
+    object			_value;
+    std::vector<object *>	_stack;
+    std::string			_token;
+    std::string			_key;
+    std::string			_buffer;
+    const char *		_literal;
+    state			_state;
+    bool			_active;
+    bool			_escape;
+    bool			_complete;
+
+  };
+
+}
+
+#endif // JSON_PUSH_PARSER_H
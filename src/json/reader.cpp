@@ -19,7 +19,11 @@
 
 #include "json/error.h"
 #include "json/reader.hpp"
+#include "json/buffer_reader.hpp"
+#include "json/structural_index.hpp"
 #include "json/object.hpp"
+#include <limits>
+#include <thread>
 
 namespace json
 {
@@ -39,27 +43,139 @@ namespace json
     throw error("json::read_object: unicode is supported only with char");
   }
 
+  const char escape_table[256] =
+    {
+      0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,  // 0x00
+      0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,  // 0x10
+      0,    0,    '"',  0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    '/', // 0x20
+      0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,  // 0x30
+      0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,  // 0x40
+      0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    '\\', 0,    0,    0,  // 0x50
+      0,    0,    '\b', 0,    0,    0,    '\f', 0,    0,    0,    0,    0,    0,    0,    '\n', 0,  // 0x60
+      0,    0,    '\r', 0,    '\t', 'u',  0,    0,    0,    0,    0,    0,    0,    0,    0,    0,  // 0x70
+    };
+
   template void read_object(std::istream &, object &);
 
+  thread_local bool packing_scope::_enabled = false;
+
+  packing_scope::packing_scope(const bool enabled):
+    _previous(_enabled)
+  {
+    _enabled = enabled;
+  }
+
+  packing_scope::~packing_scope()
+  {
+    _enabled = _previous;
+  }
+
+  bool packing_scope::enabled()
+  {
+    return _enabled;
+  }
+
+  enum
+    {
+      read_stack_buffer_size = 1024
+    };
+
+  namespace
+  {
+
+    // Below this size building the structural index with several threads
+    // costs more than it saves on the scan of the input.
+    const std::size_t indexed_read_threshold = 1 << 20;
+
+    // Large documents go through the two-stage reader when there is more than
+    // one hardware thread to build the index, the others are read directly.
+    void read_contiguous(const char *first, const char *last, object &obj)
+    {
+      const std::size_t n = last - first;
+      if ((n >= indexed_read_threshold)
+	  && (n <= std::numeric_limits<structural_index::offset_type>::max())
+	  && (std::thread::hardware_concurrency() > 1))
+	{
+	  read_indexed(first, last, 0, obj);
+	}
+      else
+	{
+	  read_buffer(first, last, obj);
+	}
+    }
+
+  }
+
   object read(const char *str)
   {
-    const char_sequence cs ( str, std::strlen(str) );
-    return read(cs);
+    object obj;
+    read_contiguous(str, str + std::strlen(str), obj);
+    return obj;
+  }
+
+  object read_terminated(const char *first, const char *last)
+  {
+    object obj;
+    read_contiguous(first, last, obj);
+    return obj;
   }
 
   object read(const char_sequence &str)
   {
-    return read<const char_sequence, object>(str);
+    // A char_sequence doesn't guarantee that a '\0' follows its last character
+    // so the data has to be copied before going through the buffer reader,
+    // small documents are copied on the stack to avoid a memory allocation.
+    const std::size_t n = str.size();
+    if (n < read_stack_buffer_size)
+      {
+	char buffer[read_stack_buffer_size];
+	std::copy(str.begin(), str.end(), buffer);
+	buffer[n] = '\0';
+	object obj;
+	read_buffer(buffer, buffer + n, obj);
+	return obj;
+      }
+    return read(std::string(str.data(), n));
   }
 
   object read(const std::string &str)
   {
-    return read<const std::string, object>(str);
+    object obj;
+    read_contiguous(str.c_str(), str.c_str() + str.size(), obj);
+    return obj;
   }
 
   object read(std::string &str)
   {
-    return read<const std::string, object>(str);
+    return read(static_cast<const std::string &>(str));
+  }
+
+  object read(const char *str, key_table &keys)
+  {
+    object obj;
+    read_buffer(str, str + std::strlen(str), obj, keys);
+    return obj;
+  }
+
+  object read(const std::string &str, key_table &keys)
+  {
+    object obj;
+    read_buffer(str.c_str(), str.c_str() + str.size(), obj, keys);
+    return obj;
+  }
+
+  object read(const char *str, deduplicator &trees)
+  {
+    object obj;
+    read_buffer(str, str + std::strlen(str), obj, trees);
+    return obj;
+  }
+
+  object read(const std::string &str, deduplicator &trees)
+  {
+    object obj;
+    read_buffer(str.c_str(), str.c_str() + str.size(), obj, trees);
+    return obj;
   }
 
 }
@@ -95,9 +95,33 @@ namespace json
    * @param str The string to read the JSON object from.
    *
    * @return The function returns the newly created instance of <em>json::object</em>.
+   *
+   * @note This function and the other in-memory overloads below are parsed
+   * with the contiguous buffer reader (see <em>json::read_buffer</em>), or
+   * with the two-stage reader (see <em>json::read_indexed</em>) for documents
+   * of a megabyte or more when the structural index can be built with
+   * several threads.
    */
   object read(const char *str);
 
+  /**
+   * @brief Reads a JSON object from the characters in the range [first, last)
+   * of a buffer terminated by a '\\0', without copying them.
+   *
+   * @param first A pointer to the first character of the input.
+   * @param last A pointer to the end of the input, <em>*last</em> must be
+   * readable and equal to '\\0' (see <em>json::read_buffer</em>). A range
+   * which is part of a larger buffer is read with the
+   * <em>json::char_sequence</em> overload of <em>json::read</em>, which
+   * copies it.
+   *
+   * @return The function returns the newly created instance of <em>json::object</em>.
+   *
+   * @note Like <em>json::read</em>, large documents go through the
+   * two-stage reader.
+   */
+  object read_terminated(const char *first, const char *last);
+
   /**
    * @brief Reads a JSON object.
    *
@@ -134,6 +158,88 @@ namespace json
    */
   object read(std::string &str);
 
+  /**
+   * @brief Reads a JSON object, the keys of its maps are interned in 'keys'
+   * and shared with the other documents read with the same table.
+   *
+   * @param str The string to read the JSON object from.
+   * @param keys The table to intern the keys in.
+   *
+   * @return The function returns the newly created instance of <em>json::object</em>.
+   */
+  object read(const char *str, key_table &keys);
+
+  /**
+   * @brief Reads a JSON object, the keys of its maps are interned in 'keys'
+   * and shared with the other documents read with the same table.
+   *
+   * @param str The string to read the JSON object from.
+   * @param keys The table to intern the keys in.
+   *
+   * @return The function returns the newly created instance of <em>json::object</em>.
+   */
+  object read(const std::string &str, key_table &keys);
+
+  /**
+   * @brief Reads a JSON object, its identical lists and maps share their body
+   * with each other and with the other documents read with the same table.
+   *
+   * @param str The string to read the JSON object from.
+   * @param trees The table to share the lists and maps through.
+   *
+   * @return The function returns the newly created instance of <em>json::object</em>.
+   */
+  object read(const char *str, deduplicator &trees);
+
+  /**
+   * @brief Reads a JSON object, its identical lists and maps share their body
+   * with each other and with the other documents read with the same table.
+   *
+   * @param str The string to read the JSON object from.
+   * @param trees The table to share the lists and maps through.
+   *
+   * @return The function returns the newly created instance of <em>json::object</em>.
+   */
+  object read(const std::string &str, deduplicator &trees);
+
+  /**
+   * @brief Makes the readers of the current thread pack the lists of numbers
+   * they read (see <em>basic_object::pack</em>) until the scope is
+   * destroyed, lists are otherwise read as lists of objects.
+   * <br/>
+   * A packed list takes 8 bytes per number instead of an object, but its
+   * members are not objects: through a const object they are read with the
+   * iterators, <em>get_integers</em> or <em>get_doubles</em>, and the const
+   * <em>operator[]</em> and <em>get_list</em> throw a <em>json::error</em>.
+   * <em>json::read_parallel</em> and the threads of a
+   * <em>json::ndjson_reader</em> follow the scope of the thread which calls
+   * or creates them.
+   */
+  class packing_scope
+  {
+
+  public:
+
+    explicit packing_scope(bool enabled = true);
+
+    ~packing_scope();
+
+    /**
+     * @brief Returns true if the lists of numbers read by the current thread
+     * are packed.
+     */
+    static bool enabled();
+
+  private:
+    packing_scope(const packing_scope &) = delete;
+
+    packing_scope &operator=(const packing_scope &) = delete;
+
+    static thread_local bool	_enabled;
+    bool			_previous;
+
+  };
+
 }
 
 #endif // JSON_READER_H
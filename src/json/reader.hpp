@@ -22,9 +22,12 @@
 
 #include <array>
 #include <istream>
+#include <iterator>
 #include "json/reader.h"
 #include "json/char_sequence.h"
 #include "json/parsing.hpp"
+#include "json/string_scan.h"
+#include "json/string_pool.hpp"
 
 namespace json
 {
@@ -38,6 +41,15 @@ namespace json
   [[noreturn]]
   void error_invalid_input_unsupported_unicode();
 
+  // Maps the character following a '\\' in a string to the character it
+  // stands for, 'u' marks unicode escapes and 0 invalid escape sequences.
+  extern const char escape_table[256];
+
+  inline char escape_char(const char c)
+  {
+    return escape_table[static_cast<unsigned char>(c)];
+  }
+
   template < typename InputIterator >
   void skip_spaces(InputIterator &first, InputIterator &last)
   {
@@ -124,11 +136,109 @@ namespace json
           {
             return *first-'a'+10;
           }
+        else if(*first >= 'A' && *first <= 'F')
+          {
+            return *first-'A'+10;
+          }
       }
 
       error_invalid_input_non_json();
   }
 
+  // Writes the UTF-8 encoding of 'code_point' to 'out' and returns the
+  // iterator following the last written character.
+  template < typename OutputIterator >
+  OutputIterator encode_utf8(const int code_point, OutputIterator out)
+  {
+    if (code_point < 0x80)
+      {
+        *out++ = static_cast<char>(         code_point                  );
+      }
+    else if (code_point < 0x800)
+      {
+        *out++ = static_cast<char>(0xC0 + ( code_point            >> 6 ));
+        *out++ = static_cast<char>(0x80 + ( code_point & 077           ));
+      }
+    else if (code_point <= 0xFFFF)
+      {
+        *out++ = static_cast<char>(0xE0 + ( code_point            >> 12));
+        *out++ = static_cast<char>(0x80 + ((code_point & 07777)   >> 6 ));
+        *out++ = static_cast<char>(0x80 + ( code_point & 077           ));
+      }
+    else
+      {
+        *out++ = static_cast<char>(0xF0 + ( code_point            >> 18));
+        *out++ = static_cast<char>(0x80 + ((code_point & 0777777) >> 12));
+        *out++ = static_cast<char>(0x80 + ((code_point & 07777)   >> 6 ));
+        *out++ = static_cast<char>(0x80 + ( code_point & 077           ));
+      }
+    return out;
+  }
+
+  // Reads the four hexadecimal digits of a unicode escape sequence, 'first'
+  // points to the 'u' and is left on the last digit.
+  template < typename InputIterator >
+  int read_unicode_escape(InputIterator &first, InputIterator &last)
+  {
+    consume_char(first, last); // consumes 'u'
+    int code_point = 0;
+
+    for (int i = 0; i < 3; ++i)
+      {
+        code_point += read_unicode_digit(first, last);
+        code_point <<= 4;
+        consume_char(first, last);
+      }
+
+    // last one should not be consumed
+    return code_point + read_unicode_digit(first, last);
+  }
+
+  // Reads a unicode escape sequence like read_unicode_escape, code points
+  // above U+FFFF are written as a pair of escaped UTF-16 surrogates which
+  // are combined here. Unpaired surrogates are rejected since they have no
+  // UTF-8 encoding.
+  template < typename InputIterator >
+  int read_code_point(InputIterator &first, InputIterator &last)
+  {
+    const int code_point = read_unicode_escape(first, last);
+
+    if ((code_point & 0xFC00) == 0xDC00)
+      {
+        error_invalid_input_non_json();
+      }
+    if ((code_point & 0xFC00) != 0xD800)
+      {
+        return code_point;
+      }
+
+    consume_char(first, last); // consumes the last digit
+    if (first == last)
+      {
+        error_invalid_input_eof();
+      }
+    if ((*first) != '\\')
+      {
+        error_invalid_input_non_json();
+      }
+    consume_char(first, last); // consumes '\\'
+    if (first == last)
+      {
+        error_invalid_input_eof();
+      }
+    if ((*first) != 'u')
+      {
+        error_invalid_input_non_json();
+      }
+
+    const int low = read_unicode_escape(first, last);
+    if ((low & 0xFC00) != 0xDC00)
+      {
+        error_invalid_input_non_json();
+      }
+    return 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+  }
+
   template < typename InputIterator, typename Char, typename Traits, typename Allocator >
   struct read_unicode_helper
   {
@@ -147,44 +257,52 @@ namespace json
                          InputIterator &last,
                          std::basic_string<char, Traits, Allocator> &str)
     {
-      consume_char(first, last); // consumes 'u'
-      int code_point = 0;
-
-      for (int i = 0; i < 3; ++i)
-        {
-          code_point += read_unicode_digit(first, last);
-          code_point <<= 4;
-          consume_char(first, last);
-        }
-
-      // last one should not be consumed
-      code_point += read_unicode_digit(first, last);
-
-      if (code_point < 0x80)
-        {
-          str.push_back(         code_point                  );
-        }
-      else if (code_point < 0x800)
-        {
-          str.push_back(0xC0 + ( code_point            >> 6 ));
-          str.push_back(0x80 + ( code_point & 077           ));
-        }
-      else if (code_point <= 0xFFFF)
-        {
-          str.push_back(0xE0 + ( code_point            >> 12));
-          str.push_back(0x80 + ((code_point & 07777)   >> 6 ));
-          str.push_back(0x80 + ( code_point & 077           ));
-        }
-      else
-        {
-          str.push_back(0xF0 + ( code_point            >> 18));
-          str.push_back(0x80 + ((code_point & 0777777) >> 12));
-          str.push_back(0x80 + ((code_point & 07777)   >> 6 ));
-          str.push_back(0x80 + ( code_point & 077           ));
-        }
+      encode_utf8(read_code_point(first, last), std::back_inserter(str));
     }
   };
 
+  template < typename InputIterator, typename Char, typename Traits, typename Allocator >
+  void read_escape(InputIterator &first,
+		   InputIterator &last,
+		   std::basic_string<Char, Traits, Allocator> &str)
+  {
+    ++first; // consumes '\\'
+    if (first == last)
+      {
+	error_invalid_input_eof();
+      }
+    switch (const char c = escape_char(*first))
+      {
+      case 'u': read_unicode_helper<InputIterator, Char, Traits, Allocator>::read_unicode(first, last, str); break;
+      case 0:   error_invalid_input_non_json();
+      default:  str.push_back(c);
+      }
+    ++first;
+  }
+
+  // Appends characters to 'str' up to the next '"' or '\\'.
+  template < typename InputIterator, typename Char, typename Traits, typename Allocator >
+  void read_string_run(InputIterator &first,
+		       InputIterator &last,
+		       std::basic_string<Char, Traits, Allocator> &str)
+  {
+    while ((first != last) && ((*first) != '"') && ((*first) != '\\'))
+      {
+	str.push_back(*first);
+	++first;
+      }
+  }
+
+  template < typename Traits, typename Allocator >
+  void read_string_run(const char *&first,
+		       const char *&last,
+		       std::basic_string<char, Traits, Allocator> &str)
+  {
+    const char *run = first;
+    first = scan_string(first, last);
+    str.append(run, first - run);
+  }
+
   template < typename InputIterator, typename Char, typename Traits, typename Allocator >
   void read_key(InputIterator &first,
 		       InputIterator &last,
@@ -195,35 +313,19 @@ namespace json
 	error_invalid_input_non_json();
       }
 
-    consume_char(first, last); // consumes '"'
-    str.reserve(30);
-    while ((first != last) && ((*first) != '"'))
+    ++first; // consumes '"'
+    for (;;)
       {
-
-	if ((*first) != '\\')
+	read_string_run(first, last, str);
+	if (first == last)
 	  {
-	    str.push_back(*first);
+	    error_invalid_input_eof();
 	  }
-
-	else
+	if ((*first) == '"')
 	  {
-	    consume_char(first, last); // consumes '\\'
-	    switch (*first)
-	      {
-	      case '"':  str.push_back('"');  break;
-	      case '\\': str.push_back('\\'); break;
-	      case '/':  str.push_back('/');  break;
-	      case 'b':  str.push_back('\b'); break;
-	      case 'f':  str.push_back('\f'); break;
-	      case 'n':  str.push_back('\n'); break;
-              case 'r':  str.push_back('\r'); break;
-              case 't':  str.push_back('\t'); break;
-              case 'u':  read_unicode_helper<InputIterator, Char, Traits, Allocator>::read_unicode(first, last, str); break;
-	      default:   error_invalid_input_non_json();
-	      }
+	    break;
 	  }
-
-	consume_char(first, last);
+	read_escape(first, last, str);
       }
 
     consume_char(first, last); // consumes '"'
@@ -274,8 +376,12 @@ namespace json
   void read_equals(InputIterator &first,InputIterator &last, const char (&str)[N])
   {
     typedef typename std::size_t index;
-    for (index i = 0; (first != last) && (i != (N - 1)); ++i)
+    for (index i = 0; i != (N - 1); ++i)
       {
+	if (first == last)
+	  {
+	    error_invalid_input_eof();
+	  }
 	consume_char(first, last, str[i]);
       }
   }
@@ -309,14 +415,28 @@ namespace json
 			  InputIterator &last,
 			  basic_object<Char, Traits, Allocator> &obj)
   {
-    obj.make_string();
     if ((*first) == '"')
       {
-	read_key(first, last, obj.get_string());
+	if (basic_string_pool<Char, Traits>::current() == nullptr)
+	  {
+	    obj.make_string();
+	    read_key(first, last, obj.get_string());
+	  }
+	else
+	  {
+	    std::basic_string<Char, Traits, Allocator> str (obj.get_allocator());
+	    read_key(first, last, str);
+	    obj = basic_char_sequence<Char, Traits>(str);
+	  }
       }
-    else if (!read_number(first, last, [&](const Char &c) { obj.get_string().push_back(c); }))
+    else
       {
-	error_invalid_input_non_json();
+	std::basic_string<Char, Traits> number;
+	if (!read_number(first, last, [&](const Char &c) { number.push_back(c); }))
+	  {
+	    error_invalid_input_non_json();
+	  }
+	obj.make_number(basic_char_sequence<Char, Traits>(number));
       }
   }
 
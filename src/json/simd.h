@@ -0,0 +1,102 @@
+/*
+ * Copyright 2012 Achille Roussel.
+ *
+ * This file is part of Libjson++.
+ *
+ * Libjson++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Libjson++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JSON_SIMD_H
+#define JSON_SIMD_H
+
+#include <cstdint>
+#include "json/def.h"
+
+// Vector instructions used by the reader's kernels. SSE2 is part of the
+// x86-64 baseline and is always used there, AVX2 code is compiled with a
+// target attribute and only selected at runtime when the CPU supports it.
+// Other architectures fall back to the scalar code paths.
+
+#if defined(__x86_64__) || defined(_M_X64)
+#  define JSON_SIMD_SSE2 1
+#  include <emmintrin.h>
+#else
+#  define JSON_SIMD_SSE2 0
+#endif
+
+#if JSON_SIMD_SSE2 && defined(__GNUC__)
+#  define JSON_SIMD_AVX2 1
+#  define JSON_TARGET_AVX2 __attribute__((target("avx2")))
+#  include <immintrin.h>
+#else
+#  define JSON_SIMD_AVX2 0
+#  define JSON_TARGET_AVX2
+#endif
+
+#if defined(_MSC_VER)
+#  include <intrin.h>
+#endif
+
+namespace json
+{
+
+  inline int trailing_zeroes(const std::uint64_t x)
+  {
+#if defined(__GNUC__)
+    return __builtin_ctzll(x);
+#elif defined(_MSC_VER)
+    unsigned long i;
+    _BitScanForward64(&i, x);
+    return int(i);
+#else
+    int i = 0;
+    while (!(x & (std::uint64_t(1) << i)))
+      {
+	++i;
+      }
+    return i;
+#endif
+  }
+
+  inline int leading_zeroes(const std::uint64_t x)
+  {
+#if defined(__GNUC__)
+    return __builtin_clzll(x);
+#elif defined(_MSC_VER)
+    unsigned long i;
+    _BitScanReverse64(&i, x);
+    return 63 - int(i);
+#else
+    int i = 0;
+    while (!(x & (std::uint64_t(1) << (63 - i))))
+      {
+	++i;
+      }
+    return i;
+#endif
+  }
+
+  inline bool cpu_has_avx2()
+  {
+#if JSON_SIMD_AVX2
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+  }
+
+}
+
+#endif // JSON_SIMD_H
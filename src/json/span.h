@@ -0,0 +1,97 @@
+/*
+ * Copyright 2012 Achille Roussel.
+ *
+ * This file is part of Libjson++.
+ *
+ * Libjson++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Libjson++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JSON_SPAN_H
+#define JSON_SPAN_H
+
+#include <cstddef>
+#include "json/def.h"
+
+namespace json
+{
+
+  /**
+   * @brief A view on a contiguous sequence of values owned by someone else,
+   * like the numbers of a packed list (see <em>basic_object::pack</em>).
+   * <br/>
+   * The view is invalidated by any change to the size or the representation
+   * of its owner.
+   */
+  template < typename T >
+  class span
+  {
+
+  public:
+    typedef T			value_type;
+    typedef T &			reference;
+    typedef T *			pointer;
+    typedef T *			iterator;
+    typedef std::size_t		size_type;
+
+    span():
+      _data(nullptr),
+      _size(0)
+    {
+    }
+
+    span(T *data, const size_type size):
+      _data(data),
+      _size(size)
+    {
+    }
+
+    T *data() const
+    {
+      return _data;
+    }
+
+    size_type size() const
+    {
+      return _size;
+    }
+
+    bool empty() const
+    {
+      return _size == 0;
+    }
+
+    T *begin() const
+    {
+      return _data;
+    }
+
+    T *end() const
+    {
+      return _data + _size;
+    }
+
+    T &operator[](const size_type index) const
+    {
+      return _data[index];
+    }
+
+  private:
+    T *		_data;
+    size_type	_size;
+
+  };
+
+}
+
+#endif // JSON_SPAN_H
@@ -0,0 +1,137 @@
+/*
+ * Copyright 2012 Achille Roussel.
+ *
+ * This file is part of Libjson++.
+ *
+ * Libjson++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Libjson++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <istream>
+#include "json/error.h"
+#include "json/push_parser.h"
+#include "json/stream_reader.h"
+#include "json/object.hpp"
+
+namespace json
+{
+
+  namespace
+  {
+
+    enum
+      {
+	stream_block_size = 4096
+      };
+
+    // The get area of a stream buffer is protected, its size is read through
+    // pointers to the members of a derived class. Unlike in_avail, it doesn't
+    // include the characters announced by showmanyc, which are not buffered.
+    struct get_area : std::streambuf
+    {
+      static std::streamsize size(std::streambuf &buf)
+      {
+	return (buf.*(&get_area::egptr))() - (buf.*(&get_area::gptr))();
+      }
+    };
+
+    // Returns the state of the stream once the object has been read: eofbit
+    // if the end of the stream was reached, badbit if characters following
+    // the object could not be given back to the stream buffer.
+    std::ios::iostate read_streambuf(std::streambuf &buf, object &obj)
+    {
+      typedef std::char_traits<char> traits;
+
+      push_parser parser;
+      char        block[stream_block_size];
+
+      for (;;)
+	{
+	  const traits::int_type c = buf.sgetc();
+	  if (traits::eq_int_type(c, traits::eof()))
+	    {
+	      parser.finish();
+	      if (!parser.next(obj))
+		{
+		  error_invalid_input_eof();
+		}
+	      return std::ios::eofbit;
+	    }
+
+	  // Once sgetc has filled the get area the characters it holds are
+	  // copied with sgetn, and those following the object are given back
+	  // with sputbackc: the get area is not refilled in between so they are
+	  // still in it.
+	  const std::streamsize n = get_area::size(buf);
+	  if (n > 1)
+	    {
+	      const char *last  = block + buf.sgetn(block, std::min<std::streamsize>(n, stream_block_size));
+	      const char *first = parser.feed_value(block, last);
+	      while (last != first)
+		{
+		  if (traits::eq_int_type(buf.sputbackc(*(--last)), traits::eof()))
+		    {
+		      parser.next(obj);
+		      return std::ios::badbit;
+		    }
+		}
+	    }
+	  else
+	    {
+	      // Unbuffered streams are read one character at a time, the
+	      // character is only consumed if it belongs to the object.
+	      const char x = traits::to_char_type(c);
+	      if (parser.feed_value(&x, &x + 1) != &x)
+		{
+		  buf.sbumpc();
+		}
+	    }
+
+	  if (parser.next(obj))
+	    {
+	      return std::ios::goodbit;
+	    }
+	}
+    }
+
+  }
+
+  std::istream &read_stream(std::istream &is, object &obj)
+  {
+    const std::istream::sentry sentry (is, true);
+    if (sentry)
+      {
+	std::ios::iostate state = std::ios::goodbit;
+	try
+	  {
+	    state = read_streambuf(*is.rdbuf(), obj);
+	  }
+	catch (const error &)
+	  {
+	    is.setstate(std::ios::failbit);
+	    throw;
+	  }
+	is.setstate(state);
+      }
+    return is;
+  }
+
+  object read(std::istream &is)
+  {
+    object obj;
+    read_stream(is, obj);
+    return obj;
+  }
+
+}
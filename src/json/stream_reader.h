@@ -0,0 +1,67 @@
+/*
+ * Copyright 2012 Achille Roussel.
+ *
+ * This file is part of Libjson++.
+ *
+ * Libjson++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Libjson++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JSON_STREAM_READER_H
+#define JSON_STREAM_READER_H
+
+#include <iosfwd>
+#include "json/def.h"
+
+namespace json
+{
+
+  /**
+   * @brief Reads a JSON object from a stream.
+   *
+   * The characters held by the get area of the stream buffer are pulled in
+   * blocks with <em>sgetn</em> instead of being extracted one at a time, a
+   * stream buffer without a get area is read a character at a time. The object
+   * is built by a <em>json::push_parser</em> as its characters are received.
+   * This is the function used by <em>operator&gt;&gt;</em>.
+   * <br/>
+   * Only the characters of the object are consumed, what follows it is left
+   * in the stream so consecutive objects can be read from the same stream.
+   * The <em>skipws</em> flag of the stream is ignored: whitespace is skipped
+   * between JSON tokens and preserved in strings.
+   *
+   * @param is The stream to read the JSON object from.
+   * @param obj The destination object to build from the parsed data.
+   *
+   * @return The function returns 'is'.
+   *
+   * @note The function throws a <em>json::error</em> and sets the failbit of
+   * the stream if the input is not valid JSON, the eofbit is set if the end of
+   * the stream was reached. The badbit is set if the stream buffer refused to
+   * take back the characters read past the object.
+   */
+  std::istream &read_stream(std::istream &is, object &obj);
+
+  /**
+   * @brief Reads a JSON object from a stream.
+   *
+   * @param is The stream to read the JSON object from (see
+   * <em>json::read_stream</em>).
+   *
+   * @return The function returns the newly created instance of <em>json::object</em>.
+   */
+  object read(std::istream &is);
+
+}
+
+#endif // JSON_STREAM_READER_H
@@ -0,0 +1,200 @@
+/*
+ * Copyright 2012 Achille Roussel.
+ *
+ * This file is part of Libjson++.
+ *
+ * Libjson++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Libjson++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JSON_STRING_POOL_H
+#define JSON_STRING_POOL_H
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "json/def.h"
+#include "json/hash_key.h"
+
+namespace json
+{
+
+  /**
+   * @brief A pool of shared, reference counted strings.
+   *
+   * Documents often repeat the same short values (status codes, country
+   * codes, host names...) and every string object holds its own copy of
+   * them. While a pool is in use on a thread (see <em>scope</em>), the
+   * strings assigned to objects and the strings read by the parsers are
+   * looked up in the pool instead: all the objects holding the same value
+   * share one immutable string, and two strings of the same pool are equal
+   * only if they are the same string.
+   * <br/>
+   * The const <em>get_string</em> of an object returns the pooled string
+   * itself, the non-const one copies it to a string owned by the object
+   * first. Copies of the object share it. Strings longer than
+   * <em>max_length</em> are not pooled, and once the pool holds
+   * <em>capacity</em> characters the strings only the pool refers to are
+   * dropped to make room; new values are stored in the objects when there
+   * is none. Only objects using <em>std::allocator</em> use the pool, the
+   * ones allocated in an arena never do.
+   * <pre>
+   * json::string_pool pool;
+   * json::string_pool::scope use (pool);
+   * json::object obj (json::read(payload));
+   * obj["status"] = "OK";
+   * </pre>
+   * The strings are released when neither the pool nor any object refers to
+   * them anymore. A pool created synchronized can be used by several threads
+   * at once.
+   */
+  template < typename Char, typename Traits >
+  class basic_string_pool
+  {
+
+  public:
+
+    typedef Char				char_type;
+    typedef Traits				traits_type;
+    typedef basic_char_sequence<Char, Traits>	char_sequence_type;
+    typedef std::basic_string<Char, Traits>	string_type;
+    typedef std::size_t				size_type;
+
+    enum
+      {
+	default_capacity   = 1024 * 1024,
+	default_max_length = 64
+      };
+
+    /**
+     * @brief Makes a pool the one used by the current thread until the scope
+     * is destroyed, a null pointer suspends the use of a pool.
+     */
+    class scope
+    {
+
+    public:
+
+      explicit scope(basic_string_pool &pool);
+
+      explicit scope(basic_string_pool *pool);
+
+      ~scope();
+
+    private:
+      scope(const scope &) = delete;
+
+      scope &operator=(const scope &) = delete;
+
+      basic_string_pool *	_previous;
+
+    };
+
+    /**
+     * @brief A string of the pool, immutable and shared by the objects
+     * holding it, it is released with its last reference.
+     */
+    struct pooled_string
+    {
+      pooled_string(const char_sequence_type &s, size_type owner);
+
+      string_type			string;
+      mutable std::atomic<size_type>	references;
+      size_type				owner;
+    };
+
+    explicit basic_string_pool(size_type capacity = default_capacity,
+			       size_type max_length = default_max_length,
+			       bool synchronized = false);
+
+    ~basic_string_pool();
+
+    /**
+     * @brief Looks 's' up in the pool, adding it if there is room for it.
+     * On success 'pooled' is set to the string of the pool and a reference
+     * is taken on it for the caller, which must drop it with
+     * <em>release</em>.
+     */
+    bool acquire(const char_sequence_type &s, const pooled_string *&pooled);
+
+    /**
+     * @brief Drops the strings no object refers to anymore.
+     */
+    void purge();
+
+    /**
+     * @brief Releases the references of the pool on its strings, the objects
+     * still using them keep them alive.
+     */
+    void clear();
+
+    size_type size() const;
+
+    bool empty() const;
+
+    /**
+     * @brief Returns the number of characters of the strings in the pool.
+     */
+    size_type length() const;
+
+    size_type capacity() const;
+
+    size_type max_length() const;
+
+    bool synchronized() const;
+
+    /**
+     * @brief Returns the pool in use on the current thread, or a null
+     * pointer.
+     */
+    static basic_string_pool *current();
+
+    static void retain(const pooled_string *s);
+
+    static void release(const pooled_string *s);
+
+    /**
+     * @brief Returns true if the pooled strings 's1' and 's2' come from the
+     * same pool, they are then equal only if they are the same string.
+     */
+    static bool same_pool(const pooled_string *s1, const pooled_string *s2);
+
+  private:
+    typedef hash_key<Char, Traits> key_type;
+
+    basic_string_pool(const basic_string_pool &) = delete;
+
+    basic_string_pool &operator=(const basic_string_pool &) = delete;
+
+    void purge_unlocked();
+
+    static size_type next_owner();
+
+    std::unordered_map<key_type, pooled_string *>	_strings;
+    mutable std::mutex					_mutex;
+    size_type						_owner;
+    size_type						_length;
+    size_type						_capacity;
+    size_type						_max_length;
+    bool						_synchronized;
+
+    static thread_local basic_string_pool *_current;
+
+  };
+
+  extern template class basic_string_pool<char, char_traits>;
+
+}
+
+#endif // JSON_STRING_POOL_H
@@ -0,0 +1,301 @@
+/*
+ * Copyright 2012 Achille Roussel.
+ *
+ * This file is part of Libjson++.
+ *
+ * Libjson++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Libjson++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JSON_STRING_POOL_HPP
+#define JSON_STRING_POOL_HPP
+
+#include "json/hash_key.hpp"
+#include "json/string_pool.h"
+
+namespace json
+{
+
+  template < typename Char, typename Traits >
+  thread_local basic_string_pool<Char, Traits> *
+  basic_string_pool<Char, Traits>::_current = nullptr;
+
+  template < typename Char, typename Traits >
+  basic_string_pool<Char, Traits>::scope::
+  scope(basic_string_pool &pool):
+    _previous(_current)
+  {
+    _current = &pool;
+  }
+
+  template < typename Char, typename Traits >
+  basic_string_pool<Char, Traits>::scope::
+  scope(basic_string_pool *pool):
+    _previous(_current)
+  {
+    _current = pool;
+  }
+
+  template < typename Char, typename Traits >
+  basic_string_pool<Char, Traits>::scope::
+  ~scope()
+  {
+    _current = _previous;
+  }
+
+  template < typename Char, typename Traits >
+  basic_string_pool<Char, Traits>::pooled_string::
+  pooled_string(const char_sequence_type &s, const size_type owner):
+    string(s.data(), s.size()),
+    references(1),
+    owner(owner)
+  {
+  }
+
+  template < typename Char, typename Traits >
+  basic_string_pool<Char, Traits>::
+  basic_string_pool(const size_type capacity,
+		    const size_type max_length,
+		    const bool synchronized):
+    _strings(),
+    _mutex(),
+    _owner(next_owner()),
+    _length(0),
+    _capacity(capacity),
+    _max_length(max_length),
+    _synchronized(synchronized)
+  {
+  }
+
+  template < typename Char, typename Traits >
+  basic_string_pool<Char, Traits>::
+  ~basic_string_pool()
+  {
+    clear();
+  }
+
+  template < typename Char, typename Traits >
+  bool
+  basic_string_pool<Char, Traits>::
+  acquire(const char_sequence_type &s, const pooled_string *&pooled)
+  {
+    const size_type n = s.size();
+    if (n > _max_length)
+      {
+	return false;
+      }
+
+    const key_type k (s);
+    std::unique_lock<std::mutex> lock (_mutex, std::defer_lock);
+    if (_synchronized)
+      {
+	lock.lock();
+      }
+
+    const auto it = _strings.find(k);
+    if (it != _strings.end())
+      {
+	retain(it->second);
+	pooled = it->second;
+	return true;
+      }
+
+    if ((_length + n) > _capacity)
+      {
+	purge_unlocked();
+	if ((_length + n) > _capacity)
+	  {
+	    return false;
+	  }
+      }
+
+    pooled_string *p = new pooled_string(s, _owner);
+    try
+      {
+	_strings.emplace(key_type(char_sequence_type(p->string), k.hash(), true, false), p);
+      }
+    catch (...)
+      {
+	delete p;
+	throw;
+      }
+    _length += n;
+    retain(p);
+    pooled = p;
+    return true;
+  }
+
+  // Only the pool can take a new reference on a string it is the last one to
+  // refer to, which is done under its lock.
+  template < typename Char, typename Traits >
+  void
+  basic_string_pool<Char, Traits>::
+  purge_unlocked()
+  {
+    auto it = _strings.begin();
+    while (it != _strings.end())
+      {
+	if (it->second->references.load(std::memory_order_acquire) == 1)
+	  {
+	    _length -= it->first.size();
+	    release(it->second);
+	    it = _strings.erase(it);
+	  }
+	else
+	  {
+	    ++it;
+	  }
+      }
+  }
+
+  template < typename Char, typename Traits >
+  void
+  basic_string_pool<Char, Traits>::
+  purge()
+  {
+    std::unique_lock<std::mutex> lock (_mutex, std::defer_lock);
+    if (_synchronized)
+      {
+	lock.lock();
+      }
+    purge_unlocked();
+  }
+
+  // The strings still used by objects are not known to the pool anymore, the
+  // ones added next belong to a new owner so that they are never taken for
+  // different values of the same pool.
+  template < typename Char, typename Traits >
+  void
+  basic_string_pool<Char, Traits>::
+  clear()
+  {
+    std::unique_lock<std::mutex> lock (_mutex, std::defer_lock);
+    if (_synchronized)
+      {
+	lock.lock();
+      }
+
+    for (const auto &s : _strings)
+      {
+	release(s.second);
+      }
+    _strings.clear();
+    _length = 0;
+    _owner = next_owner();
+  }
+
+  template < typename Char, typename Traits >
+  typename basic_string_pool<Char, Traits>::size_type
+  basic_string_pool<Char, Traits>::
+  size() const
+  {
+    std::unique_lock<std::mutex> lock (_mutex, std::defer_lock);
+    if (_synchronized)
+      {
+	lock.lock();
+      }
+    return _strings.size();
+  }
+
+  template < typename Char, typename Traits >
+  bool
+  basic_string_pool<Char, Traits>::
+  empty() const
+  {
+    return size() == 0;
+  }
+
+  template < typename Char, typename Traits >
+  typename basic_string_pool<Char, Traits>::size_type
+  basic_string_pool<Char, Traits>::
+  length() const
+  {
+    std::unique_lock<std::mutex> lock (_mutex, std::defer_lock);
+    if (_synchronized)
+      {
+	lock.lock();
+      }
+    return _length;
+  }
+
+  template < typename Char, typename Traits >
+  typename basic_string_pool<Char, Traits>::size_type
+  basic_string_pool<Char, Traits>::
+  capacity() const
+  {
+    return _capacity;
+  }
+
+  template < typename Char, typename Traits >
+  typename basic_string_pool<Char, Traits>::size_type
+  basic_string_pool<Char, Traits>::
+  max_length() const
+  {
+    return _max_length;
+  }
+
+  template < typename Char, typename Traits >
+  bool
+  basic_string_pool<Char, Traits>::
+  synchronized() const
+  {
+    return _synchronized;
+  }
+
+  template < typename Char, typename Traits >
+  basic_string_pool<Char, Traits> *
+  basic_string_pool<Char, Traits>::
+  current()
+  {
+    return _current;
+  }
+
+  template < typename Char, typename Traits >
+  void
+  basic_string_pool<Char, Traits>::
+  retain(const pooled_string *s)
+  {
+    s->references.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  template < typename Char, typename Traits >
+  void
+  basic_string_pool<Char, Traits>::
+  release(const pooled_string *s)
+  {
+    if (s->references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+      {
+	delete s;
+      }
+  }
+
+  template < typename Char, typename Traits >
+  bool
+  basic_string_pool<Char, Traits>::
+  same_pool(const pooled_string *s1, const pooled_string *s2)
+  {
+    return s1->owner == s2->owner;
+  }
+
+  template < typename Char, typename Traits >
+  typename basic_string_pool<Char, Traits>::size_type
+  basic_string_pool<Char, Traits>::
+  next_owner()
+  {
+    static std::atomic<size_type> owners (0);
+    return ++owners;
+  }
+
+}
+
+#endif // JSON_STRING_POOL_HPP
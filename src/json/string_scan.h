@@ -0,0 +1,80 @@
+/*
+ * Copyright 2012 Achille Roussel.
+ *
+ * This file is part of Libjson++.
+ *
+ * Libjson++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Libjson++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JSON_STRING_SCAN_H
+#define JSON_STRING_SCAN_H
+
+#include "json/simd.h"
+
+namespace json
+{
+
+#if JSON_SIMD_SSE2
+  inline int string_scan_mask(const char *first, const __m128i quote, const __m128i backslash)
+  {
+    const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i *>(first));
+    return _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(c, quote),
+					  _mm_cmpeq_epi8(c, backslash)));
+  }
+#endif
+
+  /**
+   * @brief Finds the end of a run of plain string data.
+   *
+   * The function returns a pointer to the first '"' or '\\' character in
+   * [first, last), or <em>last</em> if there is none. On x86-64 the range is
+   * tested 32 then 16 bytes at a time, no byte past <em>last</em> is read.
+   */
+  inline const char *scan_string(const char *first, const char *last)
+  {
+#if JSON_SIMD_SSE2
+    const __m128i quote     = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+
+    while ((last - first) >= 32)
+      {
+	const std::uint32_t lo = string_scan_mask(first, quote, backslash);
+	const std::uint32_t hi = string_scan_mask(first + 16, quote, backslash);
+	const std::uint32_t mask = lo | (hi << 16);
+	if (mask != 0)
+	  {
+	    return first + trailing_zeroes(mask);
+	  }
+	first += 32;
+      }
+    if ((last - first) >= 16)
+      {
+	const std::uint32_t mask = string_scan_mask(first, quote, backslash);
+	if (mask != 0)
+	  {
+	    return first + trailing_zeroes(mask);
+	  }
+	first += 16;
+      }
+#endif
+    while ((first != last) && ((*first) != '"') && ((*first) != '\\'))
+      {
+	++first;
+      }
+    return first;
+  }
+
+}
+
+#endif // JSON_STRING_SCAN_H
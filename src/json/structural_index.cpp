@@ -0,0 +1,564 @@
+/*
+ * Copyright 2012 Achille Roussel.
+ *
+ * This file is part of Libjson++.
+ *
+ * Libjson++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Libjson++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include "json/error.h"
+#include "json/simd.h"
+#include "json/structural_index.hpp"
+#include "json/object.hpp"
+
+namespace json
+{
+
+  [[noreturn]]
+  void error_index_input_too_large()
+  {
+    throw error("json::structural_index: input is too large to be indexed");
+  }
+
+  namespace
+  {
+
+    // Bit masks of one 64 bytes block of input, bit i is set if the i-th
+    // character of the block belongs to the class.
+    struct block_masks
+    {
+      std::uint64_t quote;
+      std::uint64_t backslash;
+      std::uint64_t op;
+      std::uint64_t space;
+    };
+
+    // Carries the state of the scan from one block to the next.
+    struct index_state
+    {
+      std::uint64_t odd_backslash;  // 1 if the previous block ended with an odd run of '\\'
+      std::uint64_t in_string;      // all ones if the previous block ended inside a string
+      std::uint64_t pseudo_pred;    // 1 if the last character of the previous block was a space or an operator
+
+      index_state():
+	odd_backslash(0),
+	in_string(0),
+	pseudo_pred(1)
+      {
+      }
+    };
+
+#if !JSON_SIMD_SSE2
+    inline void classify_scalar(const char *block, block_masks &m)
+    {
+      m.quote = m.backslash = m.op = m.space = 0;
+      for (int i = 0; i != 64; ++i)
+	{
+	  const std::uint64_t bit = std::uint64_t(1) << i;
+	  switch (block[i])
+	    {
+	    case '"':  m.quote     |= bit; break;
+	    case '\\': m.backslash |= bit; break;
+	    case '{': case '}': case '[': case ']': case ':': case ',':
+	      m.op |= bit;
+	      break;
+	    case ' ': case '\t': case '\n': case '\r':
+	      m.space |= bit;
+	      break;
+	    }
+	}
+    }
+#endif
+
+#if JSON_SIMD_SSE2
+    inline std::uint64_t sse2_mask(const __m128i *v, const char c)
+    {
+      const __m128i x = _mm_set1_epi8(c);
+      std::uint64_t m0 = std::uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(v[0], x)));
+      std::uint64_t m1 = std::uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(v[1], x)));
+      std::uint64_t m2 = std::uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(v[2], x)));
+      std::uint64_t m3 = std::uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(v[3], x)));
+      return m0 | (m1 << 16) | (m2 << 32) | (m3 << 48);
+    }
+
+    inline void classify_sse2(const char *block, block_masks &m)
+    {
+      __m128i v[4];
+      __m128i w[4];
+      const __m128i lower = _mm_set1_epi8(0x20);
+      for (int i = 0; i != 4; ++i)
+	{
+	  v[i] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + 16 * i));
+	  w[i] = _mm_or_si128(v[i], lower); // maps '[' to '{' and ']' to '}'
+	}
+      m.quote     = sse2_mask(v, '"');
+      m.backslash = sse2_mask(v, '\\');
+      m.op        = sse2_mask(w, '{') | sse2_mask(w, '}') | sse2_mask(v, ':') | sse2_mask(v, ',');
+      m.space     = sse2_mask(v, ' ') | sse2_mask(v, '\t') | sse2_mask(v, '\n') | sse2_mask(v, '\r');
+    }
+#endif
+
+#if JSON_SIMD_AVX2
+    JSON_TARGET_AVX2
+    inline std::uint64_t avx2_mask(const __m256i *v, const char c)
+    {
+      const __m256i x = _mm256_set1_epi8(c);
+      std::uint64_t m0 = std::uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v[0], x)));
+      std::uint64_t m1 = std::uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v[1], x)));
+      return m0 | (m1 << 32);
+    }
+
+    JSON_TARGET_AVX2
+    inline void classify_avx2(const char *block, block_masks &m)
+    {
+      __m256i v[2];
+      __m256i w[2];
+      const __m256i lower = _mm256_set1_epi8(0x20);
+      for (int i = 0; i != 2; ++i)
+	{
+	  v[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block + 32 * i));
+	  w[i] = _mm256_or_si256(v[i], lower); // maps '[' to '{' and ']' to '}'
+	}
+      m.quote     = avx2_mask(v, '"');
+      m.backslash = avx2_mask(v, '\\');
+      m.op        = avx2_mask(w, '{') | avx2_mask(w, '}') | avx2_mask(v, ':') | avx2_mask(v, ',');
+      m.space     = avx2_mask(v, ' ') | avx2_mask(v, '\t') | avx2_mask(v, '\n') | avx2_mask(v, '\r');
+    }
+#endif
+
+    // Returns the mask of characters escaped by an odd-length sequence of
+    // backslashes, the carry between blocks is kept in 'odd_backslash'.
+    inline std::uint64_t find_escaped(const std::uint64_t backslash, std::uint64_t &odd_backslash)
+    {
+      const std::uint64_t even_bits = 0x5555555555555555ULL;
+      const std::uint64_t odd_bits  = ~even_bits;
+
+      const std::uint64_t start_edges     = backslash & ~(backslash << 1);
+      const std::uint64_t even_start_mask = even_bits ^ odd_backslash;
+      const std::uint64_t even_starts     = start_edges & even_start_mask;
+      const std::uint64_t odd_starts      = start_edges & ~even_start_mask;
+      const std::uint64_t even_carries    = backslash + even_starts;
+
+      std::uint64_t odd_carries = backslash + odd_starts;
+      const bool ends_odd = odd_carries < backslash;
+      odd_carries |= odd_backslash;
+      odd_backslash = ends_odd ? 1 : 0;
+
+      const std::uint64_t even_carry_ends = even_carries & ~backslash;
+      const std::uint64_t odd_carry_ends  = odd_carries & ~backslash;
+      return (even_carry_ends & odd_bits) | (odd_carry_ends & even_bits);
+    }
+
+    inline std::uint64_t prefix_xor(std::uint64_t x)
+    {
+      x ^= x << 1;
+      x ^= x << 2;
+      x ^= x << 4;
+      x ^= x << 8;
+      x ^= x << 16;
+      x ^= x << 32;
+      return x;
+    }
+
+    inline std::uint64_t structurals(const block_masks &m, index_state &s)
+    {
+      const std::uint64_t escaped = find_escaped(m.backslash, s.odd_backslash);
+      const std::uint64_t quotes  = m.quote & ~escaped;
+      const std::uint64_t strings = prefix_xor(quotes) ^ s.in_string;
+      s.in_string = std::uint64_t(std::int64_t(strings) >> 63);
+
+      // Operators outside of strings and quotes, the closing quotes are then
+      // removed after being used to find the beginning of scalars.
+      std::uint64_t bits = (m.op & ~strings) | quotes;
+      const std::uint64_t pseudo_pred = bits | m.space;
+      const std::uint64_t shifted = (pseudo_pred << 1) | s.pseudo_pred;
+      s.pseudo_pred = pseudo_pred >> 63;
+      bits |= shifted & ~m.space & ~strings;
+      return bits & ~(quotes & ~strings);
+    }
+
+    inline void flatten(std::uint64_t bits,
+			const structural_index::offset_type base,
+			structural_index::offset_type *&out)
+    {
+      while (bits)
+	{
+	  *out++ = base + trailing_zeroes(bits);
+	  bits &= bits - 1;
+	}
+    }
+
+    // The vectorized classifiers may read a whole block, so the last partial
+    // block of the input is copied to a buffer padded with spaces.
+    template < typename Classify >
+    inline void index_block(const char *first,
+			    const std::size_t n,
+			    const structural_index::offset_type base,
+			    index_state &s,
+			    structural_index::offset_type *&out,
+			    Classify classify)
+    {
+      block_masks m;
+      if (n == 64)
+	{
+	  classify(first, m);
+	}
+      else
+	{
+	  char block[64];
+	  std::memset(block, ' ', sizeof(block));
+	  std::memcpy(block, first, n);
+	  classify(block, m);
+	}
+      flatten(structurals(m, s), base, out);
+    }
+
+    // The index functions scan data[begin, end) and write the offsets of its
+    // structural characters relative to 'data', 'begin' must be a multiple of
+    // the block size.
+    typedef void (*index_function)(const char *,
+				   std::size_t,
+				   std::size_t,
+				   index_state &,
+				   structural_index::offset_type *&);
+
+#if !JSON_SIMD_SSE2
+    void index_scalar(const char *data,
+		      const std::size_t begin,
+		      const std::size_t end,
+		      index_state &s,
+		      structural_index::offset_type *&out)
+    {
+      for (std::size_t i = begin; i < end; i += 64)
+	{
+	  const std::size_t n = ((end - i) < 64) ? (end - i) : 64;
+	  index_block(data + i, n, i, s, out, classify_scalar);
+	}
+    }
+#endif
+
+#if JSON_SIMD_SSE2
+    void index_sse2(const char *data,
+		    const std::size_t begin,
+		    const std::size_t end,
+		    index_state &s,
+		    structural_index::offset_type *&out)
+    {
+      for (std::size_t i = begin; i < end; i += 64)
+	{
+	  const std::size_t n = ((end - i) < 64) ? (end - i) : 64;
+	  index_block(data + i, n, i, s, out, classify_sse2);
+	}
+    }
+#endif
+
+#if JSON_SIMD_AVX2
+    JSON_TARGET_AVX2
+    void index_avx2(const char *data,
+		    const std::size_t begin,
+		    const std::size_t end,
+		    index_state &s,
+		    structural_index::offset_type *&out)
+    {
+      block_masks m;
+      std::size_t i = begin;
+      for (; (i + 64) <= end; i += 64)
+	{
+	  classify_avx2(data + i, m);
+	  flatten(structurals(m, s), i, out);
+	}
+      if (i != end)
+	{
+	  char block[64];
+	  std::memset(block, ' ', sizeof(block));
+	  std::memcpy(block, data + i, end - i);
+	  classify_avx2(block, m);
+	  flatten(structurals(m, s), i, out);
+	}
+    }
+#endif
+
+    index_function select_index_function()
+    {
+#if JSON_SIMD_AVX2
+      if (cpu_has_avx2())
+	{
+	  return index_avx2;
+	}
+#endif
+#if JSON_SIMD_SSE2
+      return index_sse2;
+#else
+      return index_scalar;
+#endif
+    }
+
+    const index_function index_input = select_index_function();
+
+    enum
+      {
+	// Inputs are only split in chunks of at least this size, smaller ones
+	// are indexed faster than threads can be started.
+	parallel_chunk_size = 1 << 20
+      };
+
+    struct index_chunk
+    {
+      std::size_t			begin;
+      std::size_t			end;
+      std::size_t			size;
+      bool				in_string;
+      index_state			start;
+      index_state			state;
+
+      index_chunk():
+	begin(0),
+	end(0),
+	size(0),
+	in_string(false),
+	start(),
+	state()
+      {
+      }
+    };
+
+    // Calls f(0) ... f(n - 1), the calling thread takes part in the work.
+    // The threads already started are joined before an exception, thrown
+    // either by f(0) or by the creation of a thread, is propagated.
+    template < typename Function >
+    void run_parallel(const std::size_t n, Function f)
+    {
+      std::vector<std::thread> threads;
+      try
+	{
+	  for (std::size_t i = 1; i < n; ++i)
+	    {
+	      threads.emplace_back(f, i);
+	    }
+	  f(0);
+	}
+      catch (...)
+	{
+	  for (auto &thread : threads)
+	    {
+	      thread.join();
+	    }
+	  throw;
+	}
+      for (auto &thread : threads)
+	{
+	  thread.join();
+	}
+    }
+
+  }
+
+  structural_index::structural_index():
+    _offsets(),
+    _size(0),
+    _capacity(0)
+  {
+  }
+
+  structural_index::structural_index(structural_index &&index):
+    _offsets(std::move(index._offsets)),
+    _size(index._size),
+    _capacity(index._capacity)
+  {
+    index._size = 0;
+    index._capacity = 0;
+  }
+
+  structural_index &structural_index::operator=(structural_index &&index)
+  {
+    std::swap(_offsets, index._offsets);
+    std::swap(_size, index._size);
+    std::swap(_capacity, index._capacity);
+    return *this;
+  }
+
+  void structural_index::build(const char *first, const char *last)
+  {
+    const std::size_t size = last - first;
+    reserve(size);
+
+    offset_type *out = _offsets.get();
+    index_state s;
+    index_input(first, 0, size, s, out);
+    _size = out - _offsets.get();
+
+    if (s.in_string)
+      {
+	error_invalid_input_eof();
+      }
+  }
+
+  // The input is split in chunks of whole blocks indexed concurrently, each
+  // one writing its offsets to the part of the buffer starting at the offset
+  // of its first character (a chunk can't have more structural characters
+  // than characters).
+  // Whether a chunk begins inside a string depends on the parity of the
+  // quotes of all the chunks before it, so the chunks are first indexed as if
+  // they began outside of strings and the prefix-xor of their quote parities
+  // is then computed. Those which actually begin inside a string are indexed
+  // again before the parts of the buffer are moved next to each other.
+  void structural_index::build(const char *first, const char *last, unsigned threads)
+  {
+    const std::size_t size = last - first;
+    if (threads == 0)
+      {
+	threads = std::max(1u, std::thread::hardware_concurrency());
+      }
+
+    std::size_t count = std::min<std::size_t>(threads, size / parallel_chunk_size);
+    if (count < 2)
+      {
+	build(first, last);
+	return;
+      }
+    reserve(size);
+
+    const std::size_t chunk_size = ((size / count) + 63) & ~std::size_t(63);
+    count = (size + chunk_size - 1) / chunk_size;
+
+    std::vector<index_chunk> chunks (count);
+    for (std::size_t i = 0; i != count; ++i)
+      {
+	index_chunk &c = chunks[i];
+	c.begin = i * chunk_size;
+	c.end   = std::min(size, c.begin + chunk_size);
+	if (i != 0)
+	  {
+	    // An odd run of backslashes before the chunk escapes its first
+	    // character, the run may start in any previous chunk.
+	    std::size_t n = 0;
+	    while ((n != c.begin) && (first[c.begin - n - 1] == '\\'))
+	      {
+		++n;
+	      }
+	    const char p = first[c.begin - 1];
+	    c.start.odd_backslash = n & 1;
+	    c.start.pseudo_pred   = one_of(p, ' ', '\t', '\n', '\r', '"', '{', '}', '[', ']', ':', ',') ? 1 : 0;
+	  }
+      }
+
+    auto index_chunks = [&](const bool in_string) {
+      run_parallel(count, [&](const std::size_t i) {
+	  index_chunk &c = chunks[i];
+	  if (c.in_string != in_string)
+	    {
+	      return;
+	    }
+	  c.state = c.start;
+	  c.state.in_string = in_string ? ~std::uint64_t(0) : 0;
+	  offset_type *out = _offsets.get() + c.begin;
+	  index_input(first, c.begin, c.end, c.state, out);
+	  c.size = out - (_offsets.get() + c.begin);
+	});
+    };
+
+    index_chunks(false);
+
+    std::uint64_t in_string = 0;
+    bool          redo      = false;
+    for (auto &c : chunks)
+      {
+	c.in_string = (in_string != 0);
+	redo = redo || c.in_string;
+	in_string ^= c.state.in_string;
+      }
+    if (redo)
+      {
+	index_chunks(true);
+      }
+
+    offset_type *out = _offsets.get();
+    for (const auto &c : chunks)
+      {
+	std::memmove(out, _offsets.get() + c.begin, c.size * sizeof(offset_type));
+	out += c.size;
+      }
+    _size = out - _offsets.get();
+
+    if (in_string)
+      {
+	error_invalid_input_eof();
+      }
+  }
+
+  // There can't be more structural characters than input characters, the
+  // buffer is only grown when needed so an index can be reused for many
+  // documents without allocating memory.
+  void structural_index::reserve(const size_type size)
+  {
+    if (size >= 0xFFFFFFFFU)
+      {
+	error_index_input_too_large();
+      }
+    if (_capacity < (size + 1))
+      {
+	_offsets.reset(new offset_type[size + 1]);
+	_capacity = size + 1;
+      }
+  }
+
+  void structural_index::clear()
+  {
+    _size = 0;
+  }
+
+  structural_index::size_type structural_index::size() const
+  {
+    return _size;
+  }
+
+  bool structural_index::empty() const
+  {
+    return _size == 0;
+  }
+
+  const structural_index::offset_type *structural_index::data() const
+  {
+    return _offsets.get();
+  }
+
+  structural_index::const_iterator structural_index::begin() const
+  {
+    return _offsets.get();
+  }
+
+  structural_index::const_iterator structural_index::end() const
+  {
+    return _offsets.get() + _size;
+  }
+
+  structural_index::offset_type structural_index::operator[](const size_type index) const
+  {
+    return _offsets[index];
+  }
+
+  template const char *read_indexed(const char *,
+				    const char *,
+				    const structural_index &,
+				    object &);
+
+  template const char *read_indexed(const char *, const char *, object &);
+
+  template const char *read_indexed(const char *, const char *, unsigned, object &);
+
+}
@@ -0,0 +1,162 @@
+/*
+ * Copyright 2012 Achille Roussel.
+ *
+ * This file is part of Libjson++.
+ *
+ * Libjson++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Libjson++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JSON_STRUCTURAL_INDEX_H
+#define JSON_STRUCTURAL_INDEX_H
+
+#include <cstdint>
+#include <memory>
+#include "json/def.h"
+
+namespace json
+{
+
+  /**
+   * @brief The positions of all structural characters of a JSON document.
+   *
+   * Building the index is the first stage of the two-stage reader: the input
+   * is scanned 64 bytes at a time with vector instructions (AVX2 or SSE2 on
+   * x86, selected at runtime, with a scalar fallback elsewhere) to find the
+   * '{', '}', '[', ']', ':', ',' characters and the opening '"' of strings
+   * that aren't part of a string, as well as the first character of every
+   * number and literal.
+   * <br/>
+   * The second stage (<em>json::read_indexed</em>) then walks the offsets
+   * stored in the index instead of testing every byte of the input.
+   */
+  class structural_index
+  {
+
+  public:
+
+    typedef std::uint32_t				offset_type;
+    typedef std::size_t					size_type;
+    typedef const offset_type *				const_iterator;
+
+    structural_index();
+
+    structural_index(structural_index &&index);
+
+    structural_index &operator=(structural_index &&index);
+
+    /**
+     * @brief Indexes the characters in the range [first, last).
+     *
+     * The previous content of the index is discarded but its memory is kept
+     * for reuse.
+     *
+     * @note The function throws a <em>json::error</em> if a string is not
+     * terminated before the end of the input.
+     */
+    void build(const char *first, const char *last);
+
+    /**
+     * @brief Indexes the characters in the range [first, last) with several
+     * threads.
+     *
+     * The input is split in chunks indexed concurrently, the state of the
+     * scan at the beginning of each chunk (inside a string or not, escaped
+     * character or not) is resolved from the chunks before it. The result is
+     * the same as the one of the single-threaded <em>build</em>, which is used
+     * for inputs too small to benefit from threads.
+     *
+     * @param threads The number of threads to use, zero uses one thread per
+     * hardware thread.
+     */
+    void build(const char *first, const char *last, unsigned threads);
+
+    void clear();
+
+    size_type size() const;
+
+    bool empty() const;
+
+    const offset_type *data() const;
+
+    const_iterator begin() const;
+
+    const_iterator end() const;
+
+    offset_type operator[](size_type index) const;
+
+  private:
+    void reserve(size_type size);
+
+    std::unique_ptr<offset_type[]>	_offsets;
+    size_type				_size;
+    size_type				_capacity;
+
+  };
+
+  /**
+   * @brief Reads JSON from a contiguous buffer using a structural index.
+   *
+   * @param first A pointer to the first character of the buffer.
+   * @param last A pointer to the end of the buffer, <em>*last</em> must be
+   * readable and equal to '\\0' (see <em>json::read_buffer</em>).
+   * @param index The structural index of [first, last).
+   * @param obj The destination object to build from the parsed data.
+   *
+   * @return The function returns a pointer to the first character following
+   * the parsed JSON object.
+   */
+  template < typename Traits, typename Allocator >
+  const char *read_indexed(const char *first,
+			   const char *last,
+			   const structural_index &index,
+			   basic_object<char, Traits, Allocator> &obj);
+
+  /**
+   * @brief Reads JSON from a contiguous buffer with the two-stage reader.
+   *
+   * This is a shortcut for building a <em>json::structural_index</em> of the
+   * input and calling <em>json::read_indexed</em> with it.
+   */
+  template < typename Traits, typename Allocator >
+  const char *read_indexed(const char *first,
+			   const char *last,
+			   basic_object<char, Traits, Allocator> &obj);
+
+  /**
+   * @brief Reads JSON from a contiguous buffer with the two-stage reader,
+   * the structural index is built with several threads.
+   *
+   * This is meant for large documents of any shape: only the first stage is
+   * parallel, the object is then built from the index by the calling thread.
+   *
+   * @see structural_index::build
+   */
+  template < typename Traits, typename Allocator >
+  const char *read_indexed(const char *first,
+			   const char *last,
+			   unsigned threads,
+			   basic_object<char, Traits, Allocator> &obj);
+
+  extern template const char *read_indexed(const char *,
+					   const char *,
+					   const structural_index &,
+					   object &);
+
+  extern template const char *read_indexed(const char *, const char *, object &);
+
+  extern template const char *read_indexed(const char *, const char *, unsigned, object &);
+
+}
+
+#endif // JSON_STRUCTURAL_INDEX_H
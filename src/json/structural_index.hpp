@@ -0,0 +1,247 @@
+/*
+ * Copyright 2012 Achille Roussel.
+ *
+ * This file is part of Libjson++.
+ *
+ * Libjson++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Libjson++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JSON_STRUCTURAL_INDEX_HPP
+#define JSON_STRUCTURAL_INDEX_HPP
+
+#include "json/structural_index.h"
+#include "json/buffer_reader.hpp"
+
+namespace json
+{
+
+  typedef structural_index::offset_type index_offset;
+
+  inline const char *index_next(const char *data,
+				const index_offset *&first,
+				const index_offset *last)
+  {
+    if (first == last)
+      {
+	error_invalid_input_eof();
+      }
+    return data + (*first++);
+  }
+
+  inline char index_peek(const char *data,
+			 const index_offset *first,
+			 const index_offset *last)
+  {
+    if (first == last)
+      {
+	error_invalid_input_eof();
+      }
+    return data[*first];
+  }
+
+  // Scalars are parsed from the input buffer, only whitespace may stand
+  // between their last character and the next structural character.
+  inline void index_check_end(const char *data,
+			      const char *end,
+			      const index_offset *first,
+			      const index_offset *last)
+  {
+    if ((first != last) && (buffer_skip_spaces(end) != (data + (*first))))
+      {
+	error_invalid_input_non_json();
+      }
+  }
+
+  template < typename Traits, typename Allocator >
+  void index_read_object(const char *data,
+			 const char *&position,
+			 const char *last,
+			 const index_offset *&first,
+			 const index_offset *end,
+			 basic_object<char, Traits, Allocator> &obj);
+
+  template < typename Traits, typename Allocator >
+  void index_read_list(const char *data,
+		       const char *&position,
+		       const char *last,
+		       const index_offset *&first,
+		       const index_offset *end,
+		       basic_object<char, Traits, Allocator> &obj)
+  {
+    // Lists of numbers are packed like with the buffer reader, the offsets
+    // of the members consumed this way are then skipped.
+    const char *members = buffer_next_char(position + 1, last);
+    if (is_buffer_number(*members) && packing_scope::enabled())
+      {
+	typename basic_object<char, Traits, Allocator>::native_list values (obj.get_allocator());
+	object_type type;
+	if (buffer_read_packed(members, last, values, type))
+	  {
+	    obj.make_packed(type, std::move(values));
+	    while ((first != end) && ((data + (*first)) < members))
+	      {
+		++first;
+	      }
+	    position = members;
+	    return;
+	  }
+      }
+
+    obj.make_list();
+    auto &list = obj.get_list();
+    list.clear();
+
+    if (index_peek(data, first, end) == ']')
+      {
+	position = index_next(data, first, end) + 1;
+	return;
+      }
+
+    for (;;)
+      {
+	list.emplace_back(obj.get_allocator());
+	index_read_object(data, position, last, first, end, list.back());
+	position = index_next(data, first, end);
+	switch (*position++)
+	  {
+	  case ',': break;
+	  case ']': return;
+	  default:  error_invalid_input_non_json();
+	  }
+      }
+  }
+
+  template < typename Traits, typename Allocator >
+  void index_read_map(const char *data,
+		      const char *&position,
+		      const char *last,
+		      const index_offset *&first,
+		      const index_offset *end,
+		      basic_object<char, Traits, Allocator> &obj)
+  {
+    typedef basic_object<char, Traits, Allocator> object;
+    typedef typename object::object_string        string;
+
+    obj.make_map();
+    obj.get_map().clear();
+
+    if (index_peek(data, first, end) == '}')
+      {
+	position = index_next(data, first, end) + 1;
+	return;
+      }
+
+    string key (obj.get_allocator());
+    for (;;)
+      {
+	position = index_next(data, first, end);
+	if ((*position) != '"')
+	  {
+	    error_invalid_input_non_json();
+	  }
+	const auto k = buffer_read_key(position, last, key);
+	index_check_end(data, position, first, end);
+	if ((*index_next(data, first, end)) != ':')
+	  {
+	    error_invalid_input_non_json();
+	  }
+	index_read_object(data, position, last, first, end, obj[k]);
+	position = index_next(data, first, end);
+	switch (*position++)
+	  {
+	  case ',': break;
+	  case '}': return;
+	  default:  error_invalid_input_non_json();
+	  }
+      }
+  }
+
+  template < typename Traits, typename Allocator >
+  void index_read_object(const char *data,
+			 const char *&position,
+			 const char *last,
+			 const index_offset *&first,
+			 const index_offset *end,
+			 basic_object<char, Traits, Allocator> &obj)
+  {
+    position = index_next(data, first, end);
+    switch (*position)
+      {
+      case '[': index_read_list(data, position, last, first, end, obj); return;
+      case '{': index_read_map(data, position, last, first, end, obj);  return;
+
+      case 't':
+	buffer_read_equals(position, last, "true");
+	obj = true;
+	break;
+
+      case 'f':
+	buffer_read_equals(position, last, "false");
+	obj = false;
+	break;
+
+      case 'n':
+	buffer_read_equals(position, last, "null");
+	obj.make_null();
+	break;
+
+      case '"':
+	buffer_read_string_value(position, last, obj);
+	break;
+
+      default:
+	const char *number = position;
+	position = buffer_read_number(position);
+	obj.make_number(basic_char_sequence<char, Traits>(number, position - number));
+      }
+    index_check_end(data, position, first, end);
+  }
+
+  template < typename Traits, typename Allocator >
+  const char *read_indexed(const char *first,
+			   const char *last,
+			   const structural_index &index,
+			   basic_object<char, Traits, Allocator> &obj)
+  {
+    const index_offset *it = index.data();
+    const index_offset *jt = it + index.size();
+    const char *position = first;
+    index_read_object(first, position, last, it, jt, obj);
+    return position;
+  }
+
+  template < typename Traits, typename Allocator >
+  const char *read_indexed(const char *first,
+			   const char *last,
+			   basic_object<char, Traits, Allocator> &obj)
+  {
+    structural_index index;
+    index.build(first, last);
+    return read_indexed(first, last, index, obj);
+  }
+
+  template < typename Traits, typename Allocator >
+  const char *read_indexed(const char *first,
+			   const char *last,
+			   const unsigned threads,
+			   basic_object<char, Traits, Allocator> &obj)
+  {
+    structural_index index;
+    index.build(first, last, threads);
+    return read_indexed(first, last, index, obj);
+  }
+
+}
+
+#endif // JSON_STRUCTURAL_INDEX_HPP
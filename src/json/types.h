@@ -29,25 +29,67 @@ namespace json
   /**
    * @brief This enumeration provides a numeric representation of all types a
    * JSON object may have.
+   * <br/>
+   * Integers are stored as 'type_integer' when they fit in a long long, only
+   * the larger ones are 'type_unsigned'.
+   * <br/>
+   * The type is held in a byte so it packs with the flags of an object.
    */
-  enum object_type
+  enum object_type : unsigned char
     {
       type_null,
       type_string,
       type_list,
-      type_map
+      type_map,
+      type_boolean,
+      type_integer,
+      type_unsigned,
+      type_double
     };
 
+  /**
+   * @brief The value of a boolean or number, which of the members is set
+   * depends on the type of the object it belongs to.
+   */
+  union native_value
+  {
+    bool               boolean;
+    long long          integer;
+    unsigned long long unsigned_integer;
+    double             real;
+  };
+
+  enum
+    {
+      // Long enough for any double written with 17 significant digits.
+      number_text_size = 24
+    };
+
+  inline bool is_number_type(const object_type type)
+  {
+    return (type == type_integer) || (type == type_unsigned) || (type == type_double);
+  }
+
+  // Integers up to 2^53 are held exactly by a double.
+  inline bool is_exact_double(const long long x)
+  {
+    return (x >= -(1LL << 53)) && (x <= (1LL << 53));
+  }
+
   template < typename Char, typename Traits >
   inline std::basic_ostream<Char, Traits> &
   operator<<(std::basic_ostream<Char, Traits> &out, const object_type type)
   {
     switch (type)
       {
-      case type_string: return out << "<JSON string>";
-      case type_list:   return out << "<JSON list>";
-      case type_map:    return out << "<JSON map>";
-      case type_null:   return out << "<JSON null>";
+      case type_string:   return out << "<JSON string>";
+      case type_list:     return out << "<JSON list>";
+      case type_map:      return out << "<JSON map>";
+      case type_null:     return out << "<JSON null>";
+      case type_boolean:  return out << "<JSON boolean>";
+      case type_integer:  return out << "<JSON integer>";
+      case type_unsigned: return out << "<JSON unsigned>";
+      case type_double:   return out << "<JSON double>";
       }
     return out;
   }
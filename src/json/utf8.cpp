@@ -0,0 +1,351 @@
+/*
+ * Copyright 2012 Achille Roussel.
+ *
+ * This file is part of Libjson++.
+ *
+ * Libjson++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Libjson++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstring>
+#include "json/error.h"
+#include "json/simd.h"
+#include "json/utf8.h"
+
+namespace json
+{
+
+  [[noreturn]]
+  void error_invalid_utf8()
+  {
+    throw error("json::validate_utf8: invalid UTF-8 input");
+  }
+
+  namespace
+  {
+
+    // Returns a pointer past the UTF-8 sequence starting at 'first', or null
+    // if the sequence is malformed (see table 3-7 of the Unicode standard).
+    const unsigned char *utf8_next(const unsigned char *first, const unsigned char *last)
+    {
+      const unsigned char c = *first;
+      unsigned char lower = 0x80;
+      unsigned char upper = 0xBF;
+      std::ptrdiff_t n;
+
+      if (c < 0x80)
+	{
+	  return first + 1;
+	}
+      if (c < 0xC2)
+	{
+	  return 0;
+	}
+      if (c < 0xE0)
+	{
+	  n = 2;
+	}
+      else if (c < 0xF0)
+	{
+	  n = 3;
+	  lower = (c == 0xE0) ? 0xA0 : lower;
+	  upper = (c == 0xED) ? 0x9F : upper;
+	}
+      else if (c < 0xF5)
+	{
+	  n = 4;
+	  lower = (c == 0xF0) ? 0x90 : lower;
+	  upper = (c == 0xF4) ? 0x8F : upper;
+	}
+      else
+	{
+	  return 0;
+	}
+
+      if (((last - first) < n) || (first[1] < lower) || (first[1] > upper))
+	{
+	  return 0;
+	}
+      for (std::ptrdiff_t i = 2; i != n; ++i)
+	{
+	  if ((first[i] & 0xC0) != 0x80)
+	    {
+	      return 0;
+	    }
+	}
+      return first + n;
+    }
+
+    typedef bool (*validate_function)(const unsigned char *, const unsigned char *);
+
+#if !JSON_SIMD_SSE2
+    bool validate_scalar(const unsigned char *first, const unsigned char *last)
+    {
+      while (first != last)
+	{
+	  if (!(first = utf8_next(first, last)))
+	    {
+	      return false;
+	    }
+	}
+      return true;
+    }
+#endif
+
+#if JSON_SIMD_SSE2
+    bool validate_sse2(const unsigned char *first, const unsigned char *last)
+    {
+      while (first != last)
+	{
+	  if ((last - first) >= 16)
+	    {
+	      const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i *>(first));
+	      if (_mm_movemask_epi8(c) == 0)
+		{
+		  first += 16;
+		  continue;
+		}
+	    }
+
+	  // Sequences are decoded up to the end of the block, the next one may
+	  // start a few bytes past it.
+	  const unsigned char *end = first + (((last - first) < 16) ? (last - first) : 16);
+	  while (first < end)
+	    {
+	      if (!(first = utf8_next(first, last)))
+		{
+		  return false;
+		}
+	    }
+	}
+      return true;
+    }
+#endif
+
+#if JSON_SIMD_AVX2
+    // Errors which can be detected by looking at two consecutive bytes, a
+    // pair of bytes is invalid if the flags found for the high and low
+    // nibbles of the first byte and the high nibble of the second byte have
+    // one in common.
+    enum
+      {
+	utf8_too_short		= 1 << 0, // lead not followed by a continuation
+	utf8_too_long		= 1 << 1, // ASCII followed by a continuation
+	utf8_overlong_3		= 1 << 2, // 11100000 100_____
+	utf8_too_large		= 1 << 3, // above U+10FFFF
+	utf8_surrogate		= 1 << 4, // 11101101 101_____
+	utf8_overlong_2		= 1 << 5, // 1100000_ 10______
+	utf8_too_large_1000	= 1 << 6, // 11110101 1000____ and above
+	utf8_overlong_4		= 1 << 6, // 11110000 1000____
+	utf8_two_conts		= 1 << 7, // two continuations in a row
+	utf8_carry		= utf8_too_short | utf8_too_long | utf8_two_conts
+      };
+
+    const unsigned char utf8_byte_1_high[16] =
+      {
+	// 0_______
+	utf8_too_long, utf8_too_long, utf8_too_long, utf8_too_long,
+	utf8_too_long, utf8_too_long, utf8_too_long, utf8_too_long,
+	// 10______
+	utf8_two_conts, utf8_two_conts, utf8_two_conts, utf8_two_conts,
+	// 1100____
+	utf8_too_short | utf8_overlong_2,
+	// 1101____
+	utf8_too_short,
+	// 1110____
+	utf8_too_short | utf8_overlong_3 | utf8_surrogate,
+	// 1111____
+	utf8_too_short | utf8_too_large | utf8_too_large_1000 | utf8_overlong_4,
+      };
+
+    const unsigned char utf8_byte_1_low[16] =
+      {
+	// ____0000
+	utf8_carry | utf8_overlong_3 | utf8_overlong_2 | utf8_overlong_4,
+	// ____0001
+	utf8_carry | utf8_overlong_2,
+	// ____001_
+	utf8_carry,
+	utf8_carry,
+	// ____0100
+	utf8_carry | utf8_too_large,
+	// ____0101 to ____1100
+	utf8_carry | utf8_too_large | utf8_too_large_1000,
+	utf8_carry | utf8_too_large | utf8_too_large_1000,
+	utf8_carry | utf8_too_large | utf8_too_large_1000,
+	utf8_carry | utf8_too_large | utf8_too_large_1000,
+	utf8_carry | utf8_too_large | utf8_too_large_1000,
+	utf8_carry | utf8_too_large | utf8_too_large_1000,
+	utf8_carry | utf8_too_large | utf8_too_large_1000,
+	utf8_carry | utf8_too_large | utf8_too_large_1000,
+	// ____1101
+	utf8_carry | utf8_too_large | utf8_too_large_1000 | utf8_surrogate,
+	// ____111_
+	utf8_carry | utf8_too_large | utf8_too_large_1000,
+	utf8_carry | utf8_too_large | utf8_too_large_1000,
+      };
+
+    const unsigned char utf8_byte_2_high[16] =
+      {
+	// 0_______
+	utf8_too_short, utf8_too_short, utf8_too_short, utf8_too_short,
+	utf8_too_short, utf8_too_short, utf8_too_short, utf8_too_short,
+	// 1000____
+	utf8_too_long | utf8_overlong_2 | utf8_two_conts | utf8_overlong_3 | utf8_too_large_1000 | utf8_overlong_4,
+	// 1001____
+	utf8_too_long | utf8_overlong_2 | utf8_two_conts | utf8_overlong_3 | utf8_too_large,
+	// 101_____
+	utf8_too_long | utf8_overlong_2 | utf8_two_conts | utf8_surrogate | utf8_too_large,
+	utf8_too_long | utf8_overlong_2 | utf8_two_conts | utf8_surrogate | utf8_too_large,
+	// 11______
+	utf8_too_short, utf8_too_short, utf8_too_short, utf8_too_short,
+      };
+
+    // The largest values the bytes of a block can have without starting a
+    // sequence which continues in the next block.
+    const unsigned char utf8_max_value[32] =
+      {
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xEF, 0xDF, 0xBF,
+      };
+
+    JSON_TARGET_AVX2
+    inline __m256i avx2_lookup(const unsigned char *table, const __m256i index)
+    {
+      const __m128i t = _mm_loadu_si128(reinterpret_cast<const __m128i *>(table));
+      return _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(t), index);
+    }
+
+    // Returns the bytes of 'input' shifted by N, the first N bytes being the
+    // last ones of 'prev'.
+    template < int N >
+    JSON_TARGET_AVX2
+    inline __m256i avx2_prev(const __m256i input, const __m256i prev)
+    {
+      return _mm256_alignr_epi8(input, _mm256_permute2x128_si256(prev, input, 0x21), 16 - N);
+    }
+
+    // Returns a vector which is non-zero if the bytes of 'input' aren't valid
+    // UTF-8 when following the bytes of 'prev'.
+    JSON_TARGET_AVX2
+    inline __m256i utf8_errors_avx2(const __m256i input, const __m256i prev)
+    {
+      const __m256i nibble = _mm256_set1_epi8(0x0F);
+      const __m256i prev1  = avx2_prev<1>(input, prev);
+      const __m256i prev2  = avx2_prev<2>(input, prev);
+      const __m256i prev3  = avx2_prev<3>(input, prev);
+
+      const __m256i byte_1_high = avx2_lookup(utf8_byte_1_high, _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble));
+      const __m256i byte_1_low  = avx2_lookup(utf8_byte_1_low,  _mm256_and_si256(prev1, nibble));
+      const __m256i byte_2_high = avx2_lookup(utf8_byte_2_high, _mm256_and_si256(_mm256_srli_epi16(input, 4), nibble));
+      const __m256i special     = _mm256_and_si256(_mm256_and_si256(byte_1_high, byte_1_low), byte_2_high);
+
+      // Two continuations in a row are only valid as the third or fourth byte
+      // of a sequence, these are the bytes following a 3 or 4 bytes lead by
+      // two or three positions.
+      const __m256i third  = _mm256_subs_epu8(prev2, _mm256_set1_epi8(0xE0 - 0x80));
+      const __m256i fourth = _mm256_subs_epu8(prev3, _mm256_set1_epi8(0xF0 - 0x80));
+      const __m256i must_continue = _mm256_and_si256(_mm256_or_si256(third, fourth),
+						     _mm256_set1_epi8(static_cast<char>(0x80)));
+      return _mm256_xor_si256(must_continue, special);
+    }
+
+    JSON_TARGET_AVX2
+    bool validate_avx2(const unsigned char *first, const unsigned char *last)
+    {
+      const __m256i zero = _mm256_setzero_si256();
+      const __m256i max_value = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(utf8_max_value));
+      __m256i errors = zero;
+      __m256i prev_input = zero;
+      __m256i prev_incomplete = zero;
+      unsigned char tail[64];
+
+      while (first != last)
+	{
+	  // The last block is padded with '\0' which terminates any sequence
+	  // left incomplete.
+	  const unsigned char *block = first;
+	  if ((last - first) < 64)
+	    {
+	      std::memset(tail, 0, sizeof(tail));
+	      std::memcpy(tail, first, last - first);
+	      block = tail;
+	      first = last;
+	    }
+	  else
+	    {
+	      first += 64;
+	    }
+
+	  const __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block));
+	  const __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block + 32));
+	  if (_mm256_movemask_epi8(_mm256_or_si256(lo, hi)) == 0)
+	    {
+	      errors = _mm256_or_si256(errors, prev_incomplete);
+	      prev_incomplete = zero;
+	    }
+	  else
+	    {
+	      errors = _mm256_or_si256(errors, utf8_errors_avx2(lo, prev_input));
+	      errors = _mm256_or_si256(errors, utf8_errors_avx2(hi, lo));
+	      prev_incomplete = _mm256_subs_epu8(hi, max_value);
+	    }
+	  prev_input = hi;
+	}
+
+      errors = _mm256_or_si256(errors, prev_incomplete);
+      return _mm256_testz_si256(errors, errors);
+    }
+#endif
+
+    validate_function select_validate_function()
+    {
+#if JSON_SIMD_AVX2
+      if (cpu_has_avx2())
+	{
+	  return validate_avx2;
+	}
+#endif
+#if JSON_SIMD_SSE2
+      return validate_sse2;
+#else
+      return validate_scalar;
+#endif
+    }
+
+    const validate_function validate_input = select_validate_function();
+
+  }
+
+  bool is_valid_utf8(const char *first, const char *last)
+  {
+    return validate_input(reinterpret_cast<const unsigned char *>(first),
+			  reinterpret_cast<const unsigned char *>(last));
+  }
+
+  void validate_utf8(const char *first, const char *last)
+  {
+    if (!is_valid_utf8(first, last))
+      {
+	error_invalid_utf8();
+      }
+  }
+
+  void validate_utf8(const std::string &str)
+  {
+    validate_utf8(str.data(), str.data() + str.size());
+  }
+
+}
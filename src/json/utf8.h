@@ -0,0 +1,67 @@
+/*
+ * Copyright 2012 Achille Roussel.
+ *
+ * This file is part of Libjson++.
+ *
+ * Libjson++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Libjson++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JSON_UTF8_H
+#define JSON_UTF8_H
+
+#include <string>
+#include "json/def.h"
+
+namespace json
+{
+
+  /**
+   * @brief Checks that a buffer is valid UTF-8.
+   *
+   * Overlong encodings, surrogates, code points above U+10FFFF and truncated
+   * sequences are rejected. On x86-64 CPUs supporting AVX2 the buffer is
+   * checked 64 bytes at a time with table lookups on the high and low
+   * nibbles of consecutive bytes, and runs of ASCII characters are skipped
+   * after a single test, which makes the check close to the speed of a copy.
+   * Other CPUs skip ASCII runs with SSE2 and decode the rest one sequence at
+   * a time.
+   *
+   * @param first A pointer to the first character of the buffer.
+   * @param last A pointer to the end of the buffer, no character past it is
+   * read.
+   *
+   * @return The function returns true if the buffer is valid UTF-8, false
+   * otherwise.
+   */
+  bool is_valid_utf8(const char *first, const char *last);
+
+  /**
+   * @brief Throws an exception if a buffer isn't valid UTF-8.
+   *
+   * This is <em>json::is_valid_utf8</em> for callers which check their input
+   * before passing it to <em>json::read</em>, since the readers copy the
+   * bytes of strings without checking their encoding.
+   *
+   * @param first A pointer to the first character of the buffer.
+   * @param last A pointer to the end of the buffer.
+   *
+   * @throw json::error The buffer isn't valid UTF-8.
+   */
+  void validate_utf8(const char *first, const char *last);
+
+  void validate_utf8(const std::string &str);
+
+}
+
+#endif // JSON_UTF8_H
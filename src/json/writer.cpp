@@ -17,6 +17,10 @@
  * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+#include <clocale>
+#include <cmath>
+#include <cstdio>
 #include <ostream>
 #include "json/writer.hpp"
 #include "json/object.hpp"
@@ -24,6 +28,88 @@
 namespace json
 {
 
+  namespace
+  {
+
+    std::size_t format_unsigned(unsigned long long x, const bool negative, char *buffer)
+    {
+      char digits[number_text_size];
+      char *it = digits + number_text_size;
+      do
+	{
+	  *(--it) = char('0' + (x % 10));
+	  x /= 10;
+	}
+      while (x != 0);
+      if (negative)
+	{
+	  *(--it) = '-';
+	}
+      return std::copy(it, digits + number_text_size, buffer) - buffer;
+    }
+
+    // snprintf writes the decimal point of the current locale.
+    std::size_t format_double(const double x, char *buffer)
+    {
+      char str[32];
+      int n = 0;
+      for (int precision = 15; precision <= 17; ++precision)
+	{
+	  n = std::snprintf(str, sizeof(str), "%.*g", precision, x);
+	  std::replace(str, str + n, *std::localeconv()->decimal_point, '.');
+
+	  double y;
+	  decimal_to_number(str, str + n, y, "json::format_number");
+	  if (y == x)
+	    {
+	      break;
+	    }
+	}
+      if (std::find_if(str, str + n, [](const char c) { return (c == '.') || (c == 'e'); }) == (str + n))
+	{
+	  str[n++] = '.';
+	  str[n++] = '0';
+	}
+      return std::copy(str, str + n, buffer) - buffer;
+    }
+
+  }
+
+  std::size_t format_number(const object_type type, const native_value &x, char (&buffer)[number_text_size])
+  {
+    switch (type)
+      {
+      case type_boolean:
+	if (x.boolean)
+	  {
+	    std::copy_n("true", 4, buffer);
+	    return 4;
+	  }
+	std::copy_n("false", 5, buffer);
+	return 5;
+
+      case type_integer:
+	return (x.integer < 0)
+	  ? format_unsigned(0 - static_cast<unsigned long long>(x.integer), true, buffer)
+	  : format_unsigned(x.integer, false, buffer);
+
+      case type_unsigned:
+	return format_unsigned(x.unsigned_integer, false, buffer);
+
+      case type_double:
+	if (std::isfinite(x.real))
+	  {
+	    return format_double(x.real, buffer);
+	  }
+	break;
+
+      default:
+	break;
+      }
+    std::copy_n("null", 4, buffer);
+    return 4;
+  }
+
   template void write_null(std::ostream &);
 
   template void write_pair(std::ostream &, const object::object_map::value_type &);
@@ -34,6 +120,10 @@ namespace json
 
   template void write_string(std::ostream &, const object::object_string &);
 
+  template void write_native(std::ostream &, const object &);
+
+  template void write_packed(std::ostream &, const object &);
+
   template void write_object(std::ostream &, const object &);
 
 }
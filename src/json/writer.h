@@ -21,11 +21,24 @@
 #define JSON_WRITER_H
 
 #include <iosfwd>
+#include <cstddef>
 #include "json/def.h"
+#include "json/types.h"
 
 namespace json
 {
 
+  /**
+   * @brief Writes the text of a boolean or number to 'buffer' and returns its
+   * size, the buffer isn't terminated by a '\0'.
+   * <br/>
+   * Doubles are written with the fewest significant digits which read back
+   * to the same value, a ".0" is added to those which would otherwise read
+   * as integers. There are no infinite or NaN values in JSON, they are
+   * written as 'null'.
+   */
+  std::size_t format_number(object_type type, const native_value &x, char (&buffer)[number_text_size]);
+
   template < typename Char, typename Traits, typename Allocator >
   void write_object(std::basic_ostream<Char, Traits> &out,
 		    const basic_object<Char, Traits, Allocator> &obj);
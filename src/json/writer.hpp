@@ -35,38 +35,73 @@ namespace json
     out << "null";
   }
 
+  // Strings are always quoted, numbers and booleans have their own types
+  // and "01234" or "true" must be read back as strings.
   template < typename String, typename Char, typename Traits >
   void write_string(std::basic_ostream<Char, Traits> &out, const String &s)
   {
-    if (is_json_boolean(s) || is_json_number(s))
+    out << '"';
+
+    auto it = s.begin();
+    auto jt = s.end();
+
+    while (it != jt)
       {
-	out << s;
+	switch (*it)
+	  {
+	  case '"':  out << '\\' << '\"'; break;
+	  case '\\': out << '\\' << '\\'; break;
+	  case '\b': out << '\\' << 'b';  break;
+	  case '\f': out << '\\' << 'f';  break;
+	  case '\n': out << '\\' << 'n';  break;
+	  case '\r': out << '\\' << 'r';  break;
+	  case '\t': out << '\\' << 't';  break;
+	  default: out << *it;            break;
+	  }
+	++it;
       }
-    else
-      {
-	out << '"';
 
-	auto it = s.begin();
-	auto jt = s.end();
+    out << '"';
+  }
+
+  template < typename Char, typename Traits, typename Allocator >
+  void write_native(std::basic_ostream<Char, Traits> &out,
+		    const basic_object<Char, Traits, Allocator> &obj)
+  {
+    out << obj.get_char_sequence();
+  }
+
+  // The numbers of a packed list are written from their values, their texts
+  // weren't kept.
+  template < typename Char, typename Traits, typename Allocator >
+  void write_packed(std::basic_ostream<Char, Traits> &out,
+		    const basic_object<Char, Traits, Allocator> &obj)
+  {
+    const object_type type = obj.packed_type();
+    const long long *integers = (type == type_integer) ? obj.get_integers().data() : nullptr;
+    const double *doubles = (type == type_double) ? obj.get_doubles().data() : nullptr;
+    const std::size_t n = obj.size();
+    char buffer[number_text_size];
+    native_value x;
 
-	while (it != jt)
+    out << '[';
+    for (std::size_t i = 0; i != n; ++i)
+      {
+	if (i != 0)
+	  {
+	    out << ',';
+	  }
+	if (integers)
+	  {
+	    x.integer = integers[i];
+	  }
+	else
 	  {
-	    switch (*it)
-	      {
-	      case '"':  out << '\\' << '\"'; break;
-	      case '\\': out << '\\' << '\\'; break;
-	      case '\b': out << '\\' << 'b';  break; 
-	      case '\f': out << '\\' << 'f';  break; 
-	      case '\n': out << '\\' << 'n';  break;
-	      case '\r': out << '\\' << 'r';  break;
-	      case '\t': out << '\\' << 't';  break;
-	      default: out << *it;            break;
-	      }
-	    ++it;
+	    x.real = doubles[i];
 	  }
-	      
-	out << '"';
+	out.write(buffer, format_number(type, x, buffer));
       }
+    out << ']';
   }
 
   template < typename List, typename Char, typename Traits >
@@ -125,23 +160,35 @@ namespace json
   void write_object(std::basic_ostream<Char, Traits> &out,
 		    const basic_object<Char, Traits, Allocator> &obj)
   {
-    typedef basic_char_sequence<Char, Traits> char_sequence;
-
     switch (obj.type())
       {
 
       case type_string:
-	write_string(out, char_sequence(obj.get_string()));
+	write_string(out, obj.get_char_sequence());
 	break;
 
       case type_list:
-	write_list(out, obj.get_list());
+	if (obj.is_packed())
+	  {
+	    write_packed(out, obj);
+	  }
+	else
+	  {
+	    write_list(out, obj.get_list());
+	  }
 	break;
 
       case type_map:
 	write_map(out, obj.get_map());
 	break;
 
+      case type_boolean:
+      case type_integer:
+      case type_unsigned:
+      case type_double:
+	write_native(out, obj);
+	break;
+
       case type_null:
 	write_null(out);
 	break;
@@ -0,0 +1,128 @@
+/*
+ * Copyright 2012 Achille Roussel.
+ *
+ * This file is part of Libjson++.
+ *
+ * Libjson++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Libjson++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <sstream>
+#include <unit/main>
+#include <json/monotonic_document.h>
+
+// Counts the allocations made on the global heap.
+static std::size_t heap_allocations = 0;
+
+void *operator new(std::size_t size)
+{
+  ++heap_allocations;
+  if (void *p = std::malloc(size ? size : 1))
+    {
+      return p;
+    }
+  throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept
+{
+  std::free(p);
+}
+
+TEST(arena, allocate)
+{
+  json::arena a (256);
+
+  for (std::size_t alignment : { 1, 2, 4, 8, 16, 64 })
+    {
+      void *p = a.allocate(3, alignment);
+      assert_equal(reinterpret_cast<std::uintptr_t>(p) % alignment, 0);
+    }
+
+  // Requests larger than a chunk get their own chunk.
+  char *large = static_cast<char *>(a.allocate(10000, 8));
+  large[9999] = 'x';
+  assert_true(a.capacity() >= 10256);
+
+  // Huge page sized chunks.
+  char *huge = static_cast<char *>(a.allocate(5 << 20, 8));
+  huge[(5 << 20) - 1] = 'x';
+  assert_true(a.capacity() >= (5 << 20));
+
+  // The chunks are merged and reused after a reset.
+  const std::size_t capacity = a.capacity();
+  a.reset();
+  assert_true(a.capacity() >= capacity);
+  const std::size_t merged = a.capacity();
+  a.allocate(capacity - 1024, 8);
+  assert_equal(a.capacity(), merged);
+
+  a.release();
+  assert_equal(a.capacity(), 0);
+  assert_true(a.allocate(8, 8) != nullptr);
+}
+
+TEST(arena, monotonic_document)
+{
+  std::string str ("{\"list\": [1, -2.5e3, true, null], \"map\": {\"k\": \"v\"}, \"s\": \"Hello\\tWorld, a rather long string\"}");
+
+  const std::size_t before = heap_allocations;
+  json::monotonic_document doc (str);
+  assert_equal(heap_allocations, before);
+
+  const json::monotonic_object &obj = doc.root();
+  assert_equal(obj.size(), 3);
+  assert_equal(obj["list"].size(), 4);
+  assert_equal(json::stod(obj["list"][1]), -2500);
+  assert_true(json::is_true(obj["list"][2]));
+  assert_true(json::is_null(obj["list"][3]));
+  assert_equal(obj["map"]["k"], "v");
+  assert_equal(obj["s"], "Hello\tWorld, a rather long string");
+  assert_true(obj == json::read(str));
+  assert_true(doc.get_allocator().get_arena()->capacity() != 0);
+
+  std::ostringstream s;
+  s << obj["list"];
+  assert_equal(s.str(), "[1,-2.5e3,true,null]");
+}
+
+TEST(arena, assign)
+{
+  json::monotonic_document doc ("{}");
+  json::monotonic_document other ("{\"a\": [\"x\", {\"b\": \"y\"}]}");
+  const json::object obj (json::read("[\"Hello\", {\"World\": \"!\"}]"));
+
+  // Values from the heap or from another arena are copied in the document.
+  doc.root()["obj"] = obj;
+  doc.root()["other"] = std::move(other.root()["a"]);
+  other.clear();
+
+  assert_true(doc.root()["obj"] == obj);
+  assert_true(doc.root()["obj"][1].get_allocator() == doc.get_allocator());
+  assert_equal(doc.root()["other"][1]["b"], "y");
+  assert_true(doc.root()["other"][1]["b"].get_allocator() == doc.get_allocator());
+
+  // Values built with the allocator of the document are moved in.
+  json::monotonic_object list (doc.get_allocator());
+  list.make_list();
+  list.get_list().emplace_back(42, doc.get_allocator());
+  doc.root()["list"] = std::move(list);
+  assert_equal(doc.root()["list"][0], json::object(42));
+
+  doc.clear();
+  assert_true(json::is_null(doc.root()));
+  assert_true(doc.get_allocator().get_arena()->capacity() != 0);
+}
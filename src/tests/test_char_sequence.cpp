@@ -106,3 +106,16 @@ TEST(char_sequence, ostream)
   assert_equal(str1, str2);
 }
 
+
+TEST(char_sequence, substring)
+{
+  const char *str = "HelloHello World";
+  json::char_sequence s1 (str, 5);
+  json::char_sequence s2 (str + 5, 5);
+  json::char_sequence s3 (str + 5, 6);
+
+  assert_equal(s1.compare(s2), 0);
+  assert_true(s1 == s2);
+  assert_lesser(s1.compare(s3), 0);
+  assert_greater(s3.compare(s1), 0);
+}
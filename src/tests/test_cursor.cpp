@@ -0,0 +1,153 @@
+/*
+ * Copyright 2012 Achille Roussel.
+ *
+ * This file is part of Libjson++.
+ *
+ * Libjson++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Libjson++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <sstream>
+#include <string>
+#include <unit/main>
+#include <json/cursor>
+#include <json/error.h>
+
+static const char *document =
+  "[ {\"id\": 1, \"name\": \"Hello\", \"tags\": [\"a\", {\"b\": []}]},\n"
+  "  {\"name\": \"Wor\\\"ld\", \"id\": 2.5e1, \"ok\": true},\n"
+  "  null, false, \"end\" ]";
+
+// Collects the 'id' and 'name' fields of the top level maps and skips the rest.
+template < typename Cursor >
+static std::string walk(Cursor &c)
+{
+  std::ostringstream out;
+
+  assert_true(c.next());
+  assert_equal(c.type(), json::token_list);
+  c.enter();
+  while (c.next())
+    {
+      if (c.type() != json::token_map)
+	{
+	  out << '.';
+	  continue;
+	}
+      c.enter();
+      assert_equal(c.depth(), 2);
+      while (c.next())
+	{
+	  if (c.key() == "id")
+	    {
+	      out << c.get_number() << ' ';
+	    }
+	  else if (c.key() == "name")
+	    {
+	      const json::char_sequence name = c.get_string();
+	      out << std::string(name.data(), name.size()) << ' ';
+	    }
+	}
+      c.leave();
+    }
+  c.leave();
+  assert_equal(c.depth(), 0);
+  assert_true(!c.next());
+  return out.str();
+}
+
+TEST(cursor, buffer)
+{
+  json::cursor c (document);
+
+  assert_equal(walk(c), "1 Hello Wor\"ld 25 ...");
+}
+
+TEST(cursor, stream)
+{
+  std::stringstream s (document);
+  json::stream_cursor c (s);
+
+  assert_equal(walk(c), "1 Hello Wor\"ld 25 ...");
+}
+
+TEST(cursor, scalars)
+{
+  json::cursor c ("true 42 \"Hello\" null");
+
+  assert_true(c.next());
+  assert_true(c.get_bool());
+  assert_true(c.next());
+  assert_equal(c.get_number(), 42);
+  assert_true(c.next());
+  assert_true(c.get_string() == "Hello");
+  assert_true(c.next());
+  assert_equal(c.type(), json::token_null);
+  assert_true(!c.next());
+  assert_equal(c.type(), json::token_end);
+}
+
+TEST(cursor, leave)
+{
+  std::stringstream s ("[[1, [2, 3]], 4] [5]");
+  json::stream_cursor c (s);
+
+  c.next();
+  c.enter();
+  c.next();
+  c.enter();
+  c.leave();
+  assert_true(c.next());
+  assert_equal(c.get_number(), 4);
+  c.leave();
+  assert_equal(s.get(), ' ');
+}
+
+TEST(cursor, error)
+{
+  const char *inputs[] = { "[1, 2", "[1, 2,]", "[1 2]", "{\"a\" 1}", "{1: 2}", "[tru]", "[x]" };
+
+  for (auto input : inputs)
+    {
+      bool thrown = false;
+      try
+	{
+	  json::cursor c (input);
+	  c.next();
+	  c.enter();
+	  c.leave();
+	}
+      catch (const json::error &)
+	{
+	  thrown = true;
+	}
+      assert_true(thrown);
+    }
+}
+
+TEST(cursor, type_mismatch)
+{
+  json::cursor c ("[\"Hello\"]");
+  bool thrown = false;
+
+  c.next();
+  try
+    {
+      c.get_string();
+    }
+  catch (const json::error &)
+    {
+      thrown = true;
+    }
+  assert_true(thrown);
+}
@@ -0,0 +1,258 @@
+/*
+ * Copyright 2012 Achille Roussel.
+ *
+ * This file is part of Libjson++.
+ *
+ * Libjson++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Libjson++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unit/main>
+#include <json/object.h>
+#include <json/deduplicator.h>
+
+static std::string records(int n)
+{
+  std::string str ("[");
+  for (int i = 0; i != n; ++i)
+    {
+      str += "{\"id\": " + std::to_string(i) + ", \"geo\": {\"lat\": 1.5, \"tags\": [\"a\", \"b\"]}, "
+	"\"values\": [1, 2, 3]}, ";
+    }
+  return str + "{}]";
+}
+
+static std::string to_string(const json::object &obj)
+{
+  std::ostringstream s;
+  s << obj;
+  return s.str();
+}
+
+static const void *body_of(const json::object &obj)
+{
+  if (json::is_map(obj))
+    {
+      return &obj.get_map();
+    }
+  if (obj.is_packed())
+    {
+      return (obj.packed_type() == json::type_integer)
+	? static_cast<const void *>(obj.get_integers().data())
+	: static_cast<const void *>(obj.get_doubles().data());
+    }
+  return &obj.get_list();
+}
+
+TEST(deduplicator, share)
+{
+  json::object a (json::read("[1, \"Hello\", {\"x\": null}]"));
+  json::object b;
+
+  b.share(a);
+  assert_true(a.is_shared());
+  assert_true(b.is_shared());
+  assert_equal(body_of(a), body_of(b));
+  assert_equal(b.size(), 3);
+  assert_equal(static_cast<const json::object &>(b)[1], "Hello");
+  assert_true(a == b);
+
+  const json::object c (b);
+  assert_true(c.is_shared());
+  assert_equal(body_of(a), body_of(c));
+  assert_equal(to_string(c), "[1,\"Hello\",{\"x\":null}]");
+
+  // Modifying an object gives it its own copy of the body.
+  b[0] = 2;
+  assert_false(b.is_shared());
+  assert_not_equal(body_of(a), body_of(b));
+  assert_equal(a[0], json::object(1));
+  assert_equal(c[0], json::object(1));
+  assert_equal(b[0], json::object(2));
+
+  json::object d (json::read("42"));
+  d.share(a);
+  assert_true(d == a);
+  d.share(d[2]);
+  assert_equal(d.size(), 1);
+  assert_true(json::is_null(d["x"]));
+  d = "Hello";
+  assert_false(d.is_shared());
+  assert_equal(d, "Hello");
+}
+
+TEST(deduplicator, deduplicate)
+{
+  const std::string str (records(100));
+  json::object obj (json::read(str));
+  json::deduplicate(obj);
+
+  const json::object &records = obj;
+  assert_false(records.is_shared());
+  assert_false(records[0].is_shared());
+  assert_true(records[0]["geo"].is_shared());
+  assert_equal(body_of(records[0]["geo"]), body_of(records[99]["geo"]));
+  assert_equal(body_of(records[0]["geo"]["tags"]), body_of(records[99]["geo"]["tags"]));
+  assert_equal(body_of(records[0]["values"]), body_of(records[99]["values"]));
+  assert_equal(records[42]["values"][2], json::object(3));
+  assert_equal(records[42]["values"].get_list().size(), 3);
+  assert_false(records[100].is_shared());
+  assert_true(obj == json::read(str));
+  assert_equal(to_string(obj), to_string(json::read(str)));
+
+  // Members of shared maps are copied with them.
+  obj[0]["geo"]["lat"] = 3;
+  assert_equal(records[0]["geo"]["lat"], json::object(3));
+  assert_equal(records[1]["geo"]["lat"], json::object(1.5));
+  assert_equal(body_of(records[0]["geo"]["tags"]), body_of(records[1]["geo"]["tags"]));
+  assert_not_equal(body_of(records[0]["geo"]), body_of(records[1]["geo"]));
+}
+
+TEST(deduplicator, identical)
+{
+  json::object obj (json::read("[[1], [1.0], [\"1\"], [1], {\"a\": 1, \"b\": [true]}, {\"b\": [true], \"a\": 1}, "
+			       "[-0.0], [0.0], [[]], [[]]]"));
+  json::deduplicate(obj);
+
+  const json::object &x = obj;
+  assert_equal(body_of(x[0]), body_of(x[3]));
+  assert_not_equal(body_of(x[0]), body_of(x[1]));
+  assert_not_equal(body_of(x[0]), body_of(x[2]));
+  assert_equal(body_of(x[4]), body_of(x[5]));
+  assert_not_equal(body_of(x[6]), body_of(x[7]));
+  assert_equal(body_of(x[8]), body_of(x[9]));
+  assert_false(x[8][0].is_shared());
+  assert_equal(to_string(obj), "[[1],[1.0],[\"1\"],[1],{\"a\":1,\"b\":[true]},{\"a\":1,\"b\":[true]},"
+	       "[-0.0],[0.0],[[]],[[]]]");
+}
+
+TEST(deduplicator, read)
+{
+  json::deduplicator trees;
+  json::object obj1 (json::read(records(100), trees));
+  json::object obj2 (json::read(records(10), trees));
+
+  const json::object &x1 = obj1;
+  const json::object &x2 = obj2;
+  assert_equal(body_of(x1[0]["geo"]), body_of(x1[99]["geo"]));
+  assert_equal(body_of(x1[0]["geo"]), body_of(x2[9]["geo"]));
+  assert_equal(body_of(x1[5]), body_of(x2[5]));
+  assert_not_equal(body_of(x1), body_of(x2));
+  assert_true(obj1 == json::read(records(100)));
+
+  // 100 records, their geo, tags and values, and the two lists of records.
+  assert_equal(trees.size(), 105);
+  trees.purge();
+  assert_equal(trees.size(), 105);
+  obj1.make_null();
+  trees.purge();
+  assert_equal(trees.size(), 14);
+  assert_true(json::is_list(x2[0]["geo"]["tags"]));
+  obj2.make_null();
+  trees.purge();
+  assert_true(trees.empty());
+}
+
+TEST(deduplicator, lifetime)
+{
+  json::object obj;
+  {
+    json::deduplicator trees;
+    obj = json::read(records(10), trees);
+  }
+  assert_equal(obj.size(), 11);
+  assert_equal(obj[9]["geo"]["tags"][1], "b");
+  assert_equal(obj[9]["id"].get_integer(), 9);
+  obj[9]["id"] = 0;
+  assert_true(obj[0] == obj[9]);
+}
+
+TEST(deduplicator, threads)
+{
+  json::object obj (json::read(records(100)));
+  json::deduplicate(obj);
+
+  const json::object &records = obj;
+  std::vector<std::thread> threads;
+  std::vector<int> results (4);
+  for (int t = 0; t != 4; ++t)
+    {
+      threads.emplace_back([&, t]()
+			   {
+			     for (int i = 0; i != 100; ++i)
+			       {
+				 json::object copy (records[i]);
+				 copy["geo"]["tags"][0] = t;
+				 results[t] += copy["geo"]["tags"][0].get_integer()
+				   + static_cast<int>(records[i]["geo"]["tags"].size());
+			       }
+			   });
+    }
+  for (auto &x : threads)
+    {
+      x.join();
+    }
+
+  for (int t = 0; t != 4; ++t)
+    {
+      assert_equal(results[t], 100 * (t + 2));
+    }
+  assert_equal(records[0]["geo"]["tags"][0], "a");
+  assert_equal(body_of(records[0]["geo"]), body_of(records[99]["geo"]));
+}
+
+// Shared bodies are only read through const objects, so they can be read by
+// several threads at once: packed lists are iterated without being unpacked
+// and the text of numbers is read in place.
+TEST(deduplicator, shared_reads)
+{
+  const json::packing_scope packing;
+  json::object obj (json::read(records(100)));
+  json::deduplicate(obj);
+
+  const json::object &records = obj;
+  std::vector<std::thread> threads;
+  std::vector<std::string> results (4);
+  for (int t = 0; t != 4; ++t)
+    {
+      threads.emplace_back([&, t]()
+			   {
+			     for (int i = 0; i != 100; ++i)
+			       {
+				 const json::object &values = records[i]["values"];
+				 for (const json::object &x : values)
+				   {
+				     const json::char_sequence s = x.get_char_sequence();
+				     results[t].append(s.data(), s.size());
+				   }
+				 results[t] += to_string(records[i]["geo"]);
+			       }
+			   });
+    }
+  for (auto &x : threads)
+    {
+      x.join();
+    }
+
+  for (int t = 0; t != 4; ++t)
+    {
+      assert_equal(results[t], results[0]);
+    }
+  assert_true(records[0]["values"].is_packed());
+  assert_equal(body_of(records[0]["values"]), body_of(records[99]["values"]));
+  assert_equal(to_string(records[0]["values"]), "[1,2,3]");
+}
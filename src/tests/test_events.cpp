@@ -0,0 +1,141 @@
+/*
+ * Copyright 2012 Achille Roussel.
+ *
+ * This file is part of Libjson++.
+ *
+ * Libjson++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Libjson++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <unit/main>
+#include <json/events>
+#include <json/error.h>
+
+// Rebuilds a compact JSON representation of the parsed input.
+struct printer : json::event_handler
+{
+  std::string out;
+  bool        comma = false;
+
+  void value(const std::string &str)
+  {
+    if (comma)
+      {
+	out += ',';
+      }
+    out += str;
+    comma = true;
+  }
+
+  bool on_null()                                 { value("null"); return true; }
+  bool on_bool(bool b)                           { value(b ? "true" : "false"); return true; }
+  bool on_number(const json::char_sequence &s)   { value(std::string(s.data(), s.size())); return true; }
+  bool on_string(const json::char_sequence &s)   { value("\"" + std::string(s.data(), s.size()) + "\""); return true; }
+  bool on_key(const json::char_sequence &s)      { value("\"" + std::string(s.data(), s.size()) + "\":"); comma = false; return true; }
+  bool on_start_map()                            { value("{"); comma = false; return true; }
+  bool on_end_map()                              { out += '}'; comma = true; return true; }
+  bool on_start_list()                           { value("["); comma = false; return true; }
+  bool on_end_list()                             { out += ']'; comma = true; return true; }
+};
+
+// Stops the parsing at the first string with the given value.
+struct finder : json::event_handler
+{
+  const char *target;
+  int         count = 0;
+
+  explicit finder(const char *str): target(str) { }
+
+  bool on_string(const json::char_sequence &s)
+  {
+    ++count;
+    return s != json::char_sequence(target, std::strlen(target));
+  }
+};
+
+static const char *document =
+  "{ \"list\": [1, -2.5e3, true, false, null],\n"
+  "  \"map\": { \"a\\\"b\": \"Hello  World\\n\", \"c\": {} },\n"
+  "  \"empty\": [] }";
+
+static const char *expected =
+  "{\"list\":[1,-2.5e3,true,false,null],"
+  "\"map\":{\"a\"b\":\"Hello  World\n\",\"c\":{}},"
+  "\"empty\":[]}";
+
+TEST(events, buffer)
+{
+  printer p;
+
+  assert_true(json::parse_events(document, p));
+  assert_equal(p.out, expected);
+}
+
+TEST(events, string)
+{
+  printer p;
+
+  assert_true(json::parse_events(std::string(document), p));
+  assert_equal(p.out, expected);
+}
+
+TEST(events, stream)
+{
+  std::stringstream s (std::string(document) + " 42");
+  printer p;
+
+  assert_true(json::parse_events(s, p));
+  assert_equal(p.out, expected);
+  assert_equal(s.get(), ' ');
+}
+
+TEST(events, stop)
+{
+  finder f ("b");
+
+  assert_true(!json::parse_events("[\"a\", \"b\", \"c\"]", f));
+  assert_equal(f.count, 2);
+}
+
+TEST(events, error)
+{
+  const char *inputs[] = { "", "[1, 2", "{\"a\" 1}", "\"Hello", "[1, 2,]", "[1 2]", "{1: 2}", "tru", "-" };
+
+  for (auto input : inputs)
+    {
+      std::stringstream s (input);
+      bool thrown_buffer = false;
+      bool thrown_stream = false;
+      try
+	{
+	  json::parse_events(input, json::event_handler());
+	}
+      catch (const json::error &)
+	{
+	  thrown_buffer = true;
+	}
+      try
+	{
+	  json::parse_events(s, json::event_handler());
+	}
+      catch (const json::error &)
+	{
+	  thrown_stream = true;
+	}
+      assert_true(thrown_buffer);
+      assert_true(thrown_stream);
+    }
+}
@@ -0,0 +1,135 @@
+/*
+ * Copyright 2012 Achille Roussel.
+ *
+ * This file is part of Libjson++.
+ *
+ * Libjson++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Libjson++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string>
+#include <unit/main>
+#include <json/object.h>
+#include <json/hash_map.hpp>
+#include <json/error.h>
+
+static bool points_into(const json::object &obj, const std::string &str)
+{
+  const char *s = obj.get_char_sequence().data();
+  return (s >= str.data()) && (s < (str.data() + str.size()));
+}
+
+TEST(insitu, values)
+{
+  std::string str ("{\"list\": [1, -2.5e3, true, false, null], \"map\": {}, \"s\": \"Hello\"}");
+  json::object obj (json::read_insitu(str));
+
+  assert_equal(obj.size(), 3);
+  assert_equal(obj["list"].size(), 5);
+  assert_equal(obj["list"][0], json::object(1));
+  assert_equal(obj["list"][1], json::object(-2.5e3));
+  assert_true(json::is_true(obj["list"][2]));
+  assert_true(json::is_false(obj["list"][3]));
+  assert_true(json::is_null(obj["list"][4]));
+  assert_true(json::is_map(obj["map"]));
+  assert_equal(obj["s"], "Hello");
+  assert_true(obj["s"].is_borrowed());
+  assert_true(points_into(obj["s"], str));
+  assert_equal(obj["list"][1].type(), json::type_double);
+}
+
+TEST(insitu, escape)
+{
+  std::string str ("[\"Hello\\tWorld\", \"\\u00e9\\\"x\\\\\", \"a\\/b\", \"\\ud83d\\ude00!\"]");
+  json::object obj (json::read_insitu(str));
+
+  assert_equal(obj[0], "Hello\tWorld");
+  assert_equal(obj[1], "\xc3\xa9\"x\\");
+  assert_equal(obj[2], "a/b");
+  assert_equal(obj[3], "\xf0\x9f\x98\x80!");
+  assert_true(points_into(obj[0], str));
+  assert_true(points_into(obj[1], str));
+}
+
+TEST(insitu, keys)
+{
+  std::string str ("{\"a\\\"b\": 1, \"x\": 1, \"x\": 2}");
+  json::object obj (json::read_insitu(str));
+
+  assert_equal(obj.size(), 2);
+  assert_equal(obj["a\"b"], json::object(1));
+  assert_equal(obj["x"], json::object(2));
+
+  auto &map = obj.get_map();
+  for (auto it = map.begin(); it != map.end(); ++it)
+    {
+      assert_true(it->first.borrowed());
+      assert_true((it->first.data() >= str.data()) && (it->first.data() < (str.data() + str.size())));
+    }
+}
+
+TEST(insitu, ownership)
+{
+  json::object copy;
+  json::object owned;
+  {
+    std::string str ("{\"key\": [\"value\", 42, \"x\"]}");
+    json::object obj (json::read_insitu(str));
+
+    copy = obj;
+    owned = obj["key"][0];
+    const json::object &value = obj["key"][0];
+    bool thrown = false;
+    try
+      {
+	value.get_string();
+      }
+    catch (const json::error &)
+      {
+	thrown = true;
+      }
+    assert_true(thrown);
+    assert_true(value.is_borrowed());
+    assert_true(value.get_char_sequence() == "value");
+
+    obj["key"][2].get_string() += "1";
+    assert_false(obj["key"][2].is_borrowed());
+    assert_equal(obj["key"][2], "x1");
+    str.assign(str.size(), 'x');
+  }
+  assert_false(owned.is_borrowed());
+  assert_equal(owned, "value");
+  assert_equal(copy["key"][0], "value");
+  assert_equal(copy["key"][1], json::object(42));
+  assert_true(copy.get_map().begin()->first == json::char_sequence("key"));
+}
+
+TEST(insitu, error)
+{
+  const char *inputs[] = { "", "[1, 2", "{\"a\" 1}", "\"Hello", "\"\\u12\"", "\"\\ud83d\"", "\"\\ude00\"", "[1, 2,]", "tru", "-" };
+
+  for (auto input : inputs)
+    {
+      std::string str (input);
+      bool thrown = false;
+      try
+	{
+	  json::read_insitu(str);
+	}
+      catch (const json::error &)
+	{
+	  thrown = true;
+	}
+      assert_true(thrown);
+    }
+}
@@ -0,0 +1,137 @@
+/*
+ * Copyright 2012 Achille Roussel.
+ *
+ * This file is part of Libjson++.
+ *
+ * Libjson++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Libjson++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string>
+#include <thread>
+#include <vector>
+#include <unit/main>
+#include <json/object.h>
+#include <json/hash_map.hpp>
+#include <json/parser.h>
+
+static const char *key_of(const json::object &obj, const std::string &key)
+{
+  return obj.get_map().find(key)->first.data();
+}
+
+static std::string records(int n)
+{
+  std::string str ("[");
+  for (int i = 0; i != n; ++i)
+    {
+      str += "{\"id\": " + std::to_string(i) + ", \"name\": \"x\", \"geo\": {\"lat\": 1, \"id\": 2}}, ";
+    }
+  return str + "{}]";
+}
+
+TEST(key_table, intern)
+{
+  json::key_table keys;
+  const std::string a ("Hello");
+  const std::string b ("Hello");
+
+  assert_true(keys.empty());
+  auto k1 = keys.intern(a);
+  auto k2 = keys.intern(b);
+  auto k3 = keys.intern(json::char_sequence("World"));
+
+  assert_equal(keys.size(), 2);
+  assert_true(k1.interned());
+  assert_equal(k1.data(), k2.data());
+  assert_not_equal(k1.data(), a.data());
+  assert_not_equal(k1.data(), k3.data());
+  assert_equal(k1.hash(), k1.compute_hash());
+  assert_true(k1 == k2);
+  assert_false(k1 == k3);
+  assert_equal(k1, "Hello");
+}
+
+TEST(key_table, read)
+{
+  json::key_table keys;
+  json::object obj (json::read(records(100), keys));
+
+  assert_equal(keys.size(), 4);
+  assert_equal(obj.size(), 101);
+  assert_equal(obj[42]["id"].get_integer(), 42);
+  assert_equal(key_of(obj[0], "id"), key_of(obj[99], "id"));
+  assert_equal(key_of(obj[0], "id"), key_of(obj[0]["geo"], "id"));
+  assert_equal(key_of(obj[0], "name"), key_of(json::read("{\"name\": 1}", keys), "name"));
+  assert_equal(keys.size(), 4);
+  assert_true(obj == json::read(records(100)));
+}
+
+TEST(key_table, lifetime)
+{
+  json::object obj;
+  json::object copy;
+  {
+    json::key_table keys;
+    obj = json::read("{\"a\": {\"b\": 1}, \"c\": [{\"b\": 2}]}", keys);
+    copy = obj;
+    keys.clear();
+    assert_true(keys.empty());
+  }
+
+  // The keys outlive the table, the copy shares them.
+  assert_equal(key_of(obj["a"], "b"), key_of(copy["c"][0], "b"));
+  obj["a"].get_map().erase(obj["a"].get_map().find("b"));
+  obj = json::null;
+  assert_equal(copy["a"]["b"].get_integer(), 1);
+  assert_equal(copy["c"][0]["b"].get_integer(), 2);
+}
+
+TEST(key_table, synchronized)
+{
+  json::key_table keys (true);
+  const std::string str (records(1000));
+  std::vector<json::object> objs (4);
+  std::vector<std::thread> threads;
+
+  assert_true(keys.synchronized());
+  for (auto &obj : objs)
+    {
+      threads.emplace_back([&]() { obj = json::read(str, keys); });
+    }
+  for (auto &t : threads)
+    {
+      t.join();
+    }
+
+  assert_equal(keys.size(), 4);
+  for (auto &obj : objs)
+    {
+      assert_equal(obj.size(), 1001);
+      assert_equal(key_of(obj[500], "geo"), key_of(objs[0][0], "geo"));
+    }
+}
+
+TEST(key_table, parser)
+{
+  json::key_table keys;
+  json::parser parser (keys);
+  json::object obj1;
+  json::object obj2;
+
+  parser.parse("{\"a\": 1, \"b\": {\"a\": 2}}", obj1);
+  parser.parse("{\"b\": 3}", obj2);
+  assert_equal(keys.size(), 2);
+  assert_equal(key_of(obj1, "a"), key_of(obj1["b"], "a"));
+  assert_equal(key_of(obj1, "b"), key_of(obj2, "b"));
+}
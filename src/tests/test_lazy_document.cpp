@@ -0,0 +1,125 @@
+/*
+ * Copyright 2012 Achille Roussel.
+ *
+ * This file is part of Libjson++.
+ *
+ * Libjson++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Libjson++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string>
+#include <unit/main>
+#include <json/lazy_document.h>
+#include <json/error.h>
+
+TEST(lazy_document, scalars)
+{
+  json::lazy_document doc ("{\"id\": 42, \"pi\": -3.5e0, \"name\": \"H\\u00e9llo\", \"ok\": true, \"none\": null}");
+
+  assert_equal(doc.type(), json::type_map);
+  assert_equal(doc.size(), 5);
+  assert_equal(json::stoi(doc["id"]), 42);
+  assert_almost_equal(json::stod(doc["pi"]), -3.5);
+  assert_equal(doc["name"].get_string(), "H\xc3\xa9llo");
+  assert_true(json::is_true(doc["ok"]));
+  assert_true(json::is_null(doc["none"]));
+  assert_equal(doc["id"].type(), json::type_integer);
+  assert_equal(doc["pi"].type(), json::type_double);
+  assert_equal(doc["name"].type(), json::type_string);
+  assert_equal(doc["ok"].type(), json::type_boolean);
+  assert_false(json::is_string(doc["id"]));
+  assert_true(doc.find("missing") == nullptr);
+}
+
+TEST(lazy_document, nested)
+{
+  json::lazy_document doc ("[{\"a\": [1, [2, 3], {\"b\": \"[,]\"}]}, 4, {}, []]");
+
+  assert_equal(doc.size(), 4);
+  assert_equal(doc[0]["a"].size(), 3);
+  assert_equal(json::stoi(doc[0]["a"][1][1]), 3);
+  assert_equal(doc[0]["a"][2]["b"].get_string(), "[,]");
+  assert_equal(json::stoi(doc[1]), 4);
+  assert_true(doc[2].empty());
+  assert_true(json::is_map(doc[2]));
+  assert_true(doc[3].empty());
+  assert_true(json::is_list(doc[3]));
+}
+
+TEST(lazy_document, keys)
+{
+  json::lazy_document doc ("{\"a\\\"b\": 1, \"x\": 1, \"x\": 2}");
+
+  assert_equal(json::stoi(doc["a\"b"]), 1);
+  assert_equal(json::stoi(doc["x"]), 2);
+
+  std::string keys;
+  for (auto it = doc.begin(); it != doc.end(); ++it)
+    {
+      keys.append(it->key().data(), it->key().size());
+      keys += ';';
+    }
+  assert_equal(keys, "a\"b;x;x;");
+}
+
+TEST(lazy_document, get)
+{
+  json::lazy_document doc ("{\"list\": [1, true, null], \"s\": \"x\"}");
+  const json::object &obj = doc["list"].get();
+
+  assert_equal(obj.size(), 3);
+  assert_equal(obj[0], json::object(1));
+  assert_true(&obj == &doc["list"].get());
+  assert_equal(doc.get()["s"], "x");
+}
+
+TEST(lazy_document, move)
+{
+  json::lazy_document doc ("[1, 2]");
+  const json::lazy_value &value = doc[1];
+  json::lazy_document other (std::move(doc));
+
+  assert_equal(json::stoi(value), 2);
+  assert_equal(json::stoi(other[0]), 1);
+}
+
+TEST(lazy_document, error)
+{
+  const char *inputs[] = { "", "[1, 2", "{\"a\" 1}", "\"Hello", "[1, 2,]", "tru", "-" };
+
+  for (auto input : inputs)
+    {
+      bool thrown = false;
+      try
+	{
+	  json::lazy_document doc (input);
+	}
+      catch (const json::error &)
+	{
+	  thrown = true;
+	}
+      assert_true(thrown);
+    }
+
+  json::lazy_document doc ("{\"a\": [1]}");
+  bool thrown = false;
+  try
+    {
+      doc["b"];
+    }
+  catch (const json::error &)
+    {
+      thrown = true;
+    }
+  assert_true(thrown);
+}
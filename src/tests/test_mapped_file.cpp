@@ -0,0 +1,99 @@
+/*
+ * Copyright 2012 Achille Roussel.
+ *
+ * This file is part of Libjson++.
+ *
+ * Libjson++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Libjson++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <unit/main>
+#include <json/mapped_file.h>
+#include <json/object.h>
+#include <json/error.h>
+
+static std::string write_file(const std::string &content)
+{
+  const std::string path = std::string("test-mapped-file-") + std::to_string(content.size()) + ".json";
+  std::ofstream file (path, std::ios::out | std::ios::binary);
+  file << content;
+  return path;
+}
+
+TEST(mapped_file, read_file)
+{
+  const std::string path = write_file("{\"Hello\": [\"World\", 42]}\n");
+  const json::object obj = json::read_file(path);
+
+  assert_equal(obj["Hello"][0], "World");
+  assert_equal(obj["Hello"][1], json::object(42));
+  std::remove(path.c_str());
+}
+
+TEST(mapped_file, map_file)
+{
+  const std::string content = "[1, 2, 3]";
+  const std::string path = write_file(content);
+  json::mapped_file file = json::map_file(path);
+
+  assert_equal(file.size(), content.size());
+  assert_equal(std::string(file.begin(), file.end()), content);
+  assert_equal(*file.end(), '\0');
+  std::remove(path.c_str());
+}
+
+TEST(mapped_file, page_size)
+{
+  // The number ends exactly at the end of the file, the reader must find a
+  // '\0' after it even though the file fills whole pages.
+  const std::string content = std::string(4095, ' ') + "1" + std::string(4095, ' ') + "2";
+  const std::string path = write_file(content);
+
+  assert_equal(json::read_file(path), json::object(1));
+  assert_equal(*json::map_file(path).end(), '\0');
+  std::remove(path.c_str());
+
+  const std::string path2 = write_file(std::string(8191, ' ') + "7");
+  assert_equal(json::read_file(path2), json::object(7));
+  std::remove(path2.c_str());
+}
+
+TEST(mapped_file, error)
+{
+  const std::string path = write_file("");
+  bool thrown_missing = false;
+  bool thrown_empty = false;
+
+  try
+    {
+      json::read_file("this-file-does-not-exist.json");
+    }
+  catch (const json::error &)
+    {
+      thrown_missing = true;
+    }
+  try
+    {
+      json::read_file(path);
+    }
+  catch (const json::error &)
+    {
+      thrown_empty = true;
+    }
+  assert_true(thrown_missing);
+  assert_true(thrown_empty);
+  std::remove(path.c_str());
+}
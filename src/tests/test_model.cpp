@@ -21,6 +21,7 @@
 #include <string>
 #include <vector>
 #include <json/model>
+#include <json/error.h>
 #include <unit/main>
 
 struct A
@@ -29,12 +30,25 @@ struct A
   std::vector<std::string> y;
 };
 
+struct B
+{
+  unsigned long long id;
+  long long timestamp;
+  short count;
+};
+
 namespace models
 {
   const json::model<A> A { make_model(
     json::field("x", &A::x),
     json::field("y", &A::y)
   )};
+
+  const json::model<B> B { make_model(
+    json::field("id", &B::id),
+    json::field("timestamp", &B::timestamp),
+    json::field("count", &B::count)
+  )};
 }
 
 TEST(model, read)
@@ -51,6 +65,32 @@ TEST(model, read)
               (a.y[0] == "456" && a.y[1] == "123"));
 }
 
+TEST(model, read_integers)
+{
+  B b;
+
+  std::stringstream ss;
+  ss << "{\"id\": 18446744073709551615, \"timestamp\": -1700000000123, \"count\": 7}";
+  ss >> models::B >> b;
+
+  assert_equal(b.id, 18446744073709551615ull);
+  assert_equal(b.timestamp, -1700000000123ll);
+  assert_equal(b.count, 7);
+
+  bool thrown = false;
+  try
+    {
+      std::stringstream overflow;
+      overflow << "{\"id\": 1, \"timestamp\": 2, \"count\": 40000}";
+      overflow >> models::B >> b;
+    }
+  catch (const json::error &)
+    {
+      thrown = true;
+    }
+  assert_true(thrown);
+}
+
 TEST(model, write)
 {
   A a { 42, {"123"} };
@@ -62,7 +102,7 @@ TEST(model, write)
   ss >> s;
 
   assert_one_of(s,
-		"{\"x\":42,\"y\":[123]}",
-		"{\"y\":[123],\"x\":42}");
+		"{\"x\":42,\"y\":[\"123\"]}",
+		"{\"y\":[\"123\"],\"x\":42}");
 }
 
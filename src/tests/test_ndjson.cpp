@@ -0,0 +1,175 @@
+/*
+ * Copyright 2012 Achille Roussel.
+ *
+ * This file is part of Libjson++.
+ *
+ * Libjson++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Libjson++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unit/main>
+#include <json/ndjson_reader.h>
+#include <json/error.h>
+
+static std::string records(int n)
+{
+  std::ostringstream s;
+  for (int i = 0; i != n; ++i)
+    {
+      s << "{\"id\": " << i << ", \"name\": \"record " << i << "\"}\r\n";
+      if ((i % 7) == 0)
+	{
+	  s << "  \n";
+	}
+    }
+  return s.str();
+}
+
+static void check(json::ndjson_reader &r, int n)
+{
+  json::object obj;
+  int i = 0;
+
+  while (r.next(obj))
+    {
+      assert_equal(obj["id"], json::object(i));
+      ++i;
+    }
+  assert_equal(i, n);
+}
+
+TEST(ndjson, sequential)
+{
+  std::istringstream s (records(100));
+  json::ndjson_reader r (s);
+
+  check(r, 100);
+}
+
+TEST(ndjson, parallel)
+{
+  std::istringstream s (records(10000));
+  json::ndjson_reader r (s, 4, 64, 3);
+
+  check(r, 10000);
+}
+
+TEST(ndjson, empty)
+{
+  std::istringstream s ("\n\n");
+  json::ndjson_reader r (s, 2);
+  json::object obj;
+
+  assert_true(!r.next(obj));
+}
+
+TEST(ndjson, error)
+{
+  for (int threads = 0; threads != 3; ++threads)
+    {
+      std::istringstream s ("1\n[2\n\n3 4\n5\n");
+      json::ndjson_reader r (s, threads, 2);
+      json::object obj;
+      int errors = 0;
+
+      assert_true(r.next(obj));
+      assert_equal(obj, json::object(1));
+      for (int i = 0; i != 2; ++i)
+	{
+	  try
+	    {
+	      r.next(obj);
+	    }
+	  catch (const json::error &)
+	    {
+	      ++errors;
+	    }
+	}
+      assert_equal(errors, 2);
+      assert_equal(r.line(), 4);
+      assert_true(r.next(obj));
+      assert_equal(obj, json::object(5));
+      assert_true(!r.next(obj));
+    }
+}
+
+// Gives a few records then fails, as a stream over a broken connection.
+class failing_buffer : public std::streambuf
+{
+public:
+  failing_buffer():
+    _data("1\n2\n3\n"),
+    _done(false)
+  {
+  }
+
+protected:
+  int_type underflow()
+  {
+    if (_done)
+      {
+	throw std::runtime_error("connection lost");
+      }
+    _done = true;
+    setg(&_data[0], &_data[0], &_data[0] + _data.size());
+    return traits_type::to_int_type(_data[0]);
+  }
+
+private:
+  std::string _data;
+  bool        _done;
+};
+
+TEST(ndjson, stream_failure)
+{
+  for (int threads = 0; threads != 3; ++threads)
+    {
+      failing_buffer buf;
+      std::istream s (&buf);
+      s.exceptions(std::ios::badbit);
+      json::ndjson_reader r (s, threads, 2);
+      json::object obj;
+      bool thrown = false;
+
+      for (int i = 1; i != 4; ++i)
+	{
+	  assert_true(r.next(obj));
+	  assert_equal(obj, json::object(i));
+	}
+      try
+	{
+	  r.next(obj);
+	}
+      catch (const std::runtime_error &)
+	{
+	  thrown = true;
+	}
+      assert_true(thrown);
+      if (threads != 0)
+	{
+	  assert_true(!r.next(obj));
+	}
+    }
+}
+
+TEST(ndjson, early_destruction)
+{
+  std::istringstream s (records(10000));
+  json::ndjson_reader r (s, 4, 16, 2);
+  json::object obj;
+
+  assert_true(r.next(obj));
+}
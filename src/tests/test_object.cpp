@@ -17,8 +17,18 @@
  * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <sstream>
+#include <string>
 #include <unit/main>
 #include <json/object.h>
+#include <json/error.h>
+
+// The text of a number, kept from the input or formatted from its value.
+static std::string text(const json::object &obj)
+{
+  const json::char_sequence s = obj.get_char_sequence();
+  return std::string(s.data(), s.size());
+}
 
 TEST(object, create)
 {
@@ -36,6 +46,13 @@ TEST(object, copy)
   assert_equal(obj1, obj2);
 }
 
+// The type and the flags of an object fit in the word before its body,
+// whose largest member is a number and its text.
+TEST(object, size)
+{
+  assert_equal(sizeof(json::object), sizeof(json::native_value) + json::number_text_size + 8);
+}
+
 TEST(object, assign)
 {
   json::object obj1;
@@ -81,22 +98,170 @@ TEST(obj, boolean)
 
   assert_true(json::is_true(obj1));
   assert_true(json::is_false(obj2));
+  assert_false(json::is_true(json::object("true")));
+  assert_false(json::is_false(json::object("false")));
 }
 
 TEST(obj, integer)
 {
   json::object obj (42);
 
-  assert_true(json::is_string(obj));
-  assert_equal(obj, "42");
+  assert_true(json::is_number(obj));
+  assert_equal(obj.type(), json::type_integer);
+  assert_equal(obj.get_integer(), 42);
+  assert_equal(text(obj), "42");
+
+  // Numbers and strings are never equal, even with the same text.
+  assert_false(obj == "42");
+  assert_false(obj == json::object("42"));
+
+  obj = 18446744073709551615ull;
+  assert_equal(obj.type(), json::type_unsigned);
+  assert_equal(text(obj), "18446744073709551615");
+  obj = 42u;
+  assert_equal(obj.type(), json::type_integer);
+  assert_equal(obj, json::object(42));
 }
 
 TEST(obj, float)
 {
   json::object obj (42.42);
 
-  assert_true(json::is_string(obj));
-  assert_almost_equal(std::stod(obj.get_string()), 42.42);
+  assert_true(json::is_number(obj));
+  assert_equal(obj.type(), json::type_double);
+  assert_almost_equal(std::stod(obj), 42.42);
+  assert_equal(text(obj), "42.42");
+  assert_equal(text(json::object(42.0)), "42.0");
+  assert_equal(text(json::object(0.1)), "0.1");
+  assert_equal(text(json::object(1e300)), "1e+300");
+
+  // An assigned number has its text like a number read by the parser, it is
+  // available through a const object.
+  json::object map;
+  map["n"] = 42;
+  map["x"] = 0.5;
+  const json::object &constant = map;
+  assert_true(constant["n"].get_char_sequence() == "42");
+  assert_true(constant["x"].get_char_sequence() == "0.5");
+  assert_true(json::read("{\"n\": 42}")["n"].get_char_sequence() == "42");
+}
+
+TEST(obj, number)
+{
+  const json::object list (json::read("[true, 1, -9223372036854775808, 18446744073709551615, "
+				      "18446744073709551616, 1.0, -2.5e3, 0.10000000000000000000000001]"));
+
+  assert_equal(list[0].type(), json::type_boolean);
+  assert_true(list[0].get_boolean());
+  assert_equal(list[1].type(), json::type_integer);
+  assert_equal(list[2].get_integer(), -9223372036854775807ll - 1);
+  assert_equal(list[3].type(), json::type_unsigned);
+  assert_equal(list[4].type(), json::type_double);
+  assert_equal(list[5].type(), json::type_double);
+  assert_equal(list[6].get_double(), -2500.0);
+
+  // The text is kept when it fits, to be written back unchanged.
+  assert_equal(text(list[6]), "-2.5e3");
+  assert_equal(text(list[7]), "0.1");
+  std::ostringstream s;
+  s << list;
+  assert_equal(s.str(), "[true,1,-9223372036854775808,18446744073709551615,"
+	       "18446744073709551616,1.0,-2.5e3,0.1]");
+
+  // Numbers are equal by value whatever their type.
+  assert_true(list[1] == list[5]);
+  assert_true(list[6] == json::object(-2500));
+  assert_false(list[1] == json::object("1"));
+  assert_false(list[0] == json::object(1));
+
+  assert_equal(json::stoi(list[6]), -2500);
+  assert_equal(json::stof(list[6]), -2500.0f);
+  assert_equal(json::stoull(list[3]), 18446744073709551615ull);
+  assert_equal(json::stoi(list[1]), 1);
+
+  bool thrown = false;
+  try
+    {
+      json::stoi(list[3]);
+    }
+  catch (const json::error &)
+    {
+      thrown = true;
+    }
+  assert_true(thrown);
+}
+
+TEST(obj, packed)
+{
+  json::object obj;
+
+  for (int i = 0; i != 10; ++i)
+    {
+      obj[i] = i;
+    }
+  assert_true(obj.pack());
+  assert_true(obj.is_packed());
+  assert_equal(obj.get_integers().size(), 10);
+  assert_equal(obj.get_integers()[9], 9);
+
+  // Packed and unpacked lists compare by value.
+  const json::object copy (obj);
+  assert_true(copy.is_packed());
+  const json::packing_scope packing;
+  json::object list (json::read("[0, 1, 2, 3, 4, 5, 6, 7, 8, 9.0]"));
+  assert_true(list.is_packed());
+  assert_true(copy == list);
+  list.unpack();
+  assert_false(list.is_packed());
+  assert_true(copy == list);
+  assert_true(list == copy);
+
+  bool thrown = false;
+  try
+    {
+      obj.get_doubles();
+    }
+  catch (const json::error &)
+    {
+      thrown = true;
+    }
+  assert_true(thrown);
+
+  // Accessing the members as objects unpacks the list.
+  obj.get_integers()[0] = 42;
+  obj[1] = "Hello";
+  assert_false(obj.is_packed());
+  assert_equal(obj[0], json::object(42));
+  assert_equal(obj[1], "Hello");
+  assert_false(obj.pack());
+
+  // A const packed list is never unpacked, its members are iterated as
+  // values.
+  thrown = false;
+  try
+    {
+      copy[3];
+    }
+  catch (const json::error &)
+    {
+      thrown = true;
+    }
+  assert_true(thrown);
+  int n = 0;
+  for (const json::object &x : copy)
+    {
+      assert_equal(x, json::object(n));
+      ++n;
+    }
+  assert_equal(n, 10);
+  assert_true(copy.is_packed());
+
+  json::object::native_list values (3);
+  values[0].real = 0.5;
+  obj.make_packed(json::type_double, std::move(values));
+  std::ostringstream s;
+  s << obj;
+  assert_equal(s.str(), "[0.5,0.0,0.0]");
 }
 
 TEST(obj, list_iterator)
@@ -137,7 +302,7 @@ TEST(obj, map_iterator)
   while (it != jt)
     {
       assert_one_of(it->first, "Hello", "Answer");
-      assert_one_of(it->second, "World", "42");
+      assert_one_of(it->second, json::object("World"), json::object(42));
       ++it;
       ++n;
     }
@@ -0,0 +1,112 @@
+/*
+ * Copyright 2012 Achille Roussel.
+ *
+ * This file is part of Libjson++.
+ *
+ * Libjson++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Libjson++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string>
+#include <unit/main>
+#include <json/object.h>
+#include <json/parallel_reader.h>
+#include <json/error.h>
+
+static std::string make_records(const int n)
+{
+  std::string str (" [");
+  for (int i = 0; i != n; ++i)
+    {
+      if (i != 0)
+	{
+	  str += ", ";
+	}
+      str += "{\"id\": " + std::to_string(i) + ", \"name\": \"a ]\\\"[ b\", \"tags\": [true, null, {}]}";
+    }
+  str += "] ";
+  return str;
+}
+
+TEST(parallel_reader, list)
+{
+  const std::string str (make_records(1000));
+  const json::object expected (json::read(str));
+
+  for (unsigned threads : { 0, 1, 2, 3, 8 })
+    {
+      json::object obj (json::read_parallel(str, threads));
+      assert_equal(obj.size(), 1000);
+      assert_equal(obj[999]["id"], json::object(999));
+      assert_equal(obj[500]["name"], "a ]\"[ b");
+      assert_true(obj == expected);
+    }
+}
+
+TEST(parallel_reader, small)
+{
+  assert_equal(json::read_parallel("[]", 4).size(), 0);
+  assert_true(json::is_list(json::read_parallel(" [ ] ", 4)));
+  assert_equal(json::read_parallel("[1]", 4)[0], json::object(1));
+  assert_equal(json::read_parallel("[[1, 2], [3]]", 4)[1][0], json::object(3));
+  assert_equal(json::read_parallel("{\"a\": [1]}", 4)["a"][0], json::object(1));
+  assert_equal(json::read_parallel("\"Hello\"", 4), "Hello");
+}
+
+TEST(parallel_reader, packing)
+{
+  std::string str ("[");
+  for (int i = 0; i != 1000; ++i)
+    {
+      str += "[" + std::to_string(i) + ", 0.5], ";
+    }
+  str += "[]]";
+
+  // The workers pack lists of numbers like the calling thread.
+  {
+    const json::packing_scope packing;
+    const json::object obj (json::read_parallel(str, 4));
+    for (int i = 0; i != 1000; ++i)
+      {
+	assert_true(obj[i].is_packed());
+      }
+    assert_equal(obj[999].get_doubles()[0], 999.0);
+  }
+  const json::object obj (json::read_parallel(str, 4));
+  for (int i = 0; i != 1000; ++i)
+    {
+      assert_false(obj[i].is_packed());
+    }
+}
+
+TEST(parallel_reader, error)
+{
+  std::string broken (make_records(1000));
+  broken.replace(broken.find("true", broken.size() / 2), 4, "tru ");
+
+  const std::string inputs[] = { "", "[1, 2", "[1 2]", "[1, 2,]", "[\"Hello]", "[{\"a\" 1}]", broken };
+
+  for (const auto &input : inputs)
+    {
+      bool thrown = false;
+      try
+	{
+	  json::read_parallel(input, 4);
+	}
+      catch (const json::error &)
+	{
+	  thrown = true;
+	}
+      assert_true(thrown);
+    }
+}
@@ -0,0 +1,119 @@
+/*
+ * Copyright 2012 Achille Roussel.
+ *
+ * This file is part of Libjson++.
+ *
+ * Libjson++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Libjson++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <unit/main>
+#include <json/parser.h>
+#include <json/error.h>
+
+// Counts the allocations made on the global heap.
+static std::size_t heap_allocations = 0;
+
+void *operator new(std::size_t size)
+{
+  ++heap_allocations;
+  if (void *p = std::malloc(size ? size : 1))
+    {
+      return p;
+    }
+  throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept
+{
+  std::free(p);
+}
+
+static std::string message(int i)
+{
+  const std::string n (std::to_string(i));
+  return "{\"id\": " + n + ", \"name\": \"user \\\"" + n + "\\\" with a long name\", "
+    "\"tags\": [\"a\", \"b\", " + n + "], \"geo\": {\"lat\": 1.5, \"lng\": -" + n + "}, \"ok\": true}";
+}
+
+TEST(parser, reuse)
+{
+  json::parser parser;
+  json::object obj;
+
+  parser.parse(message(0), obj);
+  for (int i = 1; i != 100; ++i)
+    {
+      const std::string str (message(i));
+      const std::size_t before = heap_allocations;
+      parser.parse(str, obj);
+      assert_equal(heap_allocations, before);
+      assert_true(obj == json::read(str));
+    }
+  assert_equal(json::stoi(obj["id"]), 99);
+  assert_equal(obj["geo"]["lng"], json::object(-99));
+}
+
+TEST(parser, shape_changes)
+{
+  const char *inputs[] = {
+    "{\"a\": [1, 2, 3], \"b\": {\"c\": \"d\"}, \"e\": null}",
+    "{\"a\": [1], \"b\": \"c\", \"f\": true}",
+    "{\"a\": [1, {\"x\": [2]}, 3, 4], \"a\": [5], \"g\": {}}",
+    "{}",
+    "[{\"a\": 1}, {\"a\": 2, \"b\": 3}, []]",
+    "[{\"b\": 1}, {\"a\": 2}]",
+    "\"Hello\\nWorld\"",
+    "-1.5e3",
+    "{\"k\\u00e9y\": [true, false, null]}",
+    "{\"a\": 1, \"b\": 2, \"a\": 3}",
+  };
+
+  json::parser parser;
+  json::object obj;
+  for (auto input : inputs)
+    {
+      parser.parse(input, obj);
+      assert_true(obj == json::read(input));
+    }
+
+  parser.parse(json::char_sequence("[1, 2] tail", 6), obj);
+  assert_equal(obj.size(), 2);
+}
+
+TEST(parser, errors)
+{
+  const char *inputs[] = { "", "[1, 2", "{\"a\" 1}", "\"Hello", "[1, 2,]", "tru", "-", "{1: 2}" };
+
+  json::parser parser;
+  json::object obj;
+  for (auto input : inputs)
+    {
+      bool thrown = false;
+      try
+	{
+	  parser.parse(input, obj);
+	}
+      catch (const json::error &)
+	{
+	  thrown = true;
+	}
+      assert_true(thrown);
+    }
+
+  parser.parse("{\"a\": {\"b\": 1}}", obj);
+  assert_equal(obj["a"]["b"], json::object(1));
+}
@@ -17,9 +17,13 @@
  * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <cmath>
+#include <limits>
+#include <string>
 #include <unit/main>
 #include <json/parsing.h>
 #include <json/object.h>
+#include <json/error.h>
 
 TEST(parsing, stoi)
 {
@@ -87,6 +91,154 @@ TEST(parsing, stold)
   assert_almost_equal(-1e-3, json::stold(json::object(-1e-3)));
 }
 
+static json::object number(const char *str)
+{
+  return json::object(std::string(str));
+}
+
+TEST(parsing, stoull)
+{
+  assert_equal(json::stoull(number("0")), 0ull);
+  assert_equal(json::stoull(number("1234567890123456")), 1234567890123456ull);
+  assert_equal(json::stoull(number("18446744073709551615")), 18446744073709551615ull);
+  assert_equal(json::stoull(number("000000000000000000000000042")), 42ull);
+  assert_equal(json::stoul(number("1700000000000")), 1700000000000ul);
+  assert_equal(json::stoll(number("-9223372036854775808")), -9223372036854775807ll - 1);
+  assert_equal(json::stoll(number("9223372036854775807")), 9223372036854775807ll);
+  assert_equal(json::stoi(number("-2147483648")), -2147483647 - 1);
+}
+
+TEST(parsing, stoll_digits)
+{
+  // Every length crosses the blocks of 8 digits differently.
+  long long expected = 0;
+  std::string str;
+  for (int i = 1; i != 19; ++i)
+    {
+      str += char('0' + (i % 10));
+      expected = (expected * 10) + (i % 10);
+      assert_equal(json::stoll(number(str.c_str())), expected);
+      assert_equal(json::stoll(number(("-" + str).c_str())), -expected);
+    }
+}
+
+TEST(parsing, stoi_fraction)
+{
+  assert_equal(json::stoi(number("42.0")), 42);
+  assert_equal(json::stoi(number("4.2e1")), 42);
+  assert_equal(json::stoi(number("-4.9")), -4);
+  assert_equal(json::stoll(number("1e18")), 1000000000000000000ll);
+  assert_equal(json::stoull(number("1.8446744073709551615e19")), 18446744073709551615ull);
+}
+
+TEST(parsing, stoi_error)
+{
+  const char *inputs[] = { "", "-", "x1", "1x", "12345678x", "1234567812345678x", "2147483648", "-2147483649",
+			   "1e10", "99999999999999999999" };
+
+  for (auto input : inputs)
+    {
+      bool thrown = false;
+      try
+	{
+	  json::stoi(number(input));
+	}
+      catch (const json::error &)
+	{
+	  thrown = true;
+	}
+      assert_true(thrown);
+    }
+
+  const char *unsigned_inputs[] = { "-1", "18446744073709551616", "1e20", "123456789012345678901" };
+
+  for (auto input : unsigned_inputs)
+    {
+      bool thrown = false;
+      try
+	{
+	  json::stoull(number(input));
+	}
+      catch (const json::error &)
+	{
+	  thrown = true;
+	}
+      assert_true(thrown);
+    }
+}
+
+template < typename Float >
+static Float parse(const char *str)
+{
+  const json::object obj ((std::string(str)));
+  if (std::is_same<Float, float>::value)
+    {
+      return json::stof(obj);
+    }
+  if (std::is_same<Float, double>::value)
+    {
+      return json::stod(obj);
+    }
+  return json::stold(obj);
+}
+
+TEST(parsing, stod_rounding)
+{
+  assert_equal(parse<double>("0.1"), 0.1);
+  assert_equal(parse<double>("-1.25"), -1.25);
+  assert_equal(parse<double>("37.7749295"), 37.7749295);
+  assert_equal(parse<double>("-122.4194155"), -122.4194155);
+  assert_equal(parse<double>("1e23"), 1e23);
+  assert_equal(parse<double>("8.41e21"), 8.41e21);
+  assert_equal(parse<double>("9007199254740993"), 9007199254740992.0);
+  assert_equal(parse<double>("9007199254740993.0000000000000000001"), 9007199254740994.0);
+  assert_equal(parse<double>("0.1000000000000000055511151231257827021181583404541015625"), 0.1);
+  assert_equal(parse<double>("2.2250738585072011e-308"), 2.2250738585072011e-308);
+  assert_equal(parse<double>("4.9e-324"), 4.9e-324);
+  assert_equal(parse<double>("2.4703282292062327e-324"), 0.0);
+  assert_equal(parse<double>("1.7976931348623157e308"), 1.7976931348623157e308);
+  assert_equal(parse<double>("1e400"), std::numeric_limits<double>::infinity());
+  assert_equal(parse<double>("1e-400"), 0.0);
+  assert_true(std::signbit(parse<double>("-0.0")));
+}
+
+TEST(parsing, stof_rounding)
+{
+  assert_equal(parse<float>("0.1"), 0.1f);
+  assert_equal(parse<float>("16777217"), 16777216.0f);
+  assert_equal(parse<float>("1.00000005960464477539062501"), 1.00000012f);
+  assert_equal(parse<float>("3.4028235e38"), 3.4028235e38f);
+  assert_equal(parse<float>("1.4e-45"), 1.4e-45f);
+  assert_equal(parse<float>("1e39"), std::numeric_limits<float>::infinity());
+}
+
+TEST(parsing, stold_rounding)
+{
+  assert_equal(parse<long double>("0.1"), 0.1L);
+  assert_equal(parse<long double>("-37.7749295"), -37.7749295L);
+  assert_equal(parse<long double>("1.5e300"), 1.5e300L);
+  assert_equal(parse<long double>("123456789012345678901234567890"), 123456789012345678901234567890.0L);
+}
+
+TEST(parsing, stod_error)
+{
+  const char *inputs[] = { "", "-", "1.", ".5", "1e", "1e+", "e5", "--1", "1.5x", "0x10" };
+
+  for (auto input : inputs)
+    {
+      bool thrown = false;
+      try
+	{
+	  parse<double>(input);
+	}
+      catch (const json::error &)
+	{
+	  thrown = true;
+	}
+      assert_true(thrown);
+    }
+}
+
 TEST(parsing, is_json_true)
 {
   assert_true(json::is_json_true(json::object(true)));
@@ -0,0 +1,105 @@
+/*
+ * Copyright 2012 Achille Roussel.
+ *
+ * This file is part of Libjson++.
+ *
+ * Libjson++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Libjson++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string>
+#include <unit/main>
+#include <json/object.h>
+#include <json/error.h>
+
+static const char *event =
+  "{\"user\": {\"id\": 42, \"name\": \"Bob \\\"B\\\"\", \"tags\": [\"a\", {\"b\": [1, 2]}]},"
+  " \"items\": [{\"price\": 1.5, \"qty\": 2}, {\"qty\": 1, \"price\": \"free\"}, {\"price\": [1]}],"
+  " \"meta\": {\"odd\\\\\": \"]}{[\", \"list\": [[], {}, null, true, false, -1e3]},"
+  " \"a/b\": {\"~\": 7}}";
+
+TEST(path_filter, paths)
+{
+  json::object obj (json::read(event, { "/user/id", "/items/*/price" }));
+
+  assert_equal(obj.size(), 2);
+  assert_equal(obj["user"].size(), 1);
+  assert_equal(obj["user"]["id"], json::object(42));
+  assert_equal(obj["items"].size(), 3);
+  for (std::size_t i = 0; i != 3; ++i)
+    {
+      assert_equal(obj["items"][i].size(), 1);
+    }
+  assert_equal(obj["items"][0]["price"], json::object(1.5));
+  assert_equal(obj["items"][1]["price"], "free");
+  assert_equal(obj["items"][2]["price"][0], json::object(1));
+}
+
+TEST(path_filter, subtree)
+{
+  json::object obj (json::read(std::string(event), { "/meta", "/user/tags/1" }));
+
+  assert_equal(obj["meta"]["odd\\"], "]}{[");
+  assert_equal(obj["meta"]["list"].size(), 6);
+  assert_equal(obj["user"]["tags"].size(), 2);
+  assert_true(json::is_null(obj["user"]["tags"][0]));
+  assert_equal(obj["user"]["tags"][1]["b"][1], json::object(2));
+  assert_equal(json::read(event, { "" }), json::read(event));
+}
+
+TEST(path_filter, wildcard)
+{
+  json::object obj (json::read(event, { "/*/qty", "/items/1", "/a~1b/~0" }));
+
+  assert_equal(obj["items"].size(), 2);
+  assert_equal(obj["items"][0].size(), 0);
+  assert_equal(obj["items"][1]["price"], "free");
+  assert_equal(obj["a/b"]["~"], json::object(7));
+  assert_equal(obj["user"].size(), 0);
+  assert_equal(obj["meta"].size(), 0);
+
+  json::object items (json::read(event, { "/items/*/qty", "/items/0/price" }));
+  assert_equal(items["items"][0]["price"], json::object(1.5));
+  assert_equal(items["items"][0]["qty"], json::object(2));
+  assert_equal(items["items"][1].size(), 1);
+}
+
+TEST(path_filter, error)
+{
+  const char *inputs[] = { "", "[1, 2", "{\"a\": {\"b\": 1}", "{\"a\": \"Hello", "{\"a\": [1, 2}", "{\"x\": tru}" };
+
+  for (auto input : inputs)
+    {
+      bool thrown = false;
+      try
+	{
+	  json::read(input, { "/b" });
+	}
+      catch (const json::error &)
+	{
+	  thrown = true;
+	}
+      assert_true(thrown);
+    }
+
+  bool thrown = false;
+  try
+    {
+      json::path_filter filter { "user/id" };
+    }
+  catch (const json::error &)
+    {
+      thrown = true;
+    }
+  assert_true(thrown);
+}
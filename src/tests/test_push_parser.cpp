@@ -0,0 +1,179 @@
+/*
+ * Copyright 2012 Achille Roussel.
+ *
+ * This file is part of Libjson++.
+ *
+ * Libjson++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Libjson++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <unit/main>
+#include <json/push_parser.h>
+#include <json/error.h>
+
+static const std::string document =
+  "{\"list\": [1, -2.5e3, true, null], \"str\": \"a\\\"]}\\\\\\u00e9\"}\n"
+  "[] \"Hello\" {\"x\": {\"y\": [[]]}} 42";
+
+static void check(json::push_parser &p)
+{
+  json::object obj;
+
+  assert_equal(p.available(), 5);
+  assert_true(p.next(obj));
+  assert_equal(obj["list"][1], json::object(-2.5e3));
+  assert_equal(obj["str"], "a\"]}\\\xc3\xa9");
+  assert_true(p.next(obj));
+  assert_true(json::is_list(obj));
+  assert_equal(obj.size(), 0);
+  assert_true(p.next(obj));
+  assert_equal(obj, "Hello");
+  assert_true(p.next(obj));
+  assert_true(json::is_list(obj["x"]["y"][0]));
+  assert_true(p.next(obj));
+  assert_equal(obj, json::object(42));
+  assert_true(!p.next(obj));
+}
+
+TEST(push_parser, single_chunk)
+{
+  json::push_parser p;
+
+  assert_equal(p.feed(document.data(), document.size()), 4);
+  assert_true(p.pending());
+  p.finish();
+  assert_true(!p.pending());
+  check(p);
+}
+
+TEST(push_parser, chunks)
+{
+  for (std::size_t n = 1; n != 8; ++n)
+    {
+      json::push_parser p;
+
+      for (std::size_t i = 0; i < document.size(); i += n)
+	{
+	  p.feed(document.data() + i, std::min(n, document.size() - i));
+	}
+      p.finish();
+      check(p);
+    }
+}
+
+TEST(push_parser, error)
+{
+  const char *inputs[] = { "[1, 2}", "]", "{\"a\" 1}", "[1, 2,]", "tru ", "42[1]", "true{}", "1\"a\"" };
+
+  for (auto input : inputs)
+    {
+      json::push_parser p;
+      bool thrown = false;
+      try
+	{
+	  p.feed(input, std::strlen(input));
+	}
+      catch (const json::error &)
+	{
+	  thrown = true;
+	}
+      assert_true(thrown);
+    }
+}
+
+// Errors are reported by the chunk holding the offending character, before
+// the value ends.
+TEST(push_parser, early_error)
+{
+  const char *inputs[] = { "[1, x", "{\"a\": 1 2", "{1", "[tx", "[1.5z", "{\"a\"]" };
+
+  for (auto input : inputs)
+    {
+      json::push_parser p;
+      const std::size_t n = std::strlen(input);
+      bool thrown = false;
+      p.feed(input, n - 1);
+      assert_true(p.pending());
+      try
+	{
+	  p.feed(input + n - 1, 1);
+	}
+      catch (const json::error &)
+	{
+	  thrown = true;
+	}
+      assert_true(thrown);
+    }
+}
+
+TEST(push_parser, packing)
+{
+  json::push_parser p;
+  json::object obj;
+
+  p.feed("[1, 2, 3] ", 10);
+  assert_true(p.next(obj));
+  assert_false(obj.is_packed());
+  assert_equal(obj[2], json::object(3));
+
+  const json::packing_scope scope;
+  p.feed("{\"a\": [1, 2.5], \"b\": [\"x\"]}", 27);
+  assert_true(p.next(obj));
+  assert_true(obj["a"].is_packed());
+  assert_false(obj["b"].is_packed());
+  assert_equal(obj["a"][1], json::object(2.5));
+}
+
+TEST(push_parser, error_keeps_completed)
+{
+  json::push_parser p;
+  json::object obj;
+  bool thrown = false;
+
+  try
+    {
+      p.feed("[1] {\"a\": [2,]}", 15);
+    }
+  catch (const json::error &)
+    {
+      thrown = true;
+    }
+  assert_true(thrown);
+  assert_equal(p.available(), 1);
+  assert_true(p.next(obj));
+  assert_true(json::is_list(obj));
+  assert_true(!p.next(obj));
+}
+
+TEST(push_parser, eof)
+{
+  json::push_parser p;
+  bool thrown = false;
+
+  p.feed("[\"abc", 5);
+  try
+    {
+      p.finish();
+    }
+  catch (const json::error &)
+    {
+      thrown = true;
+    }
+  assert_true(thrown);
+  p.reset();
+  assert_true(!p.pending());
+  assert_equal(p.feed("[]", 2), 1);
+}
@@ -17,9 +17,12 @@
  * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+#include <cstring>
 #include <sstream>
 #include <unit/main>
 #include <json/object.h>
+#include <json/error.h>
 
 static json::object from_string(const char *str)
 {
@@ -49,7 +52,7 @@ TEST(read, boolean)
 
 TEST(read, number)
 {
-  assert_equal(from_string("42"), "42");
+  assert_equal(from_string("42"), json::object(42));
 }
 
 TEST(read, list)
@@ -57,9 +60,9 @@ TEST(read, list)
   json::object obj (from_string("[1, 2, 3]"));
 
   assert_equal(obj.size(), 3);
-  assert_equal(obj[0], "1");
-  assert_equal(obj[1], "2");
-  assert_equal(obj[2], "3");
+  assert_equal(obj[0], json::object(1));
+  assert_equal(obj[1], json::object(2));
+  assert_equal(obj[2], json::object(3));
 }
 
 TEST(read, map)
@@ -68,5 +71,373 @@ TEST(read, map)
 
   assert_equal(obj.size(), 2);
   assert_equal(obj["Hello"], "World");
-  assert_equal(obj["Answer"], "42");
+  assert_equal(obj["Answer"], json::object(42));
+}
+
+TEST(read, buffer)
+{
+  json::object obj (json::read(std::string("{\"list\": [1, -2.5e3, true, null], \"map\": {}}")));
+
+  assert_equal(obj.size(), 2);
+  assert_equal(obj["list"].size(), 4);
+  assert_equal(obj["list"][0], json::object(1));
+  assert_equal(obj["list"][1], json::object(-2.5e3));
+  assert_true(json::is_true(obj["list"][2]));
+  assert_true(json::is_null(obj["list"][3]));
+  assert_true(json::is_map(obj["map"]));
+}
+
+TEST(read, buffer_string)
+{
+  assert_equal(json::read("\"Hello\\tWorld\""), "Hello\tWorld");
+  assert_equal(json::read("\"\\u00e9\""), "\xc3\xa9");
+  assert_equal(json::read("\"\\ud83d\\uDE00\""), "\xf0\x9f\x98\x80");
+  assert_equal(json::read(json::char_sequence("\"Hello\" World", 7)), "Hello");
+  assert_equal(json::read("{\"a\\\"b\": 1}")["a\"b"], json::object(1));
+}
+
+TEST(read, buffer_error)
+{
+  const char *inputs[] = { "", "[1, 2", "{\"a\" 1}", "\"Hello", "[1, 2,]", "tru", "-",
+			   "\"\\ud83d\"", "\"\\ud83dx\"", "\"\\ud83d\\u0041\"", "\"\\ude00\"" };
+
+  for (auto input : inputs)
+    {
+      bool thrown = false;
+      try
+	{
+	  json::read(input);
+	}
+      catch (const json::error &)
+	{
+	  thrown = true;
+	}
+      assert_true(thrown);
+    }
+}
+
+TEST(read, unpacked)
+{
+  // Lists of numbers are read as lists of objects unless packing is enabled,
+  // their members are accessed through a const object.
+  const json::object obj (json::read("{\"a\": [1, 2, 3], \"b\": [0.5]}"));
+  const json::object &a = obj["a"];
+
+  assert_false(a.is_packed());
+  assert_equal(json::stoi(a[0]), 1);
+  assert_equal(a.get_list().size(), 3);
+  assert_equal(obj["b"][0], json::object(0.5));
+}
+
+TEST(read, packed)
+{
+  const json::packing_scope packing;
+  json::object obj (json::read("{\"i\": [1, -2, 3], \"d\": [1, 2.5, -3e2], \"n\": [[0.5], []], "
+			       "\"u\": [1, 18446744073709551615], \"x\": [1, 9007199254740993, 0.5], "
+			       "\"s\": [1, -2.5e3, \"a\"]}"));
+
+  assert_true(obj["i"].is_packed());
+  assert_equal(obj["i"].packed_type(), json::type_integer);
+  assert_equal(obj["i"].size(), 3);
+  assert_equal(obj["i"].get_integers()[1], -2);
+  assert_true(obj["d"].is_packed());
+  assert_equal(obj["d"].packed_type(), json::type_double);
+  assert_equal(obj["d"].get_doubles()[0], 1.0);
+  assert_equal(obj["d"].get_doubles()[2], -300.0);
+  assert_true(obj["n"][0].is_packed());
+  assert_false(obj["n"][1].is_packed());
+
+  // Members which don't share a type with the others, or are not numbers,
+  // leave the list unpacked and keep their text.
+  assert_false(obj["u"].is_packed());
+  assert_false(obj["x"].is_packed());
+  assert_equal(obj["x"][1], json::object(9007199254740993ll));
+  assert_false(obj["s"].is_packed());
+  assert_equal(obj["s"][1], json::object(-2.5e3));
+
+  std::ostringstream s;
+  s << obj["d"];
+  assert_equal(s.str(), "[1.0,2.5,-300.0]");
+}
+
+static json::object from_indexed(const std::string &str)
+{
+  json::object obj;
+  json::read_indexed(str.c_str(), str.c_str() + str.size(), obj);
+  return obj;
+}
+
+TEST(read, structural_index)
+{
+  const std::string str ("{\"a\": [1, \"[,]\"], \"b\\\\\": true}");
+  const unsigned offsets[] = { 0, 1, 4, 6, 7, 8, 10, 15, 16, 18, 23, 25, 29 };
+  json::structural_index index;
+
+  index.build(str.c_str(), str.c_str() + str.size());
+  assert_equal(index.size(), sizeof(offsets) / sizeof(offsets[0]));
+  for (std::size_t i = 0; i != index.size(); ++i)
+    {
+      assert_equal(index[i], offsets[i]);
+    }
+}
+
+TEST(read, indexed)
+{
+  std::string str ("[");
+  for (int i = 0; i != 100; ++i)
+    {
+      str += "{\"id\": 42, \"name\": \"Hello \\\"World\\\"\", \"tags\": [true, null]}, ";
+    }
+  str += "{\"x\": 1, \"x\": 2}]";
+
+  json::object obj (from_indexed(str));
+
+  assert_equal(obj.size(), 101);
+  assert_equal(obj[99]["id"], json::object(42));
+  assert_equal(obj[99]["name"], "Hello \"World\"");
+  assert_true(json::is_true(obj[99]["tags"][0]));
+  assert_true(json::is_null(obj[99]["tags"][1]));
+  assert_equal(obj[100].size(), 1);
+  assert_equal(obj[100]["x"], json::object(2));
+  assert_equal(from_indexed("-1.5e3"), json::object(-1.5e3));
+
+  const json::packing_scope packing;
+  const char *packed = "{\"a\": [1, 2.5 ], \"b\": [3, \"x\"], \"c\": [[4], 5]}";
+  json::object expected;
+  json::read_buffer(packed, packed + std::strlen(packed), expected);
+  obj = from_indexed(packed);
+  assert_true(obj == expected);
+  assert_true(obj["a"].is_packed());
+  assert_true(!obj["b"].is_packed());
+  assert_true(obj["c"][0].is_packed());
+  assert_true(json::read_terminated(packed, packed + std::strlen(packed)) == expected);
+
+  const json::packing_scope unpacked (false);
+  assert_false(from_indexed(packed)["a"].is_packed());
+}
+
+TEST(read, range)
+{
+  const char buffer[] = { '[', '1', ',', ' ', '2', ']', '3', '}' };
+
+  assert_true(json::read(json::char_sequence(buffer, 6)) == json::read("[1, 2]"));
+  assert_equal(json::read(json::char_sequence(buffer + 1, 1)), json::object(1));
+  assert_equal(json::read(json::char_sequence(buffer + 6, 1)), json::object(3));
+}
+
+TEST(read, indexed_error)
+{
+  const char *inputs[] = { "", "[1, 2", "{\"a\" 1}", "\"Hello", "[1, 2,]", "[1 2]", "tru", "-" };
+
+  for (auto input : inputs)
+    {
+      bool thrown = false;
+      try
+	{
+	  from_indexed(input);
+	}
+      catch (const json::error &)
+	{
+	  thrown = true;
+	}
+      assert_true(thrown);
+    }
+}
+
+TEST(read, long_string)
+{
+  for (std::size_t n = 0; n != 80; ++n)
+    {
+      const std::string str (n, 'x');
+      const std::string escaped (str + "\\\"" + str);
+
+      assert_equal(json::read("\"" + str + "\""), str);
+      assert_equal(json::read("\"" + escaped + "\""), str + "\"" + str);
+      assert_equal(from_string(("\"" + escaped + "\"").c_str()), str + "\"" + str);
+    }
+}
+
+TEST(read, string_escape)
+{
+  assert_equal(from_string("\"Hello  \\/ \\u00E9\\n  World\""), "Hello  / \xc3\xa9\n  World");
+  assert_equal(from_string("\"\\uD834\\uDD1E\""), "\xf0\x9d\x84\x9e");
+  assert_equal(json::read("\"\\u00E9\\b\\f\\r\\t\""), "\xc3\xa9\b\f\r\t");
+}
+
+TEST(read, stream)
+{
+  std::stringstream s ("  {\"a b\": \" x  y \"}[1,  2]\n42 \"tail\"");
+  json::object obj1;
+  json::object obj2;
+  json::object obj3;
+
+  s >> obj1 >> obj2 >> obj3;
+  assert_equal(obj1["a b"], " x  y ");
+  assert_equal(obj2.size(), 2);
+  assert_equal(obj3, json::object(42));
+
+  std::string tail;
+  std::getline(s, tail);
+  assert_equal(tail, " \"tail\"");
+}
+
+TEST(read, stream_blocks)
+{
+  std::string str ("[");
+  for (int i = 0; i != 1000; ++i)
+    {
+      str += "\"Hello World\", ";
+    }
+  str += "-1.5e3] 7";
+
+  std::istringstream in (str);
+  std::istream &s = in;
+  json::object obj (json::read(s));
+
+  assert_equal(obj.size(), 1001);
+  assert_equal(obj[1000], json::object(-1.5e3));
+  assert_equal(json::read(s), json::object(7));
+  assert_true(s.eof());
+}
+
+// A stream buffer without get area, characters are served one at a time.
+// Like a socket or a pipe it may announce the characters it can serve
+// without blocking through showmanyc.
+class unbuffered : public std::streambuf
+{
+
+public:
+  unbuffered(const std::string &str, const bool announce = false):
+    _str(str),
+    _pos(0),
+    _announce(announce)
+  {
+  }
+
+protected:
+  std::streamsize showmanyc()
+  {
+    return _announce ? std::streamsize(_str.size() - _pos) : 0;
+  }
+
+  int_type underflow()
+  {
+    return (_pos == _str.size()) ? traits_type::eof() : traits_type::to_int_type(_str[_pos]);
+  }
+
+  int_type uflow()
+  {
+    return (_pos == _str.size()) ? traits_type::eof() : traits_type::to_int_type(_str[_pos++]);
+  }
+
+private:
+  std::string	_str;
+  std::size_t	_pos;
+  bool		_announce;
+
+};
+
+TEST(read, stream_unbuffered)
+{
+  unbuffered buf ("{\"a\": [true, null]} 12,3");
+  std::istream s (&buf);
+  json::object obj;
+
+  s >> obj;
+  assert_true(json::is_true(obj["a"][0]));
+  s >> obj;
+  assert_equal(obj, json::object(12));
+  assert_equal(s.get(), ',');
+}
+
+TEST(read, stream_announced)
+{
+  unbuffered buf ("{\"a\":1} {\"b\":2} 3", true);
+  std::istream s (&buf);
+  json::object obj;
+
+  s >> obj;
+  assert_equal(obj["a"], json::object(1));
+  s >> obj;
+  assert_equal(obj["b"], json::object(2));
+  s >> obj;
+  assert_equal(obj, json::object(3));
+  assert_true(s.eof());
+  assert_false(s.bad());
+}
+
+TEST(read, stream_error)
+{
+  const char *inputs[] = { "", "  ", "[1, 2", "{\"a\" 1}", "\"Hello", "[1, 2,]", "tru", "-" };
+
+  for (auto input : inputs)
+    {
+      std::istringstream s (input);
+      bool thrown = false;
+      try
+	{
+	  json::object obj;
+	  s >> obj;
+	}
+      catch (const json::error &)
+	{
+	  thrown = true;
+	}
+      assert_true(thrown);
+      assert_true(s.fail());
+    }
+}
+
+TEST(read, structural_index_parallel)
+{
+  // Strings of all lengths with runs of backslashes and escaped quotes, so
+  // that chunk boundaries fall in every possible state.
+  std::string str ("[");
+  unsigned seed = 42;
+  while (str.size() < (5 << 20))
+    {
+      seed = seed * 1103515245 + 12345;
+      const unsigned n = (seed >> 8) % 200;
+      str += "{\"k\": \"";
+      for (unsigned i = 0; i != n; ++i)
+	{
+	  switch ((seed >> (i % 16)) % 7)
+	    {
+	    case 0:  str += "\\\\"; break;
+	    case 1:  str += "\\\""; break;
+	    case 2:  str += "[,]";  break;
+	    default: str += 'x';    break;
+	    }
+	}
+      str += "\", \"v\": [1, true, null, -2.5e3]}, ";
+    }
+  str += "{}]";
+
+  json::structural_index expected;
+  expected.build(str.c_str(), str.c_str() + str.size());
+
+  for (unsigned threads : { 2, 3, 4, 7 })
+    {
+      json::structural_index index;
+      index.build(str.c_str(), str.c_str() + str.size(), threads);
+      assert_equal(index.size(), expected.size());
+      assert_true(std::equal(index.begin(), index.end(), expected.begin()));
+    }
+
+  json::object obj;
+  json::read_indexed(str.c_str(), str.c_str() + str.size(), 4, obj);
+  assert_true(obj == json::read(str));
+
+  bool thrown = false;
+  try
+    {
+      const std::string unterminated (str + " \"");
+      json::structural_index index;
+      index.build(unterminated.c_str(), unterminated.c_str() + unterminated.size(), 4);
+    }
+  catch (const json::error &)
+    {
+      thrown = true;
+    }
+  assert_true(thrown);
 }
@@ -0,0 +1,203 @@
+/*
+ * Copyright 2012 Achille Roussel.
+ *
+ * This file is part of Libjson++.
+ *
+ * Libjson++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Libjson++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unit/main>
+#include <json/object.h>
+#include <json/parser.h>
+
+TEST(string_pool, acquire)
+{
+  json::string_pool pool (16, 4);
+  const json::string_pool::pooled_string *s1;
+  const json::string_pool::pooled_string *s2;
+
+  assert_true(pool.acquire(std::string("OK"), s1));
+  assert_true(pool.acquire(std::string("OK"), s2));
+  assert_equal(s1, s2);
+  assert_equal(s1->string, "OK");
+  assert_false(pool.acquire(std::string("Hello"), s2));
+  assert_equal(pool.size(), 1);
+  assert_equal(pool.length(), 2);
+  json::string_pool::release(s1);
+  json::string_pool::release(s1);
+
+  // Once the pool is full, the strings no one refers to make room for new
+  // ones.
+  const json::string_pool::pooled_string *s3;
+  const json::string_pool::pooled_string *s4;
+  assert_true(pool.acquire(std::string("abcd"), s1));
+  assert_true(pool.acquire(std::string("efgh"), s2));
+  assert_true(pool.acquire(std::string("ijkl"), s3));
+  assert_equal(pool.length(), 14);
+  assert_true(pool.acquire(std::string("mnop"), s4));
+  assert_equal(pool.size(), 4);
+  assert_equal(pool.length(), 16);
+  assert_false(pool.acquire(std::string("qrst"), s4));
+  json::string_pool::release(s1);
+  json::string_pool::release(s2);
+  json::string_pool::release(s3);
+  json::string_pool::release(s4);
+  pool.purge();
+  assert_true(pool.empty());
+}
+
+TEST(string_pool, assign)
+{
+  json::string_pool pool;
+  json::object obj1;
+  json::object obj2;
+  {
+    json::string_pool::scope use (pool);
+    obj1 = "FR";
+    obj2 = std::string("FR");
+  }
+
+  assert_true(obj1.is_interned());
+  assert_false(obj1.is_borrowed());
+  assert_equal(obj1.get_char_sequence().data(), obj2.get_char_sequence().data());
+  assert_equal(obj1, obj2);
+  assert_equal(obj1, "FR");
+
+  json::object copy (obj1);
+  assert_true(copy.is_interned());
+  assert_equal(copy.get_char_sequence().data(), obj1.get_char_sequence().data());
+
+  // Modifying a pooled string makes a copy of it.
+  copy.get_string() += "A";
+  assert_false(copy.is_interned());
+  assert_equal(copy, "FRA");
+  assert_equal(obj1, "FR");
+  assert_true(obj1 != copy);
+
+  obj2 = "DE";
+  assert_false(obj2.is_interned());
+  assert_true(obj2.intern(pool));
+  assert_true(obj2.is_interned());
+  assert_equal(pool.size(), 2);
+  assert_true(obj1 != obj2);
+}
+
+TEST(string_pool, const_access)
+{
+  json::string_pool pool;
+  json::string_pool::scope use (pool);
+  json::object obj (json::read("{\"name\": \"value\", \"other\": \"value\"}"));
+  obj["q"] = "x";
+
+  const json::object &c = obj;
+  assert_true(c["name"].is_interned());
+  assert_equal(c["name"].get_string(), "value");
+  assert_equal(&c["name"].get_string(), &c["other"].get_string());
+  assert_equal(c["q"].get_string(), "x");
+  assert_equal(c["q"].get_string().size(), 1);
+  assert_true(c["q"].is_interned());
+}
+
+TEST(string_pool, read)
+{
+  std::string str ("[");
+  for (int i = 0; i != 100; ++i)
+    {
+      str += "{\"status\": \"OK\", \"host\": \"h" + std::to_string(i % 3) + "\", \"esc\": \"a\\tb\"}, ";
+    }
+  str += "\"" + std::string(100, 'x') + "\"]";
+
+  json::string_pool pool;
+  json::string_pool::scope use (pool);
+  const json::object obj (json::read(str));
+
+  assert_equal(pool.size(), 5);
+  assert_equal(obj[0]["status"].get_char_sequence().data(), obj[99]["status"].get_char_sequence().data());
+  assert_equal(obj[4]["host"], "h1");
+  assert_equal(obj[4]["esc"], "a\tb");
+  assert_true(obj[4]["esc"].is_interned());
+  assert_false(obj[100].is_interned());
+
+  std::istringstream s (str);
+  json::object obj2;
+  s >> obj2;
+  assert_equal(obj2[7]["host"].get_char_sequence().data(), obj[1]["host"].get_char_sequence().data());
+
+  json::parser parser;
+  json::object obj3;
+  parser.parse(str, obj3);
+  assert_true(obj3[50]["status"].is_interned());
+
+  assert_true(obj == obj2);
+  assert_true(obj == obj3);
+  assert_true(obj == json::read(str));
+
+  std::ostringstream out;
+  out << obj[0]["esc"];
+  assert_equal(out.str(), "\"a\\tb\"");
+}
+
+TEST(string_pool, lifetime)
+{
+  json::object obj;
+  json::object other;
+  {
+    json::string_pool pool;
+    json::string_pool::scope use (pool);
+    obj = json::read("{\"a\": \"value\", \"b\": \"value\"}");
+    pool.clear();
+    other = "value";
+  }
+
+  // The strings outlive the pool, a string added after clearing the pool
+  // is a new one but still compares equal.
+  assert_equal(obj["a"].get_char_sequence().data(), obj["b"].get_char_sequence().data());
+  assert_true(other.is_interned());
+  assert_not_equal(other.get_char_sequence().data(), obj["a"].get_char_sequence().data());
+  assert_equal(obj["a"], other);
+  obj["a"] = "other";
+  assert_false(obj["a"].is_interned());
+  assert_equal(obj["b"], "value");
+}
+
+TEST(string_pool, synchronized)
+{
+  json::string_pool pool (json::string_pool::default_capacity,
+			  json::string_pool::default_max_length,
+			  true);
+  std::vector<json::object> objs (4);
+  std::vector<std::thread> threads;
+
+  for (auto &obj : objs)
+    {
+      threads.emplace_back([&]() {
+	  json::string_pool::scope use (pool);
+	  for (int i = 0; i != 1000; ++i)
+	    {
+	      obj[std::to_string(i)] = std::to_string(i % 10);
+	    }
+	});
+    }
+  for (auto &t : threads)
+    {
+      t.join();
+    }
+
+  assert_equal(pool.size(), 10);
+  assert_equal(objs[0]["42"].get_char_sequence().data(), objs[3]["2"].get_char_sequence().data());
+}
@@ -0,0 +1,143 @@
+/*
+ * Copyright 2012 Achille Roussel.
+ *
+ * This file is part of Libjson++.
+ *
+ * Libjson++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Libjson++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Libjson++.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string>
+#include <unit/main>
+#include <json/utf8.h>
+#include <json/error.h>
+
+// Decodes the code points of 'str' to check it, independently of how the
+// library does it.
+static bool decodes_as_utf8(const std::string &str)
+{
+  static const unsigned char masks[] = { 0x7F, 0x1F, 0x0F, 0x07 };
+  static const long minimums[] = { 0, 0x80, 0x800, 0x10000 };
+
+  for (std::size_t i = 0; i != str.size(); )
+    {
+      const unsigned char c = str[i++];
+      const int n = (c < 0x80) ? 0 : (c < 0xC0) ? -1 : (c < 0xE0) ? 1 : (c < 0xF0) ? 2 : (c < 0xF8) ? 3 : -1;
+      if ((n < 0) || ((str.size() - i) < std::size_t(n)))
+	{
+	  return false;
+	}
+      long code_point = c & masks[n];
+      for (int j = 0; j != n; ++j)
+	{
+	  const unsigned char d = str[i++];
+	  if ((d & 0xC0) != 0x80)
+	    {
+	      return false;
+	    }
+	  code_point = (code_point << 6) | (d & 0x3F);
+	}
+      if ((code_point < minimums[n]) || (code_point > 0x10FFFF) ||
+	  ((code_point >= 0xD800) && (code_point <= 0xDFFF)))
+	{
+	  return false;
+	}
+    }
+  return true;
+}
+
+static bool is_valid(const std::string &str)
+{
+  return json::is_valid_utf8(str.data(), str.data() + str.size());
+}
+
+TEST(utf8, valid)
+{
+  const char *inputs[] =
+    {
+      "", "Hello World", "\xc3\xa9", "\xe2\x82\xac", "\xf0\x9f\x98\x80",
+      "\xc2\x80", "\xdf\xbf", "\xe0\xa0\x80", "\xed\x9f\xbf", "\xee\x80\x80",
+      "\xef\xbf\xbf", "\xf0\x90\x80\x80", "\xf4\x8f\xbf\xbf",
+    };
+
+  for (auto input : inputs)
+    {
+      for (std::size_t offset = 0; offset != 130; ++offset)
+	{
+	  assert_true(is_valid(std::string(offset, 'x') + input));
+	  assert_true(is_valid(std::string(offset, 'x') + input + std::string(70, 'y')));
+	}
+    }
+}
+
+TEST(utf8, invalid)
+{
+  const char *inputs[] =
+    {
+      "\x80", "\xbf", "\xc0\x80", "\xc1\xbf", "\xc3", "\xc3x", "\xe0\x80\x80",
+      "\xe0\x9f\xbf", "\xed\xa0\x80", "\xed\xbf\xbf", "\xe2\x82", "\xe2\x82x",
+      "\xf0\x80\x80\x80", "\xf0\x8f\xbf\xbf", "\xf4\x90\x80\x80", "\xf5\x80\x80\x80",
+      "\xf0\x9f\x98", "\xf8\x88\x80\x80\x80", "\xff", "\xc3\xa9\xa9",
+    };
+
+  for (auto input : inputs)
+    {
+      for (std::size_t offset = 0; offset != 130; ++offset)
+	{
+	  assert_false(is_valid(std::string(offset, 'x') + input));
+	  assert_false(is_valid(std::string(offset, 'x') + input + std::string(70, 'y')));
+	}
+    }
+}
+
+TEST(utf8, sequences)
+{
+  // Every lead byte followed by every second and third byte, across the
+  // boundary between two blocks.
+  for (int c = 0x80; c != 0x100; ++c)
+    {
+      for (int d = 0; d != 0x100; ++d)
+	{
+	  std::string str (63, 'x');
+	  str += char(c);
+	  str += char(d);
+	  str += std::string(63, 'x');
+	  assert_equal(is_valid(str), decodes_as_utf8(str));
+
+	  if ((c >= 0xE0) && ((d & 0xC0) == 0x80))
+	    {
+	      for (int e = 0; e != 0x100; ++e)
+		{
+		  str[65] = char(e);
+		  assert_equal(is_valid(str), decodes_as_utf8(str));
+		}
+	    }
+	}
+    }
+}
+
+TEST(utf8, validate)
+{
+  json::validate_utf8(std::string("{\"name\": \"\xc3\xa9t\xc3\xa9\"}"));
+
+  bool thrown = false;
+  try
+    {
+      json::validate_utf8(std::string("{\"name\": \"\xc3\"}"));
+    }
+  catch (const json::error &)
+    {
+      thrown = true;
+    }
+  assert_true(thrown);
+}
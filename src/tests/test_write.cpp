@@ -36,14 +36,14 @@ TEST(write, null)
 
 TEST(write, boolean)
 {
-  assert_equal(to_string("true"), "true");
-  assert_equal(to_string("false"), "false");
+  assert_equal(to_string(json::object(true)), "true");
+  assert_equal(to_string(json::object(false)), "false");
 }
 
 TEST(write, number)
 {
-  assert_equal(to_string("42"), "42");
-  assert_equal(to_string("-42"), "-42");
+  assert_equal(to_string(json::object(42)), "42");
+  assert_equal(to_string(json::object(-42)), "-42");
 }
 
 TEST(write, string)
@@ -51,6 +51,16 @@ TEST(write, string)
   assert_equal(to_string("Hello World"), "\"Hello World\"");
 }
 
+TEST(write, numeric_string)
+{
+  const json::object obj (json::read("{\"zip\": \"01234\", \"b\": \"true\", \"1\": 2}"));
+
+  assert_equal(to_string("42"), "\"42\"");
+  assert_equal(to_string("true"), "\"true\"");
+  assert_equal(json::read(to_string(obj)), obj);
+  assert_true(json::is_string(json::read(to_string(obj))["zip"]));
+}
+
 TEST(write, list)
 {
   json::object obj;